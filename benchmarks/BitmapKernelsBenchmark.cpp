@@ -0,0 +1,64 @@
+#include <ray/assets/BitmapKernels.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/Print.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <cstdlib>
+#include <functional>
+
+using namespace ray;
+using namespace ray::assets;
+using namespace ray::platform;
+
+static constexpr auto SIZE = 2048;
+static constexpr auto ITERATIONS = 4;
+
+namespace
+{
+    Bitmap synthetic(int depth)
+    {
+        auto pixels = (uint8_t *)malloc(SIZE * SIZE * depth);
+        for (int i = 0; i < SIZE * SIZE * depth; ++i)
+            pixels[i] = (uint8_t)(i * 37 + i / 4099);
+        return Bitmap(SIZE, SIZE, depth, pixels);
+    }
+
+    // Megapixels of the source per second, alone and on the job system.
+    void run(const char *name, JobSystem &jobs, const std::function<void(JobSystem *)> &kernel)
+    {
+        auto megapixels = (double)SIZE * SIZE * ITERATIONS / 1e6;
+        auto stopwatch = Stopwatch();
+        for (auto i = 0; i < ITERATIONS; ++i)
+            kernel(nullptr);
+        auto serialTime = stopwatch.lap();
+        for (auto i = 0; i < ITERATIONS; ++i)
+            kernel(&jobs);
+        auto parallelTime = stopwatch.lap();
+        fprintln("%-28s : %8.1f MPix/s, %8.1f MPix/s on %d threads", name,
+            megapixels / serialTime.count(), megapixels / parallelTime.count(), jobs.workerCount() + 1);
+    }
+}
+
+int main()
+{
+    JobSystem jobs;
+    auto rgb = synthetic(3), rgba = synthetic(4);
+
+    run("convert RGB to RGBA", jobs, [&](JobSystem *jobs) { kernels::convert(rgb, 4, jobs); });
+    run("premultiply RGBA", jobs, [&](JobSystem *jobs) { kernels::premultiply(rgba, jobs); });
+    run("sRGB to linear RGBA", jobs, [&](JobSystem *jobs) { kernels::srgbToLinear(rgba, jobs); });
+    run("halve RGBA", jobs, [&](JobSystem *jobs) { kernels::halve(rgba, jobs); });
+    run("box to 512x512 sRGB", jobs, [&](JobSystem *jobs) {
+        kernels::ResampleOptions options;
+        options.filter = kernels::Filter::Box;
+        options.srgb = true;
+        options.jobs = jobs;
+        kernels::resample(rgba, 512, 512, options);
+    });
+    run("lanczos3 to 512x512 sRGB", jobs, [&](JobSystem *jobs) {
+        kernels::ResampleOptions options;
+        options.srgb = true;
+        options.jobs = jobs;
+        kernels::resample(rgba, 512, 512, options);
+    });
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+#include <ray/assets/BlockCompression.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/Print.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace ray;
+using namespace ray::assets;
+using namespace ray::platform;
+
+static constexpr auto SIZE = 1024;
+static constexpr auto ITERATIONS = 4;
+
+namespace
+{
+    Bitmap synthetic(int depth)
+    {
+        auto pixels = (uint8_t *)malloc(SIZE * SIZE * depth);
+        uint32_t noise = 1;
+        for (int y = 0; y < SIZE; ++y)
+        {
+            for (int x = 0; x < SIZE; ++x)
+            {
+                for (int channel = 0; channel < depth; ++channel)
+                {
+                    noise = noise * 1664525u + 1013904223u;
+                    auto value = 128 + 100 * std::sin(0.02 * x * (channel + 1) + 0.013 * y) + (int)(noise >> 29) - 4;
+                    pixels[(y * SIZE + x) * depth + channel] = (uint8_t)std::min(255.0, std::max(0.0, value));
+                }
+            }
+        }
+        return Bitmap(SIZE, SIZE, depth, pixels);
+    }
+
+    Bitmap withDepth(const Bitmap &bitmap, int depth)
+    {
+        auto pixels = (uint8_t *)malloc(bitmap.width() * bitmap.height() * depth);
+        for (int pixel = 0; pixel < bitmap.width() * bitmap.height(); ++pixel)
+            for (int channel = 0; channel < depth; ++channel)
+                pixels[pixel * depth + channel] = bitmap.pixels()[pixel * bitmap.depth() + std::min(channel, bitmap.depth() - 1)];
+        return Bitmap(bitmap.width(), bitmap.height(), depth, pixels);
+    }
+
+    void run(const char *name, const Bitmap &bitmap, TextureFormat format, JobSystem &jobs)
+    {
+        auto megapixels = (double)bitmap.width() * bitmap.height() * ITERATIONS / 1e6;
+        auto stopwatch = Stopwatch();
+        std::vector<uint8_t> blocks;
+        for (auto i = 0; i < ITERATIONS; ++i)
+            blocks = bc::encode(bitmap, format);
+        auto serialTime = stopwatch.lap();
+        for (auto i = 0; i < ITERATIONS; ++i)
+            blocks = bc::encode(bitmap, format, &jobs);
+        auto parallelTime = stopwatch.lap();
+
+        auto quality = bc::psnr(bitmap, bc::decode(blocks.data(), format, bitmap.width(), bitmap.height()));
+        fprintln("%s : %7.1f MPix/s, %7.1f MPix/s on %d threads, %5.2f dB", name,
+            megapixels / serialTime.count(), megapixels / parallelTime.count(), jobs.workerCount() + 1, quality);
+    }
+}
+
+// usage: BlockCompressionBenchmark [image], a synthetic 1024x1024 image by default.
+int main(int argc, char **argv)
+{
+    auto source = argc > 1 ? Bitmap(argv[1]) : synthetic(4);
+    JobSystem jobs;
+    run("BC1", withDepth(source, 3), TextureFormat::BC1, jobs);
+    run("BC3", withDepth(source, 4), TextureFormat::BC3, jobs);
+    run("BC4", withDepth(source, 1), TextureFormat::BC4, jobs);
+    run("BC5", withDepth(source, 2), TextureFormat::BC5, jobs);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+#include <ray/platform/Format.hpp>
+#include <ray/platform/Print.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <boost/format.hpp>
+#include <cstdlib>
+#include <string>
+
+using namespace ray::platform;
+
+static constexpr auto ITERATIONS = 1000000;
+
+int main()
+{
+    // NOTE(cme): what a sample does every frame to show its frame time.
+    auto stopwatch = Stopwatch();
+    size_t boostSum = 0;
+    for (auto i = 0; i < ITERATIONS; ++i)
+    {
+        auto text = boost::str(boost::format("average frame time = %6.3fmsec (%d draws)") % (16.0 + i * 1e-6) % i);
+        boostSum += text.size();
+    }
+    auto boostTime = stopwatch.lap();
+
+    size_t fmtSum = 0;
+    for (auto i = 0; i < ITERATIONS; ++i)
+    {
+        auto text = fmt("average frame time = %6.3fmsec (%d draws)", 16.0 + i * 1e-6, i);
+        fmtSum += text.size();
+    }
+    auto fmtTime = stopwatch.lap();
+
+    size_t stringSum = 0;
+    auto text = std::string();
+    for (auto i = 0; i < ITERATIONS; ++i)
+    {
+        formatTo(text, "average frame time = %6.3fmsec (%d draws)", 16.0 + i * 1e-6, i);
+        stringSum += text.size();
+    }
+    auto stringTime = stopwatch.lap();
+
+    size_t bufferSum = 0;
+    for (auto i = 0; i < ITERATIONS; ++i)
+    {
+        FormatBuffer<64> buffer("average frame time = %6.3fmsec (%d draws)", 16.0 + i * 1e-6, i);
+        bufferSum += buffer.size();
+    }
+    auto bufferTime = stopwatch.lap();
+
+    fprintln("boost::format                  : %6.1f ns/format", 1e9*boostTime.count()/ITERATIONS);
+    fprintln("fmt, new std::string           : %6.1f ns/format", 1e9*fmtTime.count()/ITERATIONS);
+    fprintln("formatTo, reused std::string   : %6.1f ns/format", 1e9*stringTime.count()/ITERATIONS);
+    fprintln("FormatBuffer<64> on the stack  : %6.1f ns/format", 1e9*bufferTime.count()/ITERATIONS);
+    fprintln("checksums %d %d %d %d", boostSum, fmtSum, stringSum, bufferSum);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+#include <ray/gl/Name.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <ray/platform/Print.hpp>
+#include <unordered_map>
+#include <cstdlib>
+
+using namespace ray::platform;
+using namespace ray::gl;
+
+static const char *NAMES[] = {
+    "modelMatrix", "viewMatrix", "projectionMatrix", "normalMatrix",
+    "modelColor", "lightColor", "lightPosition", "cameraPosition",
+    "reflectivity", "shineDamper", "diffuseTexture", "specularTexture",
+};
+
+static constexpr auto LOOKUPS = 10000000;
+
+int main()
+{
+    auto map = std::unordered_map<std::string, int>();
+    auto table = NameTable<int>();
+    for (auto i = 0; i < 12; ++i)
+    {
+        map[NAMES[i]] = i;
+        table.add(NAMES[i], i);
+    }
+
+    // NOTE(cme): mimics what a renderer does per object, the names are string
+    //            literals passed to a 'const std::string &' parameter.
+    auto stopwatch = Stopwatch();
+    auto mapSum = 0;
+    for (auto i = 0; i < LOOKUPS; i += 4)
+    {
+        mapSum += map.find("modelMatrix")->second;
+        mapSum += map.find("modelColor")->second;
+        mapSum += map.find("reflectivity")->second;
+        mapSum += map.find("diffuseTexture")->second;
+    }
+    auto mapTime = stopwatch.lap();
+
+    auto tableSum = 0;
+    for (auto i = 0; i < LOOKUPS; i += 4)
+    {
+        tableSum += *table.find("modelMatrix"_u);
+        tableSum += *table.find("modelColor"_u);
+        tableSum += *table.find("reflectivity"_u);
+        tableSum += *table.find("diffuseTexture"_u);
+    }
+    auto tableTime = stopwatch.lap();
+
+    auto runtimeSum = 0;
+    for (auto i = 0; i < LOOKUPS; i += 4)
+    {
+        runtimeSum += *table.find(UniformName("modelMatrix"));
+        runtimeSum += *table.find(UniformName("modelColor"));
+        runtimeSum += *table.find(UniformName("reflectivity"));
+        runtimeSum += *table.find(UniformName("diffuseTexture"));
+    }
+    auto runtimeTime = stopwatch.lap();
+
+    fprintln("unordered_map<std::string>     : %6.2f ns/lookup", 1e9*mapTime.count()/LOOKUPS);
+    fprintln("NameTable, \"..\"_u literal      : %6.2f ns/lookup", 1e9*tableTime.count()/LOOKUPS);
+    fprintln("NameTable, hashed at runtime   : %6.2f ns/lookup", 1e9*runtimeTime.count()/LOOKUPS);
+    fprintln("checksums %d %d %d", mapSum, tableSum, runtimeSum);
+
+    return EXIT_SUCCESS;
+}
@@ -1,19 +1,29 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <ray/assets/Color.hpp>
 
 namespace ray { namespace assets {
 
+    class PixelPool;
+
     class Bitmap 
     {
         using u8 = unsigned char;
     public:
-        Bitmap() : mPixels(nullptr), mWidth(0), mHeight(0), mDepth(0) {}
-        Bitmap(int width, int height, int depth, u8 *pixels) : mPixels(pixels), mWidth(width), mHeight(height), mDepth(depth) {}
+        // Rows are either packed, or padded to 64 bytes for SIMD loads, and to a whole
+        // number of pixels so that GL can still unpack them.
+        enum class Stride { Tight, Aligned };
+
+        Bitmap() : mPixels(nullptr), mWidth(0), mHeight(0), mDepth(0), mStride(0) {}
+        Bitmap(int width, int height, int depth, u8 *pixels) : mPixels(pixels), mWidth(width), mHeight(height), mDepth(depth), mStride(width*depth) {}
         Bitmap(int width, int height, int depth) : mPixels(nullptr) { resize(width, height, depth); }
         Bitmap(int width, int height, int depth, const Color &color);
+        // The pixels are left uninitialized. A pool takes the memory back when the bitmap goes.
+        Bitmap(int width, int height, int depth, Stride stride, PixelPool *pool=nullptr);
         Bitmap(const std::string &filename);
+        Bitmap(const u8 *encoded, size_t size);
         Bitmap(const Bitmap &other) = delete;
         Bitmap(Bitmap &&other);
         ~Bitmap();
@@ -24,18 +34,31 @@ namespace ray { namespace assets {
         int width()        const { return mWidth; }
         int height()       const { return mHeight; }
         int depth()        const { return mDepth; }
-        int stride()       const { return mWidth * mDepth; }
-        int size()         const { return mWidth * mHeight * mDepth; }
+        int stride()       const { return mStride; }
+        int size()         const { return mStride * mHeight; }
+        bool isTight()     const { return mStride == mWidth * mDepth; }
         const u8 *pixels() const { return mPixels; }
+        u8 *pixels()             { return mPixels; }
+        u8 *row(int y)           { return mPixels + (size_t)y * mStride; }
+        const u8 *row(int y) const { return mPixels + (size_t)y * mStride; }
 
+        // Keeps the kind of stride and the pool, zeroes the pixels.
         void resize(int width, int height, int depth);
+        void fill(const Color &color);
         void toPNG(const std::string &filename) const;
         void toBMP(const std::string &filename) const;
         void toJPG(const std::string &filename, int quality=80) const;
-        
+
+        static int alignedStride(int width, int depth);
+
     private:
+        void allocate(int width, int height, int depth);
+        void release();
+
         unsigned char *mPixels;
-        int mWidth, mHeight, mDepth;
+        int mWidth, mHeight, mDepth, mStride;
+        bool mIsAligned = false;
+        PixelPool *mPool = nullptr;
     };
 
 }}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <ray/assets/BitmapView.hpp>
+#include <cstdint>
+
+namespace ray { namespace platform {
+    class JobSystem;
+}}
+
+namespace ray { namespace assets {
+
+    // Whole bitmap operations, the building blocks of mip chains and thumbnails.
+    // Those given a job system split their rows across it.
+    //
+    // The channels mean what the texture swizzles make of them: 1 is an alpha
+    // mask, 2 is luminance and alpha, 3 is RGB and 4 is RGBA.
+    namespace kernels
+    {
+        // E.g. RGB to RGBA with an opaque alpha, RGBA to luminance and alpha.
+        Bitmap convert(const BitmapView &bitmap, int depth, platform::JobSystem *jobs=nullptr);
+
+        // Scales the colors by alpha, for bitmaps of 2 and 4 channels.
+        void premultiply(Bitmap &bitmap, platform::JobSystem *jobs=nullptr);
+
+        void flipVertically(Bitmap &bitmap);
+
+        // Copies the pixels as they are to (x, y) in the target, of the same depth.
+        void blit(const BitmapView &source, Bitmap &target, int x, int y);
+
+        // NOTE(cme): both through tables, linear values are quantized to 12 bits,
+        //            which is enough for every 8 bits sRGB value to round trip.
+        float toLinear(uint8_t srgb);
+        uint8_t toSrgb(float linear);
+
+        // In place on the color channels, alpha is linear already. 8 bits linear
+        // colors lose the darks, prefer resample(..., srgb=true) when filtering.
+        void srgbToLinear(Bitmap &bitmap, platform::JobSystem *jobs=nullptr);
+        void linearToSrgb(Bitmap &bitmap, platform::JobSystem *jobs=nullptr);
+
+        // Halves each side, rounding down but not below 1, averaging 2x2 blocks.
+        Bitmap halve(const BitmapView &bitmap, platform::JobSystem *jobs=nullptr);
+
+        enum class Filter
+        {
+            Box,        // averages the source pixels each target pixel covers
+            Lanczos3,   // sharper, rings a little on hard edges
+        };
+
+        struct ResampleOptions
+        {
+            Filter filter = Filter::Lanczos3;
+            bool srgb = false;                      // filters the colors in linear space
+            platform::JobSystem *jobs = nullptr;
+        };
+
+        // To any size, one pass per axis. Premultiply first, or transparent
+        // pixels bleed their color into their neighbours.
+        Bitmap resample(const BitmapView &bitmap, int width, int height, const ResampleOptions &options=ResampleOptions());
+    }
+
+}}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <ray/assets/Bitmap.hpp>
+#include <ray/platform/Panic.hpp>
+#include <cstddef>
+
+namespace ray { namespace assets {
+
+    // Pixels someone else owns: a bitmap, a region of one, a cooked atlas, with
+    // rows 'stride' bytes apart. A view of a temporary bitmap is fine as long as
+    // it doesn't outlive the expression, e.g. atlas.add(font.rasterizeGlyph(index)).
+    class BitmapView
+    {
+        using u8 = unsigned char;
+    public:
+        BitmapView() = default;
+        BitmapView(const u8 *pixels, int width, int height, int depth, int stride=0)
+            : mPixels(pixels), mWidth(width), mHeight(height), mDepth(depth), mStride(stride ? stride : width * depth) {}
+        BitmapView(const Bitmap &bitmap) : BitmapView(bitmap.pixels(), bitmap.width(), bitmap.height(), bitmap.depth(), bitmap.stride()) {}
+
+        int width()        const { return mWidth; }
+        int height()       const { return mHeight; }
+        int depth()        const { return mDepth; }
+        int stride()       const { return mStride; }
+        bool isEmpty()     const { return mWidth == 0 || mHeight == 0; }
+        bool isTight()     const { return mStride == mWidth * mDepth; }
+        const u8 *pixels() const { return mPixels; }
+        const u8 *row(int y) const { return mPixels + (size_t)y * mStride; }
+
+        BitmapView region(int x, int y, int width, int height) const
+        {
+            panicif(x < 0 || y < 0 || width < 0 || height < 0 || x + width > mWidth || y + height > mHeight,
+                "region (%d,%d) %dx%d out of a %dx%d bitmap", x, y, width, height, mWidth, mHeight);
+            return BitmapView(row(y) + x * mDepth, width, height, mDepth, mStride);
+        }
+
+    private:
+        const u8 *mPixels = nullptr;
+        int mWidth = 0, mHeight = 0, mDepth = 0, mStride = 0;
+    };
+
+}}
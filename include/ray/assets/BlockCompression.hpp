@@ -0,0 +1,53 @@
+#pragma once
+
+#include <ray/assets/BitmapView.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ray { namespace platform {
+    class JobSystem;
+}}
+
+namespace ray { namespace assets {
+
+    // How the pixels of a texture are stored. The BCn formats store 4x4 blocks
+    // of pixels, sampled as is by the GPU.
+    enum class TextureFormat : uint32_t
+    {
+        Uncompressed = 0,
+        BC1 = 1,    // RGB, 8 bytes per block
+        BC3 = 2,    // RGBA, 16 bytes per block: the alpha as BC4, then the colors as BC1
+        BC4 = 3,    // R, 8 bytes per block
+        BC5 = 4,    // RG, 16 bytes per block: two BC4 blocks
+    };
+
+    namespace bc
+    {
+        size_t blockSize(TextureFormat format);
+        size_t compressedSize(TextureFormat format, int width, int height);
+        int channelCount(TextureFormat format);
+
+        // BC4 for R, BC5 for RG, BC1 for RGB and opaque RGBA, BC3 for the rest.
+        TextureFormat formatFor(const BitmapView &bitmap);
+
+        // Blocks past the edges repeat the last row and column. The rows of
+        // blocks are encoded in parallel when given a job system.
+        std::vector<uint8_t> encode(const BitmapView &bitmap, TextureFormat format, platform::JobSystem *jobs=nullptr);
+
+        // With channelCount(format) channels.
+        Bitmap decode(const uint8_t *blocks, TextureFormat format, int width, int height);
+
+        // Peak signal to noise ratio over the channels both bitmaps have, in dB,
+        // infinite when they are the same.
+        double psnr(const BitmapView &reference, const BitmapView &other);
+
+        // One block: 16 pixels of 4 bytes for BC1, 16 bytes for BC4, rows first.
+        // NOTE(cme): BC1 blocks always use 4 colors, so that BC3 can reuse them.
+        void encodeBC1(const uint8_t *rgba, uint8_t *block);
+        void encodeBC4(const uint8_t *values, uint8_t *block);
+        void decodeBC1(const uint8_t *block, uint8_t *rgba);
+        void decodeBC4(const uint8_t *block, uint8_t *values);
+    }
+
+}}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <ray/assets/BitmapView.hpp>
+#include <ray/assets/BlockCompression.hpp>
+#include <ray/platform/MappedFile.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ray { namespace assets {
+
+    class Font;
+    class Wavefront;
+
+    // Cooked assets are built offline by ray-cook, in a layout the runtime can
+    // hand to the GPU as is. They sit next to their source with an extension of
+    // their own, e.g. res/images/marble.jpg.rtex, on the disk or in a mounted pack,
+    // or under the cooked root, e.g. cooked/images/marble.jpg.rtex.
+    namespace cooked
+    {
+        constexpr uint32_t VERSION = 1;
+        constexpr size_t DATA_ALIGNMENT = 16;
+        constexpr size_t FLOATS_PER_VERTEX = 8;     // position, texcoord, normal
+
+        using TextureFormat = assets::TextureFormat;
+
+        struct TextureHeader
+        {
+            char magic[8];
+            uint32_t version, width, height, depth;
+            TextureFormat format;
+            uint32_t levelCount;
+        };
+
+        struct TextureLevel
+        {
+            uint32_t width, height;
+            uint64_t offset, size;
+        };
+
+        struct MeshHeader
+        {
+            char magic[8];
+            uint32_t version, vertexCount, indexCount, materialCount;
+            uint64_t namesSize;
+        };
+
+        struct FontHeader
+        {
+            char magic[8];
+            uint32_t version, lineHeight, glyphCount, atlasWidth, atlasHeight, reserved;
+        };
+
+        struct FontGlyph
+        {
+            int32_t glyphIndex;
+            uint16_t x, y, width, height;
+        };
+
+        static_assert(sizeof(TextureHeader) == 32, "cooked texture headers have a fixed size");
+        static_assert(sizeof(TextureLevel) == 24, "cooked texture levels have a fixed size");
+        static_assert(sizeof(MeshHeader) == 32, "cooked mesh headers have a fixed size");
+        static_assert(sizeof(FontHeader) == 32, "cooked font headers have a fixed size");
+        static_assert(sizeof(FontGlyph) == 12, "cooked glyphs have a fixed size");
+
+        std::string texturePath(const std::string &source);
+        std::string meshPath(const std::string &source);
+        std::string fontPath(const std::string &source, int lineHeight);
+
+        // Artifacts cooked from the files under 'sourceDirectory' are also looked up
+        // under 'cookedDirectory'. Defaults to res/ and the output of 'make cook'.
+        // NOTE(cme): set it before loading anything, it isn't synchronized.
+        void setRoot(const std::string &sourceDirectory, const std::string &cookedDirectory);
+
+        // Where a mounted pack or the disk has the cooked artifact, empty if nowhere.
+        std::string find(const std::string &cookedPath);
+        bool exists(const std::string &cookedPath);
+
+        struct TextureOptions
+        {
+            bool mipmaps = true;
+            bool compress = false;                  // to bc::formatFor(bitmap), every level
+            platform::JobSystem *jobs = nullptr;    // to build the mips and compress with
+        };
+
+        // Each of them returns the whole artifact, ready to be written to a file.
+        std::vector<uint8_t> cookTexture(const BitmapView &bitmap, const TextureOptions &options=TextureOptions());
+        std::vector<uint8_t> cookMesh(const Wavefront &object);
+        std::vector<uint8_t> cookFont(const Font &font, int firstCodepoint=32, int lastCodepoint=126);
+
+        // Reorders triangles for the post-transform vertex cache (Forsyth's linear
+        // speed algorithm), then vertices in the order the triangles first use them.
+        void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+        void optimizeVertexFetch(std::vector<float> &vertices, std::vector<uint32_t> &indices);
+    }
+
+    // A texture with its mip chain.
+    class CookedTexture
+    {
+    public:
+        struct Level
+        {
+            int width, height;
+            const uint8_t *pixels;
+            size_t size;
+        };
+
+        CookedTexture(const std::string &filename);
+        CookedTexture(platform::fs::FileData data, const std::string &name="memory");
+
+        int width() const { return (int)mHeader->width; }
+        int height() const { return (int)mHeader->height; }
+        int depth() const { return (int)mHeader->depth; }
+        cooked::TextureFormat format() const { return mHeader->format; }
+        int levelCount() const { return (int)mHeader->levelCount; }
+        Level level(int index) const;
+
+    private:
+        platform::fs::FileData mData;
+        const cooked::TextureHeader *mHeader;
+        const cooked::TextureLevel *mLevels;
+    };
+
+    // An indexed triangle list, FLOATS_PER_VERTEX floats per vertex.
+    class CookedMesh
+    {
+    public:
+        CookedMesh(const std::string &filename, const std::string &baseDirectory);
+        CookedMesh(platform::fs::FileData data, const std::string &baseDirectory, const std::string &name="memory");
+
+        size_t vertexCount() const { return mHeader->vertexCount; }
+        size_t indexCount() const { return mHeader->indexCount; }
+        const float *vertices() const { return mVertices; }
+        const uint32_t *indices() const { return mIndices; }
+
+        size_t materialCount() const { return mDiffuseTextures.size(); }
+        std::string getDiffuseTextureFilename(int material) const;
+
+    private:
+        platform::fs::FileData mData;
+        const cooked::MeshHeader *mHeader;
+        const float *mVertices;
+        const uint32_t *mIndices;
+        std::vector<std::string> mDiffuseTextures;
+        std::string mBaseDirectory;
+    };
+
+    // The glyphs of a font rasterized at one line height, packed in one atlas.
+    class CookedFont
+    {
+    public:
+        CookedFont(const std::string &filename);
+        CookedFont(platform::fs::FileData data, const std::string &name="memory");
+
+        int lineHeight() const { return (int)mHeader->lineHeight; }
+        size_t glyphCount() const { return mHeader->glyphCount; }
+        int atlasWidth() const { return (int)mHeader->atlasWidth; }
+        int atlasHeight() const { return (int)mHeader->atlasHeight; }
+        const uint8_t *atlas() const { return mAtlas; }
+
+        // Glyphs are sorted by index, nullptr if the glyph wasn't baked.
+        const cooked::FontGlyph *find(int glyphIndex) const;
+
+        // The glyph in place in the atlas, or a copy of it in a pooled bitmap.
+        BitmapView view(const cooked::FontGlyph &glyph) const;
+        Bitmap extract(const cooked::FontGlyph &glyph) const;
+
+    private:
+        platform::fs::FileData mData;
+        const cooked::FontHeader *mHeader;
+        const cooked::FontGlyph *mGlyphs;
+        const uint8_t *mAtlas;
+    };
+
+}}
@@ -1,11 +1,15 @@
 #pragma once
 
-#include <ray/assets/Bitmap.hpp>
+#include <ray/assets/BitmapView.hpp>
 #include <ray/math/LinearAlgebra.hpp>
+#include <ray/platform/MappedFile.hpp>
+#include <memory>
 #include <vector>
 
 namespace ray { namespace assets {
 
+    class CookedFont;
+
     class Font
     {
     public:
@@ -24,8 +28,13 @@ namespace ray { namespace assets {
             friend class Font;
         };
 
+        // Glyphs baked by ray-cook at this line height are copied out of the cooked
+        // atlas instead of being rasterized.
         Font(const std::string &filename, int lineHeight);
 
+        // E.g. from platform::fs::readAsync, the font keeps the bytes alive.
+        Font(platform::fs::FileData data, int lineHeight);
+
         int lineHeight() const { return mLineHeight; }
         int ascent() const  { return mAscent; }
         int descent() const { return mDescent; }
@@ -41,6 +50,9 @@ namespace ray { namespace assets {
         GlyphMetrics getGlyphMetrics(int glyphIndex) const;
         GlyphMetrics getCodepointMetrics(int codepoint) const;
 
+        // Empty when the glyph wasn't baked, e.g. to add it to an atlas without a copy.
+        BitmapView bakedGlyph(int glyphIndex) const;
+
         Bitmap rasterizeGlyph(int glyphIndex) const;
         Bitmap rasterizeCodepoint(int codepoint) const;
         Bitmap rasterizeGlyphSDF(int glyphIndex, int padding, math::u8 insideValue, float distanceSlope) const;
@@ -48,7 +60,8 @@ namespace ray { namespace assets {
     
     private:
         std::vector<math::u8> mInfo;
-        std::vector<math::u8> mData;
+        platform::fs::FileData mData;
+        std::shared_ptr<const CookedFont> mBaked;
         int mLineHeight, mDescent, mAscent;
         float mScale;
     };
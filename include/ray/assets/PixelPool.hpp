@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ray { namespace assets {
+
+    // Recycles pixel buffers by power of two size classes, so that transient
+    // bitmaps (glyphs, staging copies, mips) don't go back to the heap each time.
+    // Buffers are ALIGNMENT bytes aligned. Thread safe.
+    class PixelPool
+    {
+    public:
+        static constexpr size_t ALIGNMENT = 64;
+        static constexpr size_t MIN_CLASS_SIZE = 4096;
+        static constexpr int CLASS_COUNT = 16;      // up to 128MB, larger buffers aren't kept
+
+        // Keeps at most 'maxCachedBytes' of released buffers around.
+        explicit PixelPool(size_t maxCachedBytes=64 << 20);
+        PixelPool(const PixelPool &other) = delete;
+        PixelPool &operator=(const PixelPool &other) = delete;
+        ~PixelPool();
+
+        uint8_t *acquire(size_t size);
+
+        // With the size it was acquired with.
+        void release(uint8_t *pixels, size_t size);
+
+        // Frees the buffers kept for later.
+        void trim();
+
+        size_t cachedBytes() const;
+        size_t hitCount() const;
+        size_t missCount() const;
+
+        // -1 for sizes above the largest class.
+        static int sizeClass(size_t size);
+
+        // NOTE(cme): never destroyed, bitmaps in statics may outlive any other object.
+        static PixelPool &shared();
+
+        // The allocator behind the pool, for aligned buffers not worth pooling.
+        static uint8_t *allocateAligned(size_t size);
+        static void freeAligned(uint8_t *pixels);
+
+    private:
+        mutable std::mutex mMutex;
+        std::vector<uint8_t *> mFree[CLASS_COUNT];
+        size_t mMaxCachedBytes, mCachedBytes = 0, mHits = 0, mMisses = 0;
+    };
+
+}}
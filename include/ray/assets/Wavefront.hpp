@@ -2,21 +2,62 @@
 
 #include <ray/math/LinearAlgebra.hpp>
 #include <ray/platform/FileSystem.hpp>
+#include <ray/platform/Pack.hpp>
 #include <ray/platform/Panic.hpp>
 #include <tiny_obj_loader.h>
+#include <istream>
+#include <map>
 
 namespace ray { namespace assets {
 
+    namespace details
+    {
+        // Reads the material libraries through fs::load, from the same pack as the object when it has one.
+        class MaterialReader : public tinyobj::MaterialReader
+        {
+        public:
+            MaterialReader(const std::string &baseDirectory) : mBaseDirectory(baseDirectory) {}
+
+            bool operator()(const std::string &matId, std::vector<tinyobj::material_t> *materials, std::map<std::string, int> *matMap, std::string *err) override
+            {
+                auto filename = platform::fs::join(mBaseDirectory, matId);
+                auto data = platform::fs::load(filename, platform::fs::Access::Sequential);
+                if (!data.isValid())
+                {
+                    if (err)
+                        *err += platform::fmt("could not load material library '%s': %s\n", filename, data.error());
+                    return false;
+                }
+                platform::fs::MemoryStreambuf buffer(data.data(), data.size());
+                std::istream stream(&buffer);
+                tinyobj::MaterialStreamReader reader(stream);
+                return reader(matId, materials, matMap, err);
+            }
+
+        private:
+            std::string mBaseDirectory;
+        };
+    }
+
     class Wavefront 
     {
     public:
-        Wavefront(const std::string &filename) : mBaseDirectory(platform::fs::parent(filename))
+        Wavefront(const std::string &filename) : Wavefront(platform::fs::load(filename, platform::fs::Access::Sequential), platform::fs::parent(filename), filename)
         {
+        }
+
+        // NOTE(cme): material libraries are looked up relative to 'baseDirectory'.
+        Wavefront(const platform::fs::FileData &data, const std::string &baseDirectory, const std::string &name="memory") : mBaseDirectory(baseDirectory)
+        {
+            panicif(!data.isValid(), "could not load '%s': %s", name, data.error());
+            platform::fs::MemoryStreambuf buffer(data.data(), data.size());
+            std::istream stream(&buffer);
+            details::MaterialReader materials(mBaseDirectory);
             std::string error;
             bool success;
 
-            success = tinyobj::LoadObj(&mAttributes, &mShapes, &mMaterials, &error, filename.c_str(), mBaseDirectory.c_str());        
-            panicif(!success, "could not load '%s': %s", filename, error);
+            success = tinyobj::LoadObj(&mAttributes, &mShapes, &mMaterials, &error, &stream, &materials);        
+            panicif(!success, "could not load '%s': %s", name, error);
             // TODO(cme): log warning if any
         }
 
@@ -64,7 +105,13 @@ namespace ray { namespace assets {
 
         const std::string getDiffuseTextureFilename(int material) const
         {
-            return platform::fs::join(mBaseDirectory, mMaterials[material].diffuse_texname);
+            return platform::fs::join(mBaseDirectory, getDiffuseTextureName(material));
+        }
+
+        // As written in the material library, relative to the object.
+        const std::string &getDiffuseTextureName(int material) const
+        {
+            return mMaterials[material].diffuse_texname;
         }
 
     private:
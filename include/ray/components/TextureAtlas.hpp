@@ -3,8 +3,18 @@
 #include <ray/gl/Texture.hpp>
 #include <ray/math/LinearAlgebra.hpp>
 
+namespace ray { namespace gl {
+
+    template<typename Buffers> class BasicUploadRing;
+    class PixelUnpackBuffer;
+    using UploadRing = BasicUploadRing<PixelUnpackBuffer>;
+
+}}
+
 namespace ray { namespace components {
 
+    // Bitmaps are packed in rows into a copy of the texture kept in memory, and
+    // only reach GL on flush: the part that changed, in one upload.
     class TextureAtlas : public gl::Texture
     {
     protected:
@@ -12,20 +22,40 @@ namespace ray { namespace components {
         using ivec2 = math::ivec2;
         using u8 = math::u8;
     public:
+        // NOTE(cme): the size of TextureAtlas(depth), unless GL allows less. Its copy in
+        //            memory makes the largest textures GL allows too costly.
+        static constexpr int DEFAULT_SIZE = 4096;
+
         TextureAtlas(int depth);
-        TextureAtlas(int width, int height, int depth) : Texture(width, height, depth, Color(0)), mCursor{1,1}, mNextY(1) {}
+        TextureAtlas(int width, int height, int depth);
         TextureAtlas(const TextureAtlas &other) = delete;
         TextureAtlas(TextureAtlas &&other) = default;
     
         TextureAtlas &operator=(const TextureAtlas &other) = delete;
         TextureAtlas &operator=(TextureAtlas &&other) = default;
     
-        rect2 add(const Bitmap &bitmap) { return add(bitmap.width(), bitmap.height(), bitmap.depth(), bitmap.pixels()); }
+        // The texture coordinates the bitmap will have, once flushed.
+        rect2 add(const BitmapView &bitmap);
         rect2 add(const std::string &filename) { return add(Bitmap(filename)); }
-        rect2 add(int width, int height, int depth, const u8 *pixels);
+        rect2 add(int width, int height, int depth, const u8 *pixels) { return add(BitmapView(pixels, width, height, depth)); }
+
+        // Uploads the union of what was added since the last flush, e.g. once a
+        // frame before the atlas is bound.
+        void flush();
+
+        // The same through the ring, uploaded directly when it is full. The upload is
+        // only staged: ring.flush(), or ring.endFrame(), must run before the atlas is bound.
+        void flush(gl::UploadRing &ring);
+        bool isDirty() const { return mDirtyMin.x < mDirtyMax.x && mDirtyMin.y < mDirtyMax.y; }
+
+        const Bitmap &pixels() const { return mPixels; }
     private:
+        void markClean();
+
+        Bitmap mPixels;
         ivec2 mCursor;
         int mNextY;
+        ivec2 mDirtyMin, mDirtyMax;
     };
 
-}}
\ No newline at end of file
+}}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ray/gl/VertexArray.hpp>
+#include <ray/platform/Registry.hpp>
+#include <memory>
 
 namespace ray { namespace entities {
 
@@ -9,76 +11,100 @@ namespace ray { namespace entities {
     protected:
         using vec3 = math::vec3;
         using vec2 = math::vec2;
+        using VertexBuffer = gl::VertexBuffer<float,8>;
     public:
-        Cube()
+        Cube() : mVertexBuffer(sharedVertexBuffer()) {}
+
+        // Every cube draws from the same vertex buffer, keyed by the hash of its content.
+        static platform::Registry<VertexBuffer> &registry()
         {
-            mVertexBuffer.load({
-                ////////////////////////////////////////////////////////////
-                // Position             TexCoord        Normal    
-                ////////////////////////////////////////////////////////////
-                // Front face
-                -0.5f, -0.5f,  0.5f,    0.0f, 0.0f,    0.0f,  0.0f, 1.0f,
-                0.5f, -0.5f,  0.5f,    1.0f, 0.0f,     0.0f,  0.0f, 1.0f,
-                0.5f,  0.5f,  0.5f,    1.0f, 1.0f,     0.0f,  0.0f, 1.0f,
-                0.5f,  0.5f,  0.5f,    1.0f, 1.0f,     0.0f,  0.0f, 1.0f,
-               -0.5f,  0.5f,  0.5f,    0.0f, 1.0f,     0.0f,  0.0f, 1.0f,
-               -0.5f, -0.5f,  0.5f,    0.0f, 0.0f,     0.0f,  0.0f, 1.0f,
-    
-               // Back face
-               -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     0.0f,  0.0f, -1.0f,
-                0.5f, -0.5f, -0.5f,    1.0f, 0.0f,     0.0f,  0.0f, -1.0f,
-                0.5f,  0.5f, -0.5f,    1.0f, 1.0f,     0.0f,  0.0f, -1.0f,
-                0.5f,  0.5f, -0.5f,    1.0f, 1.0f,     0.0f,  0.0f, -1.0f,
-               -0.5f,  0.5f, -0.5f,    0.0f, 1.0f,     0.0f,  0.0f, -1.0f,
-               -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     0.0f,  0.0f, -1.0f,
-    
-               // Left face
-               -0.5f,  0.5f, -0.5f,    1.0f, 0.0f,     1.0f,  0.0f,  0.0f,
-               -0.5f,  0.5f,  0.5f,    1.0f, 1.0f,     1.0f,  0.0f,  0.0f,
-               -0.5f, -0.5f,  0.5f,    0.0f, 1.0f,     1.0f,  0.0f,  0.0f,
-               -0.5f, -0.5f,  0.5f,    0.0f, 1.0f,     1.0f,  0.0f,  0.0f,
-               -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     1.0f,  0.0f,  0.0f,
-               -0.5f,  0.5f, -0.5f,    1.0f, 0.0f,     1.0f,  0.0f,  0.0f,
-    
-               // Right face 
-               0.5f,  0.5f, -0.5f,     1.0f, 0.0f,     -1.0f,  0.0f,  0.0f,
-               0.5f,  0.5f, +0.5f,     1.0f, 1.0f,     -1.0f,  0.0f,  0.0f,
-               0.5f, -0.5f, +0.5f,     0.0f, 1.0f,     -1.0f,  0.0f,  0.0f,
-               0.5f, -0.5f, +0.5f,     0.0f, 1.0f,     -1.0f,  0.0f,  0.0f,
-               0.5f, -0.5f, -0.5f,     0.0f, 0.0f,     -1.0f,  0.0f,  0.0f,
-               0.5f,  0.5f, -0.5f,     1.0f, 0.0f,     -1.0f,  0.0f,  0.0f,
-    
-               // Bottom face
-               -0.5f, -0.5f,  0.5f,    0.0f, 1.0f,     0.0f, 1.0f,  0.0f,
-                0.5f, -0.5f,  0.5f,    1.0f, 1.0f,     0.0f, 1.0f,  0.0f,
-                0.5f, -0.5f, -0.5f,    1.0f, 0.0f,     0.0f, 1.0f,  0.0f,
-                0.5f, -0.5f, -0.5f,    1.0f, 0.0f,     0.0f, 1.0f,  0.0f,
-               -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     0.0f, 1.0f,  0.0f,
-               -0.5f, -0.5f, +0.5f,    0.0f, 1.0f,     0.0f, 1.0f,  0.0f,
-    
-               // Top face
-               -0.5f,  0.5f, -0.5f,    0.0f, 1.0f,     0.0f,  -1.0f,  0.0f,
-                0.5f,  0.5f, -0.5f,    1.0f, 1.0f,     0.0f,  -1.0f,  0.0f,
-                0.5f,  0.5f,  0.5f,    1.0f, 0.0f,     0.0f,  -1.0f,  0.0f,
-                0.5f,  0.5f,  0.5f,    1.0f, 0.0f,     0.0f,  -1.0f,  0.0f,
-               -0.5f,  0.5f,  0.5f,    0.0f, 0.0f,     0.0f,  -1.0f,  0.0f,
-               -0.5f,  0.5f, -0.5f,    0.0f, 1.0f,     0.0f,  -1.0f,  0.0f
-            });
+            static platform::Registry<VertexBuffer> instance([](const VertexBuffer &buffer) { return buffer.size() * sizeof(float); });
+            return instance;
         }
-    
-        void bindPosition(gl::Attribute<vec3> position) const { bindAttributeAtOffset(0, position, mVertexBuffer);  }
-        void bindTexCoord(gl::Attribute<vec2> texCoord) const { bindAttributeAtOffset(3, texCoord, mVertexBuffer);  }
-        void bindNormal(gl::Attribute<vec3> normal)     const { bindAttributeAtOffset(5, normal, mVertexBuffer);    }
+
+        void bindPosition(gl::Attribute<vec3> position) const { bindAttributeAtOffset(0, position, *mVertexBuffer);  }
+        void bindTexCoord(gl::Attribute<vec2> texCoord) const { bindAttributeAtOffset(3, texCoord, *mVertexBuffer);  }
+        void bindNormal(gl::Attribute<vec3> normal)     const { bindAttributeAtOffset(5, normal, *mVertexBuffer);    }
     
         void draw() const
         {
             bind();
-            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mVertexBuffer.vertexCount());
+            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mVertexBuffer->vertexCount());
+            unbind();
+        }
+
+        size_t vertexCount() const { return mVertexBuffer->vertexCount(); }
+
+        void drawInstanced(size_t instanceCount) const
+        {
+            bind();
+            gl(DrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei)mVertexBuffer->vertexCount(), (GLsizei)instanceCount));
             unbind();
         }
     
     private:
-        gl::VertexBuffer<float,8> mVertexBuffer;
+        static std::shared_ptr<VertexBuffer> sharedVertexBuffer()
+        {
+            static const float VERTICES[] = {
+                    ////////////////////////////////////////////////////////////
+                    // Position             TexCoord        Normal    
+                    ////////////////////////////////////////////////////////////
+                    // Front face
+                    -0.5f, -0.5f,  0.5f,    0.0f, 0.0f,    0.0f,  0.0f, 1.0f,
+                    0.5f, -0.5f,  0.5f,    1.0f, 0.0f,     0.0f,  0.0f, 1.0f,
+                    0.5f,  0.5f,  0.5f,    1.0f, 1.0f,     0.0f,  0.0f, 1.0f,
+                    0.5f,  0.5f,  0.5f,    1.0f, 1.0f,     0.0f,  0.0f, 1.0f,
+                   -0.5f,  0.5f,  0.5f,    0.0f, 1.0f,     0.0f,  0.0f, 1.0f,
+                   -0.5f, -0.5f,  0.5f,    0.0f, 0.0f,     0.0f,  0.0f, 1.0f,
+    
+                   // Back face
+                   -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     0.0f,  0.0f, -1.0f,
+                    0.5f, -0.5f, -0.5f,    1.0f, 0.0f,     0.0f,  0.0f, -1.0f,
+                    0.5f,  0.5f, -0.5f,    1.0f, 1.0f,     0.0f,  0.0f, -1.0f,
+                    0.5f,  0.5f, -0.5f,    1.0f, 1.0f,     0.0f,  0.0f, -1.0f,
+                   -0.5f,  0.5f, -0.5f,    0.0f, 1.0f,     0.0f,  0.0f, -1.0f,
+                   -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     0.0f,  0.0f, -1.0f,
+    
+                   // Left face
+                   -0.5f,  0.5f, -0.5f,    1.0f, 0.0f,     1.0f,  0.0f,  0.0f,
+                   -0.5f,  0.5f,  0.5f,    1.0f, 1.0f,     1.0f,  0.0f,  0.0f,
+                   -0.5f, -0.5f,  0.5f,    0.0f, 1.0f,     1.0f,  0.0f,  0.0f,
+                   -0.5f, -0.5f,  0.5f,    0.0f, 1.0f,     1.0f,  0.0f,  0.0f,
+                   -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     1.0f,  0.0f,  0.0f,
+                   -0.5f,  0.5f, -0.5f,    1.0f, 0.0f,     1.0f,  0.0f,  0.0f,
+    
+                   // Right face 
+                   0.5f,  0.5f, -0.5f,     1.0f, 0.0f,     -1.0f,  0.0f,  0.0f,
+                   0.5f,  0.5f, +0.5f,     1.0f, 1.0f,     -1.0f,  0.0f,  0.0f,
+                   0.5f, -0.5f, +0.5f,     0.0f, 1.0f,     -1.0f,  0.0f,  0.0f,
+                   0.5f, -0.5f, +0.5f,     0.0f, 1.0f,     -1.0f,  0.0f,  0.0f,
+                   0.5f, -0.5f, -0.5f,     0.0f, 0.0f,     -1.0f,  0.0f,  0.0f,
+                   0.5f,  0.5f, -0.5f,     1.0f, 0.0f,     -1.0f,  0.0f,  0.0f,
+    
+                   // Bottom face
+                   -0.5f, -0.5f,  0.5f,    0.0f, 1.0f,     0.0f, 1.0f,  0.0f,
+                    0.5f, -0.5f,  0.5f,    1.0f, 1.0f,     0.0f, 1.0f,  0.0f,
+                    0.5f, -0.5f, -0.5f,    1.0f, 0.0f,     0.0f, 1.0f,  0.0f,
+                    0.5f, -0.5f, -0.5f,    1.0f, 0.0f,     0.0f, 1.0f,  0.0f,
+                   -0.5f, -0.5f, -0.5f,    0.0f, 0.0f,     0.0f, 1.0f,  0.0f,
+                   -0.5f, -0.5f, +0.5f,    0.0f, 1.0f,     0.0f, 1.0f,  0.0f,
+    
+                   // Top face
+                   -0.5f,  0.5f, -0.5f,    0.0f, 1.0f,     0.0f,  -1.0f,  0.0f,
+                    0.5f,  0.5f, -0.5f,    1.0f, 1.0f,     0.0f,  -1.0f,  0.0f,
+                    0.5f,  0.5f,  0.5f,    1.0f, 0.0f,     0.0f,  -1.0f,  0.0f,
+                    0.5f,  0.5f,  0.5f,    1.0f, 0.0f,     0.0f,  -1.0f,  0.0f,
+                   -0.5f,  0.5f,  0.5f,    0.0f, 0.0f,     0.0f,  -1.0f,  0.0f,
+                   -0.5f,  0.5f, -0.5f,    0.0f, 1.0f,     0.0f,  -1.0f,  0.0f
+            };
+            return registry().acquire(registry().key(VERTICES, sizeof(VERTICES)), [&]() { 
+                VertexBuffer buffer;
+                buffer.load(VERTICES, sizeof(VERTICES) / sizeof(float));
+                return buffer;
+            });
+        }
+
+        std::shared_ptr<VertexBuffer> mVertexBuffer;
     };
     
 
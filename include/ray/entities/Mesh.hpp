@@ -1,85 +1,259 @@
 #pragma once
 
+#include <ray/assets/Cooked.hpp>
 #include <ray/assets/Wavefront.hpp>
+#include <ray/gl/BufferHeap.hpp>
 #include <ray/gl/VertexArray.hpp>
 #include <ray/gl/Texture.hpp>
+#include <ray/platform/Registry.hpp>
+#include <memory>
 
 namespace ray { namespace entities {
 
     class Mesh
     {
         static constexpr size_t N_FLOATS_PER_VERTEX = 8;
+        static constexpr size_t VERTEX_SIZE = N_FLOATS_PER_VERTEX*sizeof(float);
     public:
+        // The vertices and textures of a mesh, shared by every Mesh loaded from the same file.
+        class Data
+        {
+        public:
+            Data(const assets::Wavefront &object, gl::BufferHeap *heap) : mHeap(heap)
+            {
+                std::vector<float> vertices;
+                vertices.reserve(N_FLOATS_PER_VERTEX*object.totalVertexCount());
+                for (auto shape = 0u; shape < object.shapeCount(); ++shape)
+                {
+                    for (auto triangle = 0u; triangle < object.triangleCount(shape); triangle++)
+                    {
+                        for (auto vertex = 0; vertex < 3; ++vertex)
+                        {
+                            auto position = object.getPosition(shape, triangle, vertex);
+                            vertices.push_back(position.x);
+                            vertices.push_back(position.y);
+                            vertices.push_back(position.z);
+                            auto texcoord = object.getTexCoord(shape, triangle, vertex);
+                            vertices.push_back(texcoord.u);
+                            vertices.push_back(texcoord.v);
+                            auto normal   = object.getNormal(shape, triangle, vertex);
+                            vertices.push_back(normal.x);
+                            vertices.push_back(normal.y);
+                            vertices.push_back(normal.z);
+                        }
+                    }
+                }
+                upload(vertices);
+
+                loadTextures(object);
+            }
+
+            // Keeps the indices of the cooked mesh, its vertices are shared between triangles.
+            Data(const assets::CookedMesh &object, gl::BufferHeap *heap) : mHeap(heap)
+            {
+                static_assert(assets::cooked::FLOATS_PER_VERTEX == N_FLOATS_PER_VERTEX, "cooked meshes have the same layout");
+                upload(std::vector<float>(object.vertices(), object.vertices() + N_FLOATS_PER_VERTEX*object.vertexCount()));
+                uploadIndices(object.indices(), object.indexCount());
+                loadTextures(object);
+            }
+
+            Data(Data &&other)
+                : mVertexBuffer(std::move(other.mVertexBuffer)), mIndexBuffer(std::move(other.mIndexBuffer)), mHeap(other.mHeap), 
+                  mAllocation(other.mAllocation), mIndexAllocation(other.mIndexAllocation),
+                  mBuffer(other.mBuffer), mIndices(other.mIndices), mBaseOffset(other.mBaseOffset), mIndexOffset(other.mIndexOffset), 
+                  mVertexCount(other.mVertexCount), mIndexCount(other.mIndexCount), mDiffuseTextures(std::move(other.mDiffuseTextures))
+            {
+                other.mAllocation = other.mIndexAllocation = gl::BufferHeap::Allocation();
+            }
+
+            ~Data()
+            {
+                if (mHeap)
+                {
+                    mHeap->free(mAllocation);
+                    mHeap->free(mIndexAllocation);
+                }
+            }
+
+            GLuint buffer() const { return mBuffer; }
+            size_t baseOffset() const { return mBaseOffset; }
+            size_t vertexCount() const { return mVertexCount; }
+
+            // Meshes loaded from a Wavefront are drawn as a list of triangles, without indices.
+            GLuint indexBuffer() const { return mIndices; }
+            size_t indexOffset() const { return mIndexOffset; }
+            size_t indexCount() const { return mIndexCount; }
+            bool isIndexed() const { return mIndexCount > 0; }
+
+            size_t byteSize() const { return mVertexCount*VERTEX_SIZE + mIndexCount*sizeof(GLuint); }
+            const gl::Texture &diffuseTexture(int index) const { return *mDiffuseTextures[index]; }
+
+        private:
+            template<typename Object>
+            void loadTextures(const Object &object)
+            {
+                // TODO(cme): if there are no texture, load default white
+                for (size_t material = 0; material < object.materialCount(); ++material)
+                    mDiffuseTextures.push_back(gl::Texture::shared(object.getDiffuseTextureFilename((int)material)));
+            }
+
+            void upload(const std::vector<float> &vertices)
+            {
+                mVertexCount = vertices.size() / N_FLOATS_PER_VERTEX;
+                if (mHeap)
+                {
+                    mAllocation = mHeap->allocate(vertices.size()*sizeof(float));
+                    mHeap->write(mAllocation, vertices.data(), vertices.size()*sizeof(float));
+                    mBuffer = mAllocation.buffer;
+                    mBaseOffset = mAllocation.offset;
+                }
+                else
+                {
+                    mVertexBuffer.load(vertices);
+                    mBuffer = mVertexBuffer.handle();
+                    mBaseOffset = 0;
+                }
+            }
+
+            void uploadIndices(const GLuint *indices, size_t count)
+            {
+                mIndexCount = count;
+                if (mHeap)
+                {
+                    mIndexAllocation = mHeap->allocate(count*sizeof(GLuint));
+                    mHeap->write(mIndexAllocation, indices, count*sizeof(GLuint));
+                    mIndices = mIndexAllocation.buffer;
+                    mIndexOffset = mIndexAllocation.offset;
+                }
+                else
+                {
+                    mIndexBuffer.load(indices, count);
+                    mIndices = mIndexBuffer.handle();
+                    mIndexOffset = 0;
+                }
+            }
+
+            gl::VertexBuffer<float, N_FLOATS_PER_VERTEX> mVertexBuffer;
+            gl::ElementBuffer mIndexBuffer;
+            gl::BufferHeap *mHeap = nullptr;
+            gl::BufferHeap::Allocation mAllocation, mIndexAllocation;
+            GLuint mBuffer = 0, mIndices = 0;
+            size_t mBaseOffset = 0, mIndexOffset = 0, mVertexCount = 0, mIndexCount = 0;
+            std::vector<std::shared_ptr<gl::Texture>> mDiffuseTextures;
+        };
+
         Mesh(const assets::Wavefront &object) { load(object); }
         Mesh(const std::string &filename) { load(filename); }
 
+        // Stores the vertices in a shared heap instead of a buffer object of their own.
+        Mesh(const assets::Wavefront &object, gl::BufferHeap &heap) : mHeap(&heap) { load(object); }
+        Mesh(const std::string &filename, gl::BufferHeap &heap) : mHeap(&heap) { load(filename); }
+
+        Mesh(Mesh &&other) = default;
+        Mesh &operator=(Mesh &&other) = default;
+
+        // NOTE(cme): the attributes have to be bound again after loading another mesh.
         void load(const std::string &filename)
         {
-            load(assets::Wavefront(filename));
+            auto key = registry().key(filename);
+            if (mHeap)
+                key = registry().key(&mHeap, sizeof(mHeap), key);
+            mData = registry().acquire(key, [&]() {
+                auto cooked = assets::cooked::find(assets::cooked::meshPath(filename));
+                if (!cooked.empty())
+                    return Data(assets::CookedMesh(cooked, platform::fs::parent(filename)), mHeap);
+                return Data(assets::Wavefront(filename), mHeap);
+            });
+            bindIndices();
         }
 
         void load(const assets::Wavefront &object)
         {
-            mVertexBuffer.reserve(N_FLOATS_PER_VERTEX*object.totalVertexCount());
-            auto mapped = mVertexBuffer.map(GL_WRITE_ONLY);
-            for (auto shape = 0u; shape < object.shapeCount(); ++shape)
+            mData = std::make_shared<Data>(object, mHeap);
+            bindIndices();
+        }
+
+        void draw() const
+        {
+            mVertexArray.bind();
+            if (mData->isIndexed())
             {
-                for (auto triangle = 0u; triangle < object.triangleCount(shape); triangle++)
-                {
-                    for (auto vertex = 0; vertex < 3; ++vertex)
-                    {
-                        auto position = object.getPosition(shape, triangle, vertex);
-                        (*mapped++) = position.x;
-                        (*mapped++) = position.y;
-                        (*mapped++) = position.z;
-                        auto texcoord = object.getTexCoord(shape, triangle, vertex);
-                        (*mapped++) = texcoord.u; 
-                        (*mapped++) = texcoord.v; 
-                        auto normal   = object.getNormal(shape, triangle, vertex);
-                        (*mapped++) = normal.x;
-                        (*mapped++) = normal.y;
-                        (*mapped++) = normal.z;                        
-                    }
-                }
+                gl(DrawElements(GL_TRIANGLES, (GLsizei)mData->indexCount(), GL_UNSIGNED_INT, (const GLvoid *)mData->indexOffset()));
             }
-            mVertexBuffer.unmap();
-
-            // TODO(cme): if there are no texture, load default white
-            for (size_t material = 0; material < object.materialCount(); ++material)
-                mDiffuseTextures.push_back(gl::Texture(object.getDiffuseTextureFilename((int)material)));
+            else
+            {
+                glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mData->vertexCount());
+            }
+            mVertexArray.unbind();
         }
-        
-        void draw() const
+
+        void drawInstanced(size_t instanceCount) const
         {
             mVertexArray.bind();
-            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)mVertexBuffer.vertexCount());
+            if (mData->isIndexed())
+            {
+                gl(DrawElementsInstanced(GL_TRIANGLES, (GLsizei)mData->indexCount(), GL_UNSIGNED_INT, (const GLvoid *)mData->indexOffset(), (GLsizei)instanceCount));
+            }
+            else
+            {
+                gl(DrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei)mData->vertexCount(), (GLsizei)instanceCount));
+            }
             mVertexArray.unbind();
         }
 
         void bindPosition(gl::Attribute<math::vec3> position) const
         {
-            mVertexArray.bindAttributeAtOffset(0, position, mVertexBuffer);
+            mVertexArray.bindAttributeAtByteOffset(position, mData->buffer(), VERTEX_SIZE, mData->baseOffset() + 0*sizeof(float));
         }
 
         void bindTexCoord(gl::Attribute<math::vec2> texCoord) const
         {
-            mVertexArray.bindAttributeAtOffset(3, texCoord, mVertexBuffer);
+            mVertexArray.bindAttributeAtByteOffset(texCoord, mData->buffer(), VERTEX_SIZE, mData->baseOffset() + 3*sizeof(float));
         }
 
         void bindNormal(gl::Attribute<math::vec3> normal) const
         {
-            mVertexArray.bindAttributeAtOffset(5, normal, mVertexBuffer);
+            mVertexArray.bindAttributeAtByteOffset(normal, mData->buffer(), VERTEX_SIZE, mData->baseOffset() + 5*sizeof(float));
+        }
+
+        const gl::VertexArray &vertexArray() const
+        {
+            return mVertexArray;
+        }
+
+        // NOTE(cme): an indexed mesh has to be drawn with its indexCount(), its
+        //            vertexCount() only counts the vertices shared by its triangles.
+        size_t vertexCount() const
+        {
+            return mData->vertexCount();
         }
 
+        bool isIndexed() const { return mData->isIndexed(); }
+        size_t indexCount() const { return mData->indexCount(); }
+        size_t indexOffset() const { return mData->indexOffset(); }
+
         const gl::Texture &diffuseTexture(int index=0) const
         {
-            return mDiffuseTextures[index];
+            return mData->diffuseTexture(index);
+        }
+
+        // Meshes loaded from a file share their data through this registry.
+        static platform::Registry<Data> &registry()
+        {
+            static platform::Registry<Data> instance([](const Data &data) { return data.byteSize(); });
+            return instance;
         }
 
     private:
-        gl::VertexBuffer<float, N_FLOATS_PER_VERTEX> mVertexBuffer;
+        void bindIndices() const
+        {
+            if (mData->isIndexed())
+                mVertexArray.bindIndices(mData->indexBuffer());
+        }
+
+        gl::BufferHeap *mHeap = nullptr;
+        std::shared_ptr<Data> mData;
         gl::VertexArray mVertexArray;
-        std::vector<gl::Texture> mDiffuseTextures;    
     };
 
 }}
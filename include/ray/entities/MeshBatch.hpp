@@ -0,0 +1,283 @@
+#pragma once
+
+#include <ray/assets/Cooked.hpp>
+#include <ray/assets/Wavefront.hpp>
+#include <ray/gl/VertexArray.hpp>
+#include <ray/gl/InstanceBuffer.hpp>
+#include <ray/platform/Hash.hpp>
+#include <ray/math/LinearAlgebra.hpp>
+#include <unordered_map>
+#include <array>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace ray { namespace entities {
+
+    namespace details
+    {
+        using BatchVertex = std::array<math::f32, 8>;
+
+        struct BatchVertexHash
+        {
+            size_t operator()(const BatchVertex &vertex) const
+            {
+                return platform::fnv1a(reinterpret_cast<const char *>(vertex.data()), sizeof(BatchVertex));
+            }
+        };
+
+        // Appends the distinct vertices of a triangle soup to 'vertices' and one index
+        // per input vertex to 'indices', relative to the first vertex appended.
+        inline void indexVertices(const std::vector<BatchVertex> &soup, std::vector<BatchVertex> &vertices, std::vector<math::u32> &indices)
+        {
+            std::unordered_map<BatchVertex, math::u32, BatchVertexHash> known;
+            auto first = vertices.size();
+            known.reserve(soup.size());
+            for (auto &vertex : soup)
+            {
+                auto hit = known.emplace(vertex, (math::u32)(vertices.size() - first));
+                if (hit.second) 
+                    vertices.push_back(vertex);
+                indices.push_back(hit.first->second);
+            }
+        }
+    }
+
+    // Keeps many static meshes in one vertex buffer and one index buffer, and
+    // draws the visible ones with a single glMultiDrawElementsIndirect. Every
+    // draw reads its model matrix and color from per-instance attributes, the
+    // command's baseInstance pointing at its entry. Without GL 4.3 the commands
+    // are issued one by one, with baseInstance on GL 4.2 and by rebinding the
+    // per-draw attributes before that.
+    class MeshBatch
+    {
+        using f32 = math::f32;
+        using u32 = math::u32;
+        using vec3 = math::vec3;
+        using vec4 = math::vec4;
+        using mat4 = math::mat4;
+
+    public:
+        using MeshId = u32;
+
+        // NOTE(cme): same layout as DrawElementsIndirectCommand.
+        struct DrawCommand { GLuint count, instanceCount, firstIndex; GLint baseVertex; GLuint baseInstance; };
+        struct DrawData { mat4 model; vec4 color; };
+
+        struct Statistics
+        {
+            size_t submitted = 0, culled = 0, drawCalls = 0;
+            size_t meshes = 0, vertices = 0, indices = 0;
+        };
+
+        MeshBatch() : mDirty(false)
+        {
+            if (platform::hasOpenGLVersion(4, 3) || platform::hasOpenGLExtension("GL_ARB_multi_draw_indirect"))
+                mPath = MULTI_DRAW_INDIRECT;
+            else if (platform::hasOpenGLVersion(4, 2) || platform::hasOpenGLExtension("GL_ARB_base_instance"))
+                mPath = BASE_INSTANCE;
+            else
+                mPath = REBIND;
+            mVertexArray.bindIndices(mIndexBuffer);
+        }
+
+        // Prefers the cooked mesh, already indexed, when there is one.
+        MeshId add(const std::string &filename)
+        {
+            auto cooked = assets::cooked::find(assets::cooked::meshPath(filename));
+            if (!cooked.empty())
+                return add(assets::CookedMesh(cooked, platform::fs::parent(filename)));
+            return add(assets::Wavefront(filename));
+        }
+
+        MeshId add(const assets::CookedMesh &object)
+        {
+            static_assert(assets::cooked::FLOATS_PER_VERTEX == std::tuple_size<details::BatchVertex>::value, "cooked meshes have the same layout");
+            Range range;
+            range.baseVertex = (GLint)mVertices.size();
+            range.firstIndex = (GLuint)mIndices.size();
+            range.indexCount = (GLuint)object.indexCount();
+            mVertices.resize(mVertices.size() + object.vertexCount());
+            if (object.vertexCount() > 0)
+                std::memcpy(mVertices[range.baseVertex].data(), object.vertices(), object.vertexCount() * sizeof(details::BatchVertex));
+            mIndices.insert(mIndices.end(), object.indices(), object.indices() + object.indexCount());
+            return addRange(range);
+        }
+
+        MeshId add(const assets::Wavefront &object)
+        {
+            std::vector<details::BatchVertex> soup;
+            soup.reserve(object.totalVertexCount());
+            for (auto shape = 0u; shape < object.shapeCount(); ++shape)
+            {
+                for (auto triangle = 0u; triangle < object.triangleCount(shape); triangle++)
+                {
+                    for (auto vertex = 0; vertex < 3; ++vertex)
+                    {
+                        auto position = object.getPosition(shape, triangle, vertex);
+                        auto texcoord = object.getTexCoord(shape, triangle, vertex);
+                        auto normal   = object.getNormal(shape, triangle, vertex);
+                        soup.push_back({{ position.x, position.y, position.z, texcoord.u, texcoord.v, normal.x, normal.y, normal.z }});
+                    }
+                }
+            }
+
+            Range range;
+            range.baseVertex = (GLint)mVertices.size();
+            range.firstIndex = (GLuint)mIndices.size();
+            details::indexVertices(soup, mVertices, mIndices);
+            range.indexCount = (GLuint)(mIndices.size() - range.firstIndex);
+            return addRange(range);
+        }
+
+        void bindPosition(gl::Attribute<vec3> position) const { mVertexArray.bindAttributeAtOffset(0, position, mVertexBuffer); }
+        void bindTexCoord(gl::Attribute<math::vec2> texCoord) const { mVertexArray.bindAttributeAtOffset(3, texCoord, mVertexBuffer); }
+        void bindNormal(gl::Attribute<vec3> normal) const { mVertexArray.bindAttributeAtOffset(5, normal, mVertexBuffer); }
+        
+        // NOTE(cme): the model matrix is read per draw, use it in place of a modelMatrix uniform.
+        void bindModel(gl::Attribute<mat4> model) { mModel = model; mHasModel = true; mDrawData.bindAttribute(mVertexArray, model, offsetof(DrawData, model)); }
+        void bindColor(gl::Attribute<vec4> color) { mColor = color; mHasColor = true; mDrawData.bindAttribute(mVertexArray, color, offsetof(DrawData, color)); }
+
+        void begin(const math::frustum &frustum)
+        {
+            mFrustum = frustum;
+            mCommands.clear();
+            mDraws.clear();
+            mStatistics.submitted = mStatistics.culled = mStatistics.drawCalls = 0;
+        }
+
+        bool submit(MeshId mesh, const mat4 &model, const vec4 &color)
+        {
+            auto &range = mRanges[mesh];
+            mStatistics.submitted += 1;
+
+            auto center = vec3(
+                model(0,0)*range.center.x + model(0,1)*range.center.y + model(0,2)*range.center.z + model(0,3),
+                model(1,0)*range.center.x + model(1,1)*range.center.y + model(1,2)*range.center.z + model(1,3),
+                model(2,0)*range.center.x + model(2,1)*range.center.y + model(2,2)*range.center.z + model(2,3));
+            auto scale = 0.0f;
+            for (size_t column = 0; column < 3; ++column)
+                scale = std::max(scale, std::sqrt(model(0,column)*model(0,column) + model(1,column)*model(1,column) + model(2,column)*model(2,column)));
+
+            if (!mFrustum.intersects(center, range.radius * scale))
+            {
+                mStatistics.culled += 1;
+                return false;
+            }
+
+            mCommands.push_back(DrawCommand{ range.indexCount, 1, range.firstIndex, range.baseVertex, (GLuint)mDraws.size() });
+            mDraws.push_back(DrawData{ gl::columnMajor(model), color });
+            return true;
+        }
+
+        void draw()
+        {
+            upload();
+            if (mCommands.empty()) 
+                return;
+
+            mDrawData.load(mDraws);
+            mVertexArray.bind();
+            switch (mPath)
+            {
+            case MULTI_DRAW_INDIRECT:
+                mCommandBuffer.load(mCommands.data(), mCommands.size(), GL_STREAM_DRAW);
+                gl(MultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)mCommands.size(), 0));
+                mStatistics.drawCalls += 1;
+                break;
+            case BASE_INSTANCE:
+                for (auto &command : mCommands)
+                {
+                    auto indices = (const void *)(command.firstIndex * sizeof(GLuint));
+                    gl(DrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, (GLsizei)command.count, GL_UNSIGNED_INT, indices, 1, command.baseVertex, command.baseInstance));
+                }
+                mStatistics.drawCalls += mCommands.size();
+                break;
+            default:
+                for (auto &command : mCommands)
+                {
+                    auto draw = command.baseInstance * sizeof(DrawData);
+                    // NOTE(cme): attributes default to location 0, which is the position.
+                    if (mHasModel) mDrawData.bindAttribute(mVertexArray, mModel, draw + offsetof(DrawData, model));
+                    if (mHasColor) mDrawData.bindAttribute(mVertexArray, mColor, draw + offsetof(DrawData, color));
+                    mVertexArray.bind();
+                    auto indices = (GLvoid *)(command.firstIndex * sizeof(GLuint));
+                    gl(DrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)command.count, GL_UNSIGNED_INT, indices, command.baseVertex));
+                }
+                mStatistics.drawCalls += mCommands.size();
+                break;
+            }
+            mVertexArray.unbind();
+        }
+
+        const Statistics &statistics() const { return mStatistics; }
+        bool usesMultiDrawIndirect() const { return mPath == MULTI_DRAW_INDIRECT; }
+
+    private:
+        enum { MULTI_DRAW_INDIRECT, BASE_INSTANCE, REBIND };
+
+        struct Range
+        {
+            GLuint firstIndex, indexCount;
+            GLint baseVertex;
+            vec3 center;
+            f32 radius;
+        };
+
+        // Bounds the vertices appended since range.baseVertex.
+        MeshId addRange(Range range)
+        {
+            auto lower = vec3(INFINITY), upper = vec3(-INFINITY);
+            for (auto vertex = mVertices.begin() + range.baseVertex; vertex != mVertices.end(); ++vertex)
+            {
+                lower = vec3(std::min(lower.x, (*vertex)[0]), std::min(lower.y, (*vertex)[1]), std::min(lower.z, (*vertex)[2]));
+                upper = vec3(std::max(upper.x, (*vertex)[0]), std::max(upper.y, (*vertex)[1]), std::max(upper.z, (*vertex)[2]));
+            }
+            range.center = (lower + upper) * 0.5f;
+            range.radius = 0.0f;
+            for (auto vertex = mVertices.begin() + range.baseVertex; vertex != mVertices.end(); ++vertex)
+                range.radius = std::max(range.radius, (f32)length(vec3((*vertex)[0], (*vertex)[1], (*vertex)[2]) - range.center));
+
+            mRanges.push_back(range);
+            mDirty = true;
+            return (MeshId)(mRanges.size() - 1);
+        }
+
+        void upload()
+        {
+            if (!mDirty) 
+                return;
+            // NOTE(cme): nothing to upload when only empty meshes were added.
+            if (!mVertices.empty())
+                mVertexBuffer.load(mVertices.front().data(), mVertices.size() * std::tuple_size<details::BatchVertex>::value);
+            if (!mIndices.empty())
+                mIndexBuffer.load(mIndices);
+            mStatistics.meshes = mRanges.size();
+            mStatistics.vertices = mVertices.size();
+            mStatistics.indices = mIndices.size();
+            mDirty = false;
+        }
+
+        std::vector<details::BatchVertex> mVertices;
+        std::vector<u32> mIndices;
+        std::vector<Range> mRanges;
+        bool mDirty;
+        int mPath;
+
+        gl::VertexBuffer<f32, 8> mVertexBuffer;
+        gl::ElementBuffer mIndexBuffer;
+        gl::VertexArray mVertexArray;
+        gl::InstanceBuffer<DrawData> mDrawData;
+        gl::Buffer<GL_DRAW_INDIRECT_BUFFER, DrawCommand, 1> mCommandBuffer;
+        gl::Attribute<mat4> mModel;
+        gl::Attribute<vec4> mColor;
+        bool mHasModel = false, mHasColor = false;
+
+        math::frustum mFrustum;
+        std::vector<DrawCommand> mCommands;
+        std::vector<DrawData> mDraws;
+        Statistics mStatistics;
+    };
+
+}}
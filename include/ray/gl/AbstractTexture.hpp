@@ -1,9 +1,32 @@
 #pragma once
 
+#include <ray/assets/BitmapView.hpp>
+#include <ray/assets/BlockCompression.hpp>
 #include <ray/gl/Handle.hpp>
 #include <ray/platform/Panic.hpp>
 
 namespace ray { namespace gl {
+
+    namespace details
+    {
+        // Tells GL how the rows of a view are laid out, until it goes out of scope.
+        class UnpackRows
+        {
+        public:
+            UnpackRows(const assets::BitmapView &view)
+            {
+                panicif(view.stride() % view.depth() != 0, "rows of %d bytes aren't a whole number of %d bytes pixels", view.stride(), view.depth());
+                gl(PixelStorei(GL_UNPACK_ROW_LENGTH, view.isTight() ? 0 : view.stride() / view.depth()));
+                gl(PixelStorei(GL_UNPACK_ALIGNMENT, 1));
+            }
+
+            ~UnpackRows()
+            {
+                gl(PixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+                gl(PixelStorei(GL_UNPACK_ALIGNMENT, 4));
+            }
+        };
+    }
     
     template<GLenum textureType>
     struct sampler { GLuint value; };
@@ -20,8 +43,8 @@ namespace ray { namespace gl {
         auto bind(GLuint slotIndex=GL_TEXTURE0) const
         {
             gl(ActiveTexture(slotIndex));
-            gl(BindTexture(GL_TEXTURE_2D, mHandle));
-            return sampler<TEXTURE_TYPE>{GL_TEXTURE0-slotIndex};
+            gl(BindTexture(textureType, mHandle));
+            return sampler<TEXTURE_TYPE>{slotIndex-GL_TEXTURE0};
         }
 
         void setSwizzle(GLint r, GLint g, GLint b, GLint a) const
@@ -47,32 +70,102 @@ namespace ray { namespace gl {
         }
 
         void load(int width, int height, int depth, const GLubyte *pixels, GLenum target=TEXTURE_TYPE, bool generateMipmap=true) const
+        {
+            loadLevel(0, width, height, depth, pixels, target);
+            if (generateMipmap) 
+            {
+                gl(TexParameteri(TEXTURE_TYPE, GL_TEXTURE_MAX_LEVEL, 1000));
+                gl(GenerateMipmap(TEXTURE_TYPE));
+            }
+        }
+
+        // Padded rows and regions of a larger bitmap are unpacked in place, without a copy.
+        void load(const assets::BitmapView &bitmap, GLenum target=TEXTURE_TYPE, bool generateMipmap=true) const
+        {
+            details::UnpackRows rows(bitmap);
+            load(bitmap.width(), bitmap.height(), bitmap.depth(), bitmap.pixels(), target, generateMipmap);
+        }
+
+        // E.g. a mip chain built offline, the swizzle is set from level 0.
+        void loadLevel(int level, int width, int height, int depth, const GLubyte *pixels, GLenum target=TEXTURE_TYPE) const
         {
             bind();
+            // NOTE(cme): rows of odd mips and of 1 or 3 channels textures aren't 4 bytes aligned.
+            auto isAligned = (width * depth) % 4 == 0;
+            if (!isAligned) gl(PixelStorei(GL_UNPACK_ALIGNMENT, 1));
             switch(depth)
             {
             case 1:
-                gl(PixelStorei(GL_UNPACK_ALIGNMENT, 1));
-                gl(TexImage2D(target, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels));
-                setSwizzle(GL_ONE, GL_ONE, GL_ONE, GL_RED);
-                gl(PixelStorei(GL_UNPACK_ALIGNMENT, 4));
+                gl(TexImage2D(target, level, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels));
+                if (level == 0) setSwizzle(GL_ONE, GL_ONE, GL_ONE, GL_RED);
                 break;
             case 2:
-                gl(TexImage2D(target, 0, GL_RG, width, height, 0, GL_RG, GL_UNSIGNED_BYTE, pixels));
-                setSwizzle(GL_RED, GL_RED, GL_RED, GL_GREEN);
+                gl(TexImage2D(target, level, GL_RG, width, height, 0, GL_RG, GL_UNSIGNED_BYTE, pixels));
+                if (level == 0) setSwizzle(GL_RED, GL_RED, GL_RED, GL_GREEN);
                 break;
             case 3:
-                gl(TexImage2D(target, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels));
-                setSwizzle(GL_RED, GL_GREEN, GL_BLUE, GL_ONE);
+                gl(TexImage2D(target, level, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels));
+                if (level == 0) setSwizzle(GL_RED, GL_GREEN, GL_BLUE, GL_ONE);
                 break;
             case 4:   
-                gl(TexImage2D(target, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
-                setSwizzle(GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA);
+                gl(TexImage2D(target, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+                if (level == 0) setSwizzle(GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA);
                 break;
             default:
                 panic("unexpected number of channels '%d'", depth);                
             }
-            if (generateMipmap) gl(GenerateMipmap(TEXTURE_TYPE));
+            if (!isAligned) gl(PixelStorei(GL_UNPACK_ALIGNMENT, 4));
+        }
+
+        // A level of 4x4 blocks as encoded by assets::bc, swizzled like the uncompressed
+        // level of the same number of channels.
+        void loadCompressedLevel(int level, int width, int height, assets::TextureFormat format, const GLubyte *blocks, size_t size, GLenum target=TEXTURE_TYPE) const
+        {
+            bind();
+            switch(format)
+            {
+            case assets::TextureFormat::BC1:
+                gl(CompressedTexImage2D(target, level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, width, height, 0, (GLsizei)size, blocks));
+                if (level == 0) setSwizzle(GL_RED, GL_GREEN, GL_BLUE, GL_ONE);
+                break;
+            case assets::TextureFormat::BC3:
+                gl(CompressedTexImage2D(target, level, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, width, height, 0, (GLsizei)size, blocks));
+                if (level == 0) setSwizzle(GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA);
+                break;
+            case assets::TextureFormat::BC4:
+                gl(CompressedTexImage2D(target, level, GL_COMPRESSED_RED_RGTC1, width, height, 0, (GLsizei)size, blocks));
+                if (level == 0) setSwizzle(GL_ONE, GL_ONE, GL_ONE, GL_RED);
+                break;
+            case assets::TextureFormat::BC5:
+                gl(CompressedTexImage2D(target, level, GL_COMPRESSED_RG_RGTC2, width, height, 0, (GLsizei)size, blocks));
+                if (level == 0) setSwizzle(GL_RED, GL_RED, GL_RED, GL_GREEN);
+                break;
+            default:
+                panic("unexpected texture format '%d'", (int)format);
+            }
+        }
+
+        // NOTE(cme): RGTC (BC4, BC5) is core since 3.0, S3TC (BC1, BC3) is an extension
+        //            every desktop driver has, but not mesa builds without it.
+        static bool supportsCompression(assets::TextureFormat format)
+        {
+            switch(format)
+            {
+            case assets::TextureFormat::Uncompressed:
+            case assets::TextureFormat::BC4:
+            case assets::TextureFormat::BC5:
+                return true;
+            default:
+                static const auto hasS3tc = platform::hasOpenGLExtension("GL_EXT_texture_compression_s3tc");
+                return hasS3tc;
+            }
+        }
+
+        // Levels past 'count' are left out, so a partial chain is still complete.
+        void setLevelCount(int count) const
+        {
+            bind();
+            gl(TexParameteri(TEXTURE_TYPE, GL_TEXTURE_MAX_LEVEL, count - 1));
         }
     private:
         static void destroy(GLuint handle) { gl(DeleteTextures(1, &handle)); }
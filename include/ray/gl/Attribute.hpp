@@ -2,6 +2,7 @@
 
 #include <ray/platform/OpenGL.hpp>
 #include <ray/platform/Panic.hpp>
+#include <ray/gl/Buffer.hpp>
 #include <ray/gl/Type.hpp>
 
 namespace ray { namespace gl {
@@ -14,9 +15,16 @@ namespace ray { namespace gl {
         template<> struct ScalarType<math::vec2> { using type = math::f32; }; 
         template<> struct ScalarType<math::vec3> { using type = math::f32; }; 
         template<> struct ScalarType<math::vec4> { using type = math::f32; }; 
+        template<> struct ScalarType<math::mat3> { using type = math::f32; }; 
         template<> struct ScalarType<math::mat4> { using type = math::f32; }; 
         template<> struct ScalarType<sampler<GL_TEXTURE_2D>>        { using type = math::u32; }; 
         template<> struct ScalarType<sampler<GL_TEXTURE_CUBE_MAP>>  { using type = math::u32; }; 
+        template<> struct ScalarType<sampler<GL_TEXTURE_2D_ARRAY>>  { using type = math::u32; }; 
+
+        // NOTE(cme): a matrix attribute takes one location per column.
+        template<typename T> struct LocationCount { static constexpr size_t value = 1; };
+        template<> struct LocationCount<math::mat3> { static constexpr size_t value = 3; };
+        template<> struct LocationCount<math::mat4> { static constexpr size_t value = 4; };
     }
 
     template<typename V>
@@ -30,11 +38,27 @@ namespace ray { namespace gl {
         constexpr Attribute(GLint location) : mLocation(location) {}
 
         template<typename T, size_t stride>
-        void bind(const VertexBuffer<T, stride> &vbo, bool normalized, size_t offset)
+        void bind(const VertexBuffer<T, stride> &vbo, bool normalized, size_t offset, GLuint divisor=0)
+        {
+            bind(vbo.handle(), getType<T>(), stride * sizeof(T), offset * sizeof(T), normalized, divisor);
+        }
+
+        // Reads the attribute from any buffer object, strides and offsets are in bytes.
+        void bind(GLuint buffer, GLenum componentType, size_t byteStride, size_t byteOffset, bool normalized, GLuint divisor=0)
         {
-            vbo.bind();
-            gl(EnableVertexAttribArray(mLocation));
-            glVertexAttribPointer(mLocation, (int)scalarCount(), getType<T>(), normalized ? GL_TRUE : GL_FALSE, stride * sizeof(T), (GLvoid *)(offset*sizeof(T)));
+            gl(BindBuffer(GL_ARRAY_BUFFER, buffer));
+            for (size_t column = 0; column < locationCount(); ++column)
+            {
+                auto location = (GLuint)mLocation + (GLuint)column;
+                auto columnOffset = byteOffset + column*componentCount()*scalarSize();
+                gl(EnableVertexAttribArray(location));
+                glVertexAttribPointer(location, (int)componentCount(), componentType, normalized ? GL_TRUE : GL_FALSE, (GLsizei)byteStride, (GLvoid *)columnOffset);
+                // NOTE(cme): reset for per-vertex attributes too, the location may have
+                //            been instanced before in this vertex array. Without GL 3.3
+                //            there is no divisor to reset.
+                if (divisor != 0 || glVertexAttribDivisor != nullptr)
+                    gl(VertexAttribDivisor(location, divisor));
+            }
         }
 
         constexpr auto type() const { return getType<V>(); }
@@ -42,6 +66,8 @@ namespace ray { namespace gl {
         constexpr auto scalarType() const { return getType<F>(); }
         constexpr auto scalarSize() const { return sizeof(F); }
         constexpr auto scalarCount() const { return size()/scalarSize(); }
+        constexpr auto locationCount() const { return details::LocationCount<V>::value; }
+        constexpr auto componentCount() const { return scalarCount()/locationCount(); }
 
     private:
         GLint mLocation = 0;
@@ -65,6 +65,7 @@ namespace ray { namespace gl {
 
         void unmap() { bind(); gl(UnmapBuffer(target)); }
         void bind() const  { gl(BindBuffer(target, mHandle)); }
+        GLuint handle() const { return mHandle; }
         void unbind() const { gl(BindBuffer(target, 0)); }
 
     private:
@@ -78,4 +79,6 @@ namespace ray { namespace gl {
     
     using ElementBuffer = Buffer<GL_ELEMENT_ARRAY_BUFFER, GLuint, 1>;
 
+    using UniformBuffer = Buffer<GL_UNIFORM_BUFFER, GLubyte, 1>;
+
 }}
\ No newline at end of file
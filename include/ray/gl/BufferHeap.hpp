@@ -0,0 +1,118 @@
+#pragma once
+
+#include <ray/gl/Buffer.hpp>
+#include <ray/platform/OffsetAllocator.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    // Sub-allocates vertex and index data from a few large buffer objects instead
+    // of creating one buffer object per mesh. Each page is a buffer object managed
+    // by an OffsetAllocator; a new page is created when none of them has room.
+    class BufferHeap
+    {
+        using u32 = platform::OffsetAllocator::u32;
+        using PageBuffer = Buffer<GL_ARRAY_BUFFER, GLubyte, 1>;
+
+    public:
+        struct Allocation
+        {
+            GLuint buffer = 0;
+            size_t offset = 0, size = 0;
+            u32 page = 0;
+            platform::OffsetAllocator::Allocation slot;
+            bool isValid() const { return buffer != 0; }
+        };
+
+        struct Statistics
+        {
+            size_t pages = 0, allocations = 0;
+            size_t reservedBytes = 0, usedBytes = 0, freeBytes = 0, largestFreeBytes = 0;
+            float fragmentation() const { return freeBytes ? 1.0f - float(largestFreeBytes) / float(freeBytes) : 0.0f; }
+        };
+
+        // NOTE(cme): offsets are multiples of 'alignment' bytes, which must cover the
+        //            alignment of any attribute or index type stored in the heap.
+        BufferHeap(size_t pageSize=16*1024*1024, size_t alignment=16, GLenum usage=GL_STATIC_DRAW) 
+            : mPageSize(pageSize), mAlignment(alignment), mUsage(usage) 
+        {
+            panicif(alignment == 0 || pageSize % alignment != 0, "page size %d is not a multiple of the alignment %d", pageSize, alignment);
+        }
+
+        Allocation allocate(size_t size)
+        {
+            auto units = (u32)((size + mAlignment - 1) / mAlignment);
+            for (u32 page = 0; page < mPages.size(); ++page)
+            {
+                auto slot = mPages[page]->allocator.allocate(units);
+                if (slot.isValid()) 
+                    return makeAllocation(page, slot, size);
+            }
+
+            auto pageUnits = (u32)(std::max(mPageSize, units * mAlignment) / mAlignment);
+            mPages.emplace_back(new Page(pageUnits, pageUnits * mAlignment, mUsage));
+            auto page = (u32)(mPages.size() - 1);
+            return makeAllocation(page, mPages[page]->allocator.allocate(units), size);
+        }
+
+        void free(Allocation &allocation)
+        {
+            if (!allocation.isValid()) 
+                return;
+            mPages[allocation.page]->allocator.free(allocation.slot);
+            allocation = Allocation();
+        }
+
+        void write(const Allocation &allocation, const void *data, size_t size, size_t offset=0) const
+        {
+            panicif(offset + size > allocation.size, "writing %d bytes at %d overflows an allocation of %d bytes", size, offset, allocation.size);
+            gl(BindBuffer(GL_ARRAY_BUFFER, allocation.buffer));
+            gl(BufferSubData(GL_ARRAY_BUFFER, (GLintptr)(allocation.offset + offset), (GLsizeiptr)size, data));
+            gl(BindBuffer(GL_ARRAY_BUFFER, 0));
+        }
+
+        Statistics statistics() const
+        {
+            Statistics result;
+            result.pages = mPages.size();
+            for (auto &page : mPages)
+            {
+                auto statistics = page->allocator.statistics();
+                result.allocations += statistics.allocationCount;
+                result.reservedBytes += statistics.capacity * mAlignment;
+                result.usedBytes += statistics.usedSpace * mAlignment;
+                result.freeBytes += statistics.freeSpace * mAlignment;
+                result.largestFreeBytes = std::max(result.largestFreeBytes, statistics.largestFreeRegion * mAlignment);
+            }
+            return result;
+        }
+
+    private:
+        struct Page
+        {
+            Page(u32 units, size_t bytes, GLenum usage) : allocator(units) { buffer.reserve(bytes, usage); }
+            PageBuffer buffer;
+            platform::OffsetAllocator allocator;
+        };
+
+        Allocation makeAllocation(u32 page, const platform::OffsetAllocator::Allocation &slot, size_t size) const
+        {
+            panicif(!slot.isValid(), "could not allocate %d bytes in a new heap page", size);
+            Allocation allocation;
+            allocation.buffer = mPages[page]->buffer.handle();
+            allocation.offset = slot.offset * mAlignment;
+            allocation.size = size;
+            allocation.page = page;
+            allocation.slot = slot;
+            return allocation;
+        }
+
+        size_t mPageSize, mAlignment;
+        GLenum mUsage;
+        std::vector<std::unique_ptr<Page>> mPages;
+    };
+
+}}
@@ -2,6 +2,7 @@
 
 #include <ray/gl/AbstractTexture.hpp>
 #include <ray/assets/Bitmap.hpp>
+#include <ray/assets/Cooked.hpp>
 #include <string>
 
 namespace ray { namespace gl {
@@ -13,17 +14,49 @@ namespace ray { namespace gl {
     protected:
         using Bitmap = assets::Bitmap;        
     public:
-        CubeMap(const std::vector<std::string> &faces) { load(faces); }
+        // Faces loaded from their sources are compressed on load when asked to.
+        CubeMap(const std::vector<std::string> &faces, bool compress=false) { load(faces, compress); }
     
-        void load(const std::vector<std::string> &faces)
+        void load(const std::vector<std::string> &faces, bool compress=false)
         {
             for (size_t i = 0; i < 6u; ++i)
             {   
+                auto target = (GLenum)(GL_TEXTURE_CUBE_MAP_POSITIVE_X+i);
+                auto cooked = assets::cooked::find(assets::cooked::texturePath(faces[i]));
+                if (!cooked.empty())
+                {
+                    // NOTE(cme): sampled without mips, only the first level is needed.
+                    auto texture = assets::CookedTexture(cooked);
+                    auto face = texture.level(0);
+                    loadFace(target, face.width, face.height, texture.depth(), texture.format(), face.pixels, face.size);
+                    continue;
+                }
                 auto face = Bitmap(faces[i]);
-                AbstractTexture::load(face.width(), face.height(), face.depth(), face.pixels(), (GLenum)(GL_TEXTURE_CUBE_MAP_POSITIVE_X+i), false);
+                if (compress)
+                {
+                    auto format = assets::bc::formatFor(face);
+                    auto blocks = assets::bc::encode(face, format);
+                    loadFace(target, face.width(), face.height(), face.depth(), format, blocks.data(), blocks.size());
+                }
+                else
+                    AbstractTexture::load(face, target, false);
             }
             setFilter(GL_LINEAR, GL_LINEAR);
             setWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
         }
+
+    private:
+        void loadFace(GLenum target, int width, int height, int depth, assets::TextureFormat format, const GLubyte *pixels, size_t size)
+        {
+            if (format == assets::TextureFormat::Uncompressed)
+                AbstractTexture::load(width, height, depth, pixels, target, false);
+            else if (supportsCompression(format))
+                loadCompressedLevel(0, width, height, format, pixels, size, target);
+            else
+            {
+                auto decoded = assets::bc::decode(pixels, format, width, height);
+                AbstractTexture::load(decoded.width(), decoded.height(), decoded.depth(), decoded.pixels(), target, false);
+            }
+        }
     };
 }}
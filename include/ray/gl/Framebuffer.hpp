@@ -0,0 +1,191 @@
+#pragma once
+
+#include <ray/gl/Handle.hpp>
+#include <ray/gl/Texture.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace ray { namespace gl {
+
+    // What a render target is made of, two targets with equal descriptions are interchangeable.
+    struct RenderTargetDescription
+    {
+        int width = 0, height = 0;
+        GLenum format = GL_RGBA8;
+        int samples = 1;
+
+        bool operator==(const RenderTargetDescription &other) const
+        {
+            return width == other.width && height == other.height && format == other.format && samples == other.samples;
+        }
+        bool operator!=(const RenderTargetDescription &other) const { return !(*this == other); }
+
+        bool isMultisampled() const { return samples > 1; }
+        bool isDepth() const { return format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH24_STENCIL8; }
+
+        static size_t bytesPerPixel(GLenum format)
+        {
+            switch(format)
+            {
+            case GL_R8: return 1;
+            case GL_RG8: return 2;
+            // NOTE(cme): drivers pad 3 channel and 24 bits depth formats to 4 bytes.
+            case GL_RGB8: case GL_RGBA8: case GL_SRGB8_ALPHA8: case GL_R11F_G11F_B10F: case GL_RGB10_A2: return 4;
+            case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32F: case GL_DEPTH24_STENCIL8: case GL_R32F: return 4;
+            case GL_RGB16F: case GL_RGBA16F: case GL_RG32F: return 8;
+            case GL_RGB32F: case GL_RGBA32F: return 16;
+            default: panic("unexpected render target format '%d'", format);
+            }
+        }
+
+        size_t byteSize() const { return (size_t)width * height * bytesPerPixel(format) * std::max(samples, 1); }
+    };
+
+    class Renderbuffer
+    {
+    public:
+        Renderbuffer(int width, int height, GLenum format, int samples=1)
+        {
+            bind();
+            if (samples > 1)
+            {
+                gl(RenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format, width, height));
+            }
+            else
+            {
+                gl(RenderbufferStorage(GL_RENDERBUFFER, format, width, height));
+            }
+            gl(BindRenderbuffer(GL_RENDERBUFFER, 0));
+        }
+
+        void bind() const { gl(BindRenderbuffer(GL_RENDERBUFFER, mHandle)); }
+        GLuint handle() const { return mHandle; }
+
+    private:
+        static void create(GLuint &handle) { gl(GenRenderbuffers(1, &handle)); }
+        static void destroy(GLuint handle) { gl(DeleteRenderbuffers(1, &handle)); }
+        gl::Handle<create, destroy> mHandle;
+    };
+
+    // A single sampled target is a texture that can be read back in a shader, a
+    // multisampled one is a renderbuffer that has to be resolved first.
+    class RenderTarget
+    {
+    public:
+        RenderTarget(const RenderTargetDescription &description) : mDescription(description)
+        {
+            if (description.isMultisampled())
+            {
+                mRenderbuffer.reset(new Renderbuffer(description.width, description.height, description.format, description.samples));
+                return;
+            }
+
+            mTexture.reset(new Texture());
+            mTexture->setFilter(GL_LINEAR, GL_LINEAR);
+            mTexture->bind();
+            gl(TexImage2D(GL_TEXTURE_2D, 0, description.format, description.width, description.height, 0, transferFormat(), transferType(), nullptr));
+        }
+
+        void attach(GLenum attachment) const
+        {
+            if (mRenderbuffer)
+            {
+                gl(FramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, mRenderbuffer->handle()));
+            }
+            else
+            {
+                gl(FramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, mTexture->handle(), 0));
+            }
+        }
+
+        sampler2D bind(GLuint slotIndex=GL_TEXTURE0) const
+        {
+            panicif(!mTexture, "a multisampled render target has to be resolved before being sampled");
+            return mTexture->bind(slotIndex);
+        }
+
+        const RenderTargetDescription &description() const { return mDescription; }
+        int width() const { return mDescription.width; }
+        int height() const { return mDescription.height; }
+        size_t byteSize() const { return mDescription.byteSize(); }
+
+    private:
+        GLenum transferFormat() const
+        {
+            if (mDescription.format == GL_DEPTH24_STENCIL8) return GL_DEPTH_STENCIL;
+            return mDescription.isDepth() ? GL_DEPTH_COMPONENT : GL_RGBA;
+        }
+
+        GLenum transferType() const
+        {
+            if (mDescription.format == GL_DEPTH24_STENCIL8) return GL_UNSIGNED_INT_24_8;
+            return mDescription.isDepth() ? GL_FLOAT : GL_UNSIGNED_BYTE;
+        }
+
+        RenderTargetDescription mDescription;
+        std::unique_ptr<Texture> mTexture;
+        std::unique_ptr<Renderbuffer> mRenderbuffer;
+    };
+
+    class Framebuffer
+    {
+    public:
+        Framebuffer() = default;
+        Framebuffer(const RenderTarget &color) { attach(GL_COLOR_ATTACHMENT0, color); }
+        Framebuffer(const RenderTarget &color, const RenderTarget &depth) { attach(GL_COLOR_ATTACHMENT0, color); attach(depthAttachment(depth), depth); }
+
+        void attach(GLenum attachment, const RenderTarget &target)
+        {
+            bind();
+            target.attach(attachment);
+            mWidth = target.width();
+            mHeight = target.height();
+            unbind();
+        }
+
+        bool isComplete() const
+        {
+            bind();
+            auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+            unbind();
+            return status == GL_FRAMEBUFFER_COMPLETE;
+        }
+
+        // Binds the framebuffer and sets the viewport to its size.
+        void bind() const { gl(BindFramebuffer(GL_FRAMEBUFFER, mHandle)); }
+        void unbind() const { gl(BindFramebuffer(GL_FRAMEBUFFER, 0)); }
+        void start() const { bind(); gl(Viewport(0, 0, mWidth, mHeight)); }
+
+        GLuint handle() const { return mHandle; }
+        int width() const { return mWidth; }
+        int height() const { return mHeight; }
+
+        // Copies the color buffer into another framebuffer, or into the window when
+        // there is none. This is also how a multisampled framebuffer is resolved.
+        void blit(const Framebuffer *destination, int width, int height, GLbitfield mask=GL_COLOR_BUFFER_BIT, GLenum filter=GL_NEAREST) const
+        {
+            gl(BindFramebuffer(GL_READ_FRAMEBUFFER, mHandle));
+            gl(BindFramebuffer(GL_DRAW_FRAMEBUFFER, destination ? destination->handle() : 0));
+            gl(BlitFramebuffer(0, 0, mWidth, mHeight, 0, 0, width, height, mask, filter));
+            gl(BindFramebuffer(GL_FRAMEBUFFER, 0));
+        }
+
+        void resolve(const Framebuffer &destination) const
+        {
+            blit(&destination, destination.width(), destination.height());
+        }
+
+        static GLenum depthAttachment(const RenderTarget &depth)
+        {
+            return depth.description().format == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        }
+
+    private:
+        static void create(GLuint &handle) { gl(GenFramebuffers(1, &handle)); }
+        static void destroy(GLuint handle) { gl(DeleteFramebuffers(1, &handle)); }
+        gl::Handle<create, destroy> mHandle;
+        int mWidth = 0, mHeight = 0;
+    };
+
+}}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <ray/platform/OpenGL.hpp>
+#include <ray/platform/Profiler.hpp>
+#include <ray/platform/Time.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if RAY_ENABLE_PROFILER
+    #define PROFILE_GPU_ZONE(profiler, name) ray::gl::GpuZone<std::remove_reference<decltype(profiler)>::type> RAY_PROFILER_CONCAT(__gpuZone__, __COUNTER__)(profiler, name)
+#else
+    #define PROFILE_GPU_ZONE(profiler, name) do {} while (0)
+#endif
+
+namespace ray { namespace gl {
+
+    // GL_TIMESTAMP queries, which unlike GL_TIME_ELAPSED ones can be nested.
+    struct TimerQueries
+    {
+        GLuint create() { GLuint query = 0; glGenQueries(1, &query); return query; }
+        void destroy(GLuint query) { glDeleteQueries(1, &query); }
+        void timestamp(GLuint query) { glQueryCounter(query, GL_TIMESTAMP); }
+        bool isAvailable(GLuint query) { GLuint available = GL_FALSE; glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available); return available != GL_FALSE; }
+        uint64_t result(GLuint query) { GLuint64 result = 0; glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result); return result; }
+
+        // NOTE(cme): the time at which the GPU gets to the commands issued so far,
+        //            not the time they complete.
+        uint64_t now() { GLint64 time = 0; glGetInteger64v(GL_TIMESTAMP, &time); return (uint64_t)time; }
+    };
+
+    // Times zones of GL commands on the GPU. Results are read back a few frames
+    // late, once the GPU is done with them, so timing never stalls the pipeline;
+    // if it falls further behind than that, the oldest frame is dropped. GPU
+    // times are moved onto the profiler's clock and show up in its trace on their
+    // own row, next to the CPU zones that issued the commands.
+    template<typename Queries>
+    class BasicGpuProfiler
+    {
+    public:
+        using ZoneStatistics = platform::Profiler::ZoneStatistics;
+
+        BasicGpuProfiler(size_t framesInFlight=4, Queries queries=Queries())
+            : mQueries(queries), mFrames(framesInFlight), mTrack(platform::Profiler::instance().addTrack("GPU"))
+        {
+            calibrate();
+        }
+
+        BasicGpuProfiler(const BasicGpuProfiler &other) = delete;
+        BasicGpuProfiler &operator=(const BasicGpuProfiler &other) = delete;
+
+        ~BasicGpuProfiler()
+        {
+            for (auto &frame : mFrames)
+                recycle(frame);
+            recycle(mCurrent);
+            for (auto query : mFreeQueries)
+                mQueries.destroy(query);
+        }
+
+        // Returns the depth of the zone, to be given back to end().
+        uint32_t begin(GLuint &query)
+        {
+            query = acquire();
+            mQueries.timestamp(query);
+            return mDepth++;
+        }
+
+        void end(const char *name, GLuint beginQuery, uint32_t depth)
+        {
+            --mDepth;
+            auto endQuery = acquire();
+            mQueries.timestamp(endQuery);
+            mCurrent.zones.push_back(Zone{ name, beginQuery, endQuery, depth });
+        }
+
+        // Queues the zones of this frame and reads back the frames the GPU is done with.
+        void endFrame()
+        {
+            collect();
+            auto &slot = mFrames[mNextFrame];
+            if (slot.isPending)
+            {
+                recycle(slot);
+                ++mDroppedFrames;
+            }
+            std::swap(slot, mCurrent);
+            slot.isPending = true;
+            slot.index = mFrameCount++;
+            mNextFrame = (mNextFrame + 1) % mFrames.size();
+
+            if (mFrameCount % CALIBRATION_PERIOD == 0)
+                calibrate();
+        }
+
+        // The last frame read back, and how many frames ago it was issued.
+        const std::vector<ZoneStatistics> &lastFrame() const { return mLastFrame; }
+        platform::sec lastFrameTime() const { return mLastFrameTime; }
+        uint64_t latency() const { return mFrameCount - mLastFrameIndex; }
+        uint64_t droppedFrames() const { return mDroppedFrames; }
+
+    private:
+        static constexpr uint64_t CALIBRATION_PERIOD = 256;
+
+        struct Zone
+        {
+            const char *name;
+            GLuint begin, end;
+            uint32_t depth;
+        };
+
+        struct Frame
+        {
+            std::vector<Zone> zones;
+            uint64_t index = 0;
+            bool isPending = false;
+        };
+
+        GLuint acquire()
+        {
+            if (mFreeQueries.empty())
+                return mQueries.create();
+            auto query = mFreeQueries.back();
+            mFreeQueries.pop_back();
+            return query;
+        }
+
+        void recycle(Frame &frame)
+        {
+            for (auto &zone : frame.zones)
+            {
+                mFreeQueries.push_back(zone.begin);
+                mFreeQueries.push_back(zone.end);
+            }
+            frame.zones.clear();
+            frame.isPending = false;
+        }
+
+        // NOTE(cme): the GPU runs frames in order, so the first one that isn't done
+        //            means none of the later ones are.
+        void collect()
+        {
+            for (size_t i = 0; i < mFrames.size(); ++i)
+            {
+                auto &frame = mFrames[(mNextFrame + i) % mFrames.size()];
+                if (!frame.isPending)
+                    continue;
+                if (!frame.zones.empty() && !mQueries.isAvailable(frame.zones.back().end))
+                    return;
+                read(frame);
+                recycle(frame);
+            }
+        }
+
+        // Zones were recorded when they ended, so children come before their parent.
+        void read(const Frame &frame)
+        {
+            std::unordered_map<const char *, size_t> indices;
+            std::vector<uint64_t> childTime;
+            uint64_t first = UINT64_MAX, last = 0;
+            mLastFrame.clear();
+
+            for (auto &zone : frame.zones)
+            {
+                auto begin = toCpuTime(mQueries.result(zone.begin));
+                auto end = std::max(begin, toCpuTime(mQueries.result(zone.end)));
+                auto duration = end - begin;
+                if (childTime.size() < zone.depth + 2)
+                    childTime.resize(zone.depth + 2, 0);
+                auto exclusive = duration > childTime[zone.depth + 1] ? duration - childTime[zone.depth + 1] : 0;
+                childTime[zone.depth + 1] = 0;
+                childTime[zone.depth] += duration;
+                first = std::min(first, begin);
+                last = std::max(last, end);
+
+                auto index = indices.find(zone.name);
+                if (index == indices.end())
+                {
+                    index = indices.emplace(zone.name, mLastFrame.size()).first;
+                    mLastFrame.push_back(ZoneStatistics{ zone.name, 0, 0, 0, 0 });
+                }
+                auto &statistics = mLastFrame[index->second];
+                statistics.calls += 1;
+                statistics.inclusive += duration;
+                statistics.exclusive += exclusive;
+                statistics.maximum = std::max(statistics.maximum, duration);
+
+                platform::Profiler::instance().addTraceEvent(mTrack, platform::Profiler::Event{ zone.name, begin, end, zone.depth });
+            }
+
+            mLastFrameTime = platform::sec(first < last ? (last - first) * 1e-9 : 0.0);
+            mLastFrameIndex = frame.index;
+        }
+
+        // NOTE(cme): both clocks tick in nanoseconds but drift apart, hence the
+        //            periodic calibration.
+        void calibrate()
+        {
+            mClockOffset = (int64_t)platform::Profiler::now() - (int64_t)mQueries.now();
+        }
+
+        uint64_t toCpuTime(uint64_t gpuTime) const { return (uint64_t)((int64_t)gpuTime + mClockOffset); }
+
+        Queries mQueries;
+        std::vector<Frame> mFrames;
+        Frame mCurrent;
+        std::vector<GLuint> mFreeQueries;
+        std::vector<ZoneStatistics> mLastFrame;
+        platform::sec mLastFrameTime = platform::sec(0.0);
+        int64_t mClockOffset = 0;
+        uint64_t mFrameCount = 0, mLastFrameIndex = 0, mDroppedFrames = 0;
+        size_t mNextFrame = 0;
+        uint32_t mDepth = 0;
+        uint32_t mTrack;
+    };
+
+    using GpuProfiler = BasicGpuProfiler<TimerQueries>;
+
+    template<typename Profiler>
+    class GpuZone
+    {
+    public:
+        GpuZone(Profiler &profiler, const char *name) : mProfiler(profiler), mName(name) { mDepth = profiler.begin(mQuery); }
+        GpuZone(const GpuZone &other) = delete;
+        GpuZone &operator=(const GpuZone &other) = delete;
+        ~GpuZone() { mProfiler.end(mName, mQuery, mDepth); }
+
+    private:
+        Profiler &mProfiler;
+        const char *mName;
+        GLuint mQuery;
+        uint32_t mDepth;
+    };
+
+}}
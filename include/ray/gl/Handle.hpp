@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ray/platform/OpenGL.hpp>
+#include <utility>
 
 namespace ray { namespace gl {
 
@@ -15,7 +16,7 @@ namespace ray { namespace gl {
         inline Handle(Handle &&other) : value(other) { other.value = 0; }
         inline ~Handle() { if (value) destroy(value); }
         inline Handle &operator=(const Handle &other) = delete;
-        inline Handle &operator=(Handle &&other) = delete;
+        inline Handle &operator=(Handle &&other) { std::swap(value, other.value); return *this; }
         inline GLuint *operator &() { return &value; }
         inline const GLuint *operator&() const { return &value; }
         inline operator Ref() { return value; }
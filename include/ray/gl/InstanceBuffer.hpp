@@ -0,0 +1,91 @@
+#pragma once
+
+#include <ray/gl/VertexArray.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include <cstring>
+
+namespace ray { namespace gl {
+
+    // NOTE(cme): matrices are row major in memory, but a matrix attribute reads one
+    //            column per location, instances must store columnMajor(matrix).
+    inline math::mat4 columnMajor(const math::mat4 &matrix) { return math::transpose(matrix); }
+
+    // Per-instance data for instanced draws. Every upload orphans the previous
+    // storage, so the frame being drawn by the GPU is never waited on.
+    template<typename T>
+    class InstanceBuffer
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "instances are copied byte for byte");
+        static_assert(sizeof(T) % sizeof(math::f32) == 0, "instances are bound as arrays of floats");
+        static constexpr size_t stride = sizeof(T) / sizeof(math::f32);
+
+    public:
+        InstanceBuffer(size_t capacity=1024) : mCapacity(capacity), mCount(0)
+        {
+            mBuffer.reserve(mCapacity*stride, GL_STREAM_DRAW);
+        }
+
+        template<typename V>
+        void bindAttribute(const VertexArray &vertexArray, Attribute<V> attribute, size_t byteOffset, GLuint divisor=1) const
+        {
+            panicif(byteOffset % sizeof(math::f32) != 0, "instance attribute at offset %d is not aligned on a float", byteOffset);
+            vertexArray.bindInstanceAttributeAtOffset((GLuint)(byteOffset / sizeof(math::f32)), attribute, mBuffer, divisor);
+        }
+
+        void load(const std::vector<T> &instances)
+        {
+            load(instances.data(), instances.size());
+        }
+
+        void load(const T *instances, size_t count)
+        {
+            auto mapped = map(count);
+            if (mapped) 
+            {
+                std::memcpy(mapped, instances, count*sizeof(T));
+                mBuffer.unmap();
+            }
+        }
+
+        // Writes toInstance(object) for every object in [first, last) straight into the buffer.
+        template<typename Iterator, typename Function>
+        size_t stream(Iterator first, Iterator last, Function toInstance)
+        {
+            auto count = (size_t)std::distance(first, last);
+            auto mapped = map(count);
+            if (mapped)
+            {
+                for (; first != last; ++first) 
+                    (*mapped++) = toInstance(*first);
+                mBuffer.unmap();
+            }
+            return count;
+        }
+
+        size_t count() const { return mCount; }
+        size_t capacity() const { return mCapacity; }
+
+    private:
+        T *map(size_t count)
+        {
+            mCount = count;
+            if (count > mCapacity)
+                mCapacity = std::max(count, 2*mCapacity);
+            if (count == 0)
+                return nullptr;
+
+            mBuffer.reserve(mCapacity*stride, GL_STREAM_DRAW);
+            auto mapped = mBuffer.mapRange(0, count*stride, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            panicif(mapped == nullptr, "could not map %d instances", count);
+            return reinterpret_cast<T*>(mapped);
+        }
+
+        VertexBuffer<math::f32, stride> mBuffer;
+        size_t mCapacity, mCount;
+    };
+
+}}
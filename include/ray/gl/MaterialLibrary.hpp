@@ -0,0 +1,125 @@
+#pragma once
+
+#include <ray/gl/TextureArray.hpp>
+#include <ray/math/LinearAlgebra.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    // A material refers to a layer of a texture array instead of a texture of its
+    // own. Objects whose materials share an array can be drawn with one texture
+    // binding, the layer and texture coordinate scale go in per instance data.
+    struct Material
+    {
+        const TextureArray *textures = nullptr;
+        uint32_t array = 0, layer = 0;
+        math::vec2 uvScale = math::vec2(1.0f, 1.0f);
+        math::vec4 color = math::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+        // Packed as (uvScale.x, uvScale.y, layer, 0) for a vec4 attribute or uniform.
+        math::vec4 layerData() const { return math::vec4(uvScale.x, uvScale.y, (float)layer, 0.0f); }
+    };
+
+    class MaterialLibrary
+    {
+        using Bitmap = assets::Bitmap;
+        using vec4 = math::vec4;
+
+    public:
+        using MaterialId = uint32_t;
+
+        struct Statistics
+        {
+            size_t materials = 0, arrays = 0, usedLayers = 0, reservedLayers = 0, bytes = 0;
+        };
+
+        MaterialLibrary(uint32_t layersPerArray=32) : mLayers(layersPerArray) {}
+
+        // Each file is only uploaded once, adding it again returns the same material.
+        MaterialId add(const std::string &filename, const vec4 &color=vec4(1.0f, 1.0f, 1.0f, 1.0f))
+        {
+            auto existing = mByFilename.find(filename);
+            if (existing != mByFilename.end())
+                return existing->second;
+            auto id = add(Bitmap(filename), color);
+            mByFilename[filename] = id;
+            return id;
+        }
+
+        MaterialId add(const assets::BitmapView &bitmap, const vec4 &color=vec4(1.0f, 1.0f, 1.0f, 1.0f))
+        {
+            bool isNewArray = false;
+            auto slot = mLayers.allocate(bitmap.width(), bitmap.height(), isNewArray);
+            auto &array = mLayers.array(slot.array);
+            if (isNewArray)
+            {
+                mArrays.emplace_back(new TextureArray(array.width, array.height, (int)mLayers.layersPerArray()));
+                mHasNewLayers.push_back(false);
+            }
+            mArrays[slot.array]->loadLayer((int)slot.layer, bitmap, false);
+            mHasNewLayers[slot.array] = true;
+
+            Material material;
+            material.textures = mArrays[slot.array].get();
+            material.array = slot.array;
+            material.layer = slot.layer;
+            material.uvScale = math::vec2((float)bitmap.width() / array.width, (float)bitmap.height() / array.height);
+            material.color = color;
+            mMaterials.push_back(material);
+            mSlots.push_back(slot);
+            return (MaterialId)(mMaterials.size() - 1);
+        }
+
+        // NOTE(cme): the id is not reused, the layer is.
+        void remove(MaterialId id)
+        {
+            panicif(id >= mSlots.size() || !mSlots[id].isValid(), "removing unknown material %d", id);
+            mLayers.free(mSlots[id]);
+            mSlots[id] = details::LayerAllocator::Slot();
+            mMaterials[id] = Material();
+            for (auto entry = mByFilename.begin(); entry != mByFilename.end();)
+                entry = entry->second == id ? mByFilename.erase(entry) : std::next(entry);
+        }
+
+        // Generates the mips of the arrays that got new layers, once after a batch of
+        // adds and before drawing with them.
+        void flush()
+        {
+            for (size_t index = 0; index < mArrays.size(); ++index)
+            {
+                if (mHasNewLayers[index])
+                    mArrays[index]->generateMipmap();
+                mHasNewLayers[index] = false;
+            }
+        }
+
+        const Material &operator[](MaterialId id) const { return mMaterials[id]; }
+        const TextureArray &array(uint32_t index) const { return *mArrays[index]; }
+        size_t arrayCount() const { return mArrays.size(); }
+
+        Statistics statistics() const
+        {
+            Statistics result;
+            for (auto &slot : mSlots)
+                result.materials += slot.isValid() ? 1 : 0;
+            result.arrays = mArrays.size();
+            result.usedLayers = mLayers.usedLayers();
+            result.reservedLayers = mArrays.size() * mLayers.layersPerArray();
+            for (auto &array : mArrays)
+                result.bytes += array->byteSize();
+            return result;
+        }
+
+    private:
+        details::LayerAllocator mLayers;
+        std::vector<std::unique_ptr<TextureArray>> mArrays;
+        std::vector<bool> mHasNewLayers;
+        std::vector<Material> mMaterials;
+        std::vector<details::LayerAllocator::Slot> mSlots;
+        std::unordered_map<std::string, MaterialId> mByFilename;
+    };
+
+}}
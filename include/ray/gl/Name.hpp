@@ -0,0 +1,74 @@
+#pragma once
+
+#include <ray/platform/Hash.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <string>
+
+namespace ray { namespace gl {
+
+    // Name of a shader variable, hashed once (at compile time when it comes from a
+    // "..."_u or "..."_a literal) so that looking it up never allocates.
+    struct Name
+    {
+        constexpr Name(const char *text, size_t length) : hash(platform::fnv1a(text, length)), text(text), length(length) {}
+        constexpr Name(const char *text) : Name(text, platform::length(text)) {}
+        Name(const std::string &text) : Name(text.c_str(), text.size()) {}
+
+        // NOTE(cme): 'text' is only borrowed, a name made from a std::string must not outlive it.
+        uint32_t hash;
+        const char *text;
+        size_t length;
+    };
+
+    struct UniformName : Name { using Name::Name; };
+    struct AttributeName : Name { using Name::Name; };
+
+    constexpr UniformName operator""_u(const char *text, size_t length) { return UniformName(text, length); }
+    constexpr AttributeName operator""_a(const char *text, size_t length) { return AttributeName(text, length); }
+
+    // Flat array of values sorted by name hash, filled once when a program is
+    // linked and then only searched. The names are copied into the table so that
+    // a hash hit can be checked against them.
+    template<typename V>
+    class NameTable
+    {
+    public:
+        struct Entry { uint32_t hash; uint32_t nameOffset, nameLength; V value; };
+
+        void add(const Name &name, const V &value)
+        {
+            auto position = std::lower_bound(mEntries.begin(), mEntries.end(), name.hash, [](const Entry &entry, uint32_t hash) { return entry.hash < hash; });
+            panicif(position != mEntries.end() && position->hash == name.hash, "hash collision on shader variable '%s'", name.text);
+            auto offset = (uint32_t)mNames.size();
+            mNames.append(name.text, name.length);
+            mEntries.insert(position, Entry{name.hash, offset, (uint32_t)name.length, value});
+        }
+
+        const V *find(const Name &name) const
+        {
+            auto first = mEntries.data();
+            auto count = mEntries.size();
+            if (count == 0) return nullptr;
+            while (count > 1)
+            {
+                auto half = count / 2;
+                first = (first[half].hash <= name.hash) ? first + half : first;
+                count -= half;
+            }
+            if (first->hash != name.hash || first->nameLength != name.length)
+                return nullptr;
+            return std::memcmp(mNames.data() + first->nameOffset, name.text, name.length) == 0 ? &first->value : nullptr;
+        }
+
+        size_t size() const { return mEntries.size(); }
+        void clear() { mEntries.clear(); mNames.clear(); }
+
+    private:
+        std::vector<Entry> mEntries;
+        std::string mNames;
+    };
+
+}}
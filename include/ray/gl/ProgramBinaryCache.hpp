@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ray/platform/OpenGL.hpp>
+#include <ray/platform/Time.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    // Keeps linked program binaries on disk, so that the next run can skip
+    // compiling and linking the shaders. Entries are keyed on the shader sources
+    // and on the driver that produced them; a binary the driver refuses to load
+    // (e.g. after a driver update) is thrown away and the program is relinked.
+    // When glGetProgramBinary is not available every lookup is a miss.
+    class ProgramBinaryCache
+    {
+    public:
+        struct Statistics
+        {
+            size_t hits = 0, misses = 0, rejected = 0;
+            platform::sec warmTime{0}, coldTime{0};
+        };
+
+        ProgramBinaryCache(const std::string &directory);
+
+        uint64_t key(const char *vertexShader, const char *fragmentShader) const;
+        bool load(GLuint program, uint64_t key);
+        void store(GLuint program, uint64_t key) const;
+        void record(bool hit, platform::sec elapsed);
+
+        bool isSupported() const { return mSupported; }
+        const Statistics &statistics() const { return mStatistics; }
+
+    private:
+        std::string path(uint64_t key) const;
+
+        std::string mDirectory;
+        uint64_t mDriverHash;
+        bool mSupported;
+        std::vector<GLint> mFormats;
+        Statistics mStatistics;
+    };
+
+}}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/platform/Panic.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    // Draw order, from the most significant bits to the least significant ones:
+    // pass (4 bits), program (12 bits), material (16 bits), texture (12 bits)
+    // and depth (20 bits). Sorting on the key groups the draws that share the
+    // most expensive state, and draws them front to back within a group.
+    struct SortKey
+    {
+        static constexpr uint64_t PASS_BITS = 4, PROGRAM_BITS = 12, MATERIAL_BITS = 16, TEXTURE_BITS = 12, DEPTH_BITS = 20;
+        static constexpr uint64_t DEPTH_SHIFT    = 0;
+        static constexpr uint64_t TEXTURE_SHIFT  = DEPTH_SHIFT + DEPTH_BITS;
+        static constexpr uint64_t MATERIAL_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+        static constexpr uint64_t PROGRAM_SHIFT  = MATERIAL_SHIFT + MATERIAL_BITS;
+        static constexpr uint64_t PASS_SHIFT     = PROGRAM_SHIFT + PROGRAM_BITS;
+        static_assert(PASS_SHIFT + PASS_BITS == 64, "sort key fields must fill 64 bits");
+
+        static constexpr uint64_t mask(uint64_t bits) { return (uint64_t(1) << bits) - 1; }
+
+        // NOTE(cme): depth is expected in [0,1], pass 1-depth to draw back to front.
+        static constexpr uint64_t quantizeDepth(float depth)
+        {
+            return depth <= 0.0f ? 0 : depth >= 1.0f ? mask(DEPTH_BITS) : uint64_t(depth * float(mask(DEPTH_BITS)));
+        }
+
+        static constexpr uint64_t encode(uint32_t pass, uint32_t program, uint32_t material, uint32_t texture, float depth)
+        {
+            return ((uint64_t(pass)     & mask(PASS_BITS))     << PASS_SHIFT)
+                 | ((uint64_t(program)  & mask(PROGRAM_BITS))  << PROGRAM_SHIFT)
+                 | ((uint64_t(material) & mask(MATERIAL_BITS)) << MATERIAL_SHIFT)
+                 | ((uint64_t(texture)  & mask(TEXTURE_BITS))  << TEXTURE_SHIFT)
+                 | (quantizeDepth(depth)                       << DEPTH_SHIFT);
+        }
+
+        static constexpr uint32_t pass(uint64_t key)     { return uint32_t((key >> PASS_SHIFT)     & mask(PASS_BITS)); }
+        static constexpr uint32_t program(uint64_t key)  { return uint32_t((key >> PROGRAM_SHIFT)  & mask(PROGRAM_BITS)); }
+        static constexpr uint32_t material(uint64_t key) { return uint32_t((key >> MATERIAL_SHIFT) & mask(MATERIAL_BITS)); }
+        static constexpr uint32_t texture(uint64_t key)  { return uint32_t((key >> TEXTURE_SHIFT)  & mask(TEXTURE_BITS)); }
+        static constexpr uint32_t depth(uint64_t key)    { return uint32_t((key >> DEPTH_SHIFT)    & mask(DEPTH_BITS)); }
+    };
+
+    namespace details
+    {
+        // LSD radix sort of (key, index) pairs, one byte at a time. Bytes that are
+        // the same for every key, such as unused passes, are skipped.
+        inline void radixSort(std::vector<uint64_t> &keys, std::vector<uint32_t> &indices, std::vector<uint64_t> &scratchKeys, std::vector<uint32_t> &scratchIndices)
+        {
+            auto count = keys.size();
+            scratchKeys.resize(count);
+            scratchIndices.resize(count);
+
+            for (uint32_t shift = 0; shift < 64; shift += 8)
+            {
+                size_t histogram[257] = {};
+                for (auto key : keys)
+                    ++histogram[((key >> shift) & 0xFF) + 1];
+                if (histogram[((keys.empty() ? 0 : keys[0]) >> shift & 0xFF) + 1] == count)
+                    continue;
+
+                for (size_t digit = 1; digit < 257; ++digit)
+                    histogram[digit] += histogram[digit-1];
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    auto destination = histogram[(keys[i] >> shift) & 0xFF]++;
+                    scratchKeys[destination] = keys[i];
+                    scratchIndices[destination] = indices[i];
+                }
+                keys.swap(scratchKeys);
+                indices.swap(scratchIndices);
+            }
+        }
+    }
+
+    // Collects the draws of a frame and issues them sorted by SortKey, only
+    // touching the program, material, texture and vertex array when they change
+    // from one draw to the next.
+    class RenderQueue
+    {
+    public:
+        using Callback = void (*)(const void *data);
+
+        struct Item
+        {
+            uint32_t pass = 0;
+            const ShaderProgram *program = nullptr;
+            uint32_t material = 0;
+            Callback applyMaterial = nullptr;   // sets the uniforms shared by every draw of the material
+            const void *materialData = nullptr;
+            GLenum textureTarget = GL_TEXTURE_2D;
+            GLuint texture = 0;                 // bound on GL_TEXTURE0
+            Callback applyUniforms = nullptr;   // sets the uniforms of this draw only
+            const void *uniformData = nullptr;
+            GLuint vertexArray = 0;
+            GLenum mode = GL_TRIANGLES;
+            GLsizei vertexCount = 0;            // drawn with glDrawArrays when there are no indices
+            GLsizei indexCount = 0;             // GL_UNSIGNED_INT indices of the vertex array's element buffer
+            size_t indexOffset = 0;             // in bytes
+            float depth = 0.0f;
+
+            bool isIndexed() const { return indexCount > 0; }
+        };
+
+        struct Statistics
+        {
+            size_t draws = 0, indexedDraws = 0, programChanges = 0, materialChanges = 0, textureChanges = 0, vertexArrayChanges = 0;
+            size_t stateChanges() const { return programChanges + materialChanges + textureChanges + vertexArrayChanges; }
+        };
+
+        void submit(const Item &item)
+        {
+            panicif(item.program == nullptr, "render queue items need a shader program");
+            auto key = SortKey::encode(item.pass, intern(mPrograms, item.program, SortKey::PROGRAM_BITS), item.material, intern(mTextures, item.texture, SortKey::TEXTURE_BITS), item.depth);
+            mIndices.push_back((uint32_t)mItems.size());
+            mKeys.push_back(key);
+            mItems.push_back(item);
+        }
+
+        void sort()
+        {
+            mUnsortedStatistics = countStateChanges();
+            details::radixSort(mKeys, mIndices, mScratchKeys, mScratchIndices);
+        }
+
+        // Sorts and draws everything submitted since the last flush.
+        void flush()
+        {
+            sort();
+            mSortedStatistics = execute();
+
+            mItems.clear();
+            mKeys.clear();
+            mIndices.clear();
+            if (mPrograms.size() >= SortKey::mask(SortKey::PROGRAM_BITS)) mPrograms.clear();
+            if (mTextures.size() >= SortKey::mask(SortKey::TEXTURE_BITS)) mTextures.clear();
+        }
+
+        // Number of state changes the items would cost in their current order.
+        Statistics countStateChanges() const
+        {
+            return visit([](const Item &, bool, bool, bool, bool) {});
+        }
+
+        const Statistics &unsortedStatistics() const { return mUnsortedStatistics; }
+        const Statistics &sortedStatistics() const { return mSortedStatistics; }
+        size_t size() const { return mItems.size(); }
+
+    private:
+        Statistics execute() const
+        {
+            auto statistics = visit([](const Item &item, bool programChanged, bool materialChanged, bool textureChanged, bool vertexArrayChanged) 
+            {
+                if (programChanged) 
+                    item.program->start();
+                if (materialChanged && item.applyMaterial) 
+                    item.applyMaterial(item.materialData);
+                if (textureChanged)
+                {
+                    gl(ActiveTexture(GL_TEXTURE0));
+                    gl(BindTexture(item.textureTarget, item.texture));
+                }
+                if (item.applyUniforms) 
+                    item.applyUniforms(item.uniformData);
+                if (vertexArrayChanged) 
+                    gl(BindVertexArray(item.vertexArray));
+                if (item.isIndexed())
+                {
+                    gl(DrawElements(item.mode, item.indexCount, GL_UNSIGNED_INT, (const GLvoid *)item.indexOffset));
+                }
+                else
+                {
+                    gl(DrawArrays(item.mode, 0, item.vertexCount));
+                }
+            });
+            gl(BindVertexArray(0));
+            return statistics;
+        }
+
+        template<typename Function>
+        Statistics visit(Function draw) const
+        {
+            Statistics statistics;
+            const Item *previous = nullptr;
+            for (auto index : mIndices)
+            {
+                auto &item = mItems[index];
+                auto programChanged     = !previous || previous->program != item.program;
+                auto materialChanged    = programChanged || previous->material != item.material || previous->materialData != item.materialData;
+                auto textureChanged     = !previous || previous->texture != item.texture || previous->textureTarget != item.textureTarget;
+                auto vertexArrayChanged = !previous || previous->vertexArray != item.vertexArray;
+
+                statistics.draws += 1;
+                statistics.indexedDraws += item.isIndexed();
+                statistics.programChanges += programChanged;
+                statistics.materialChanges += materialChanged;
+                statistics.textureChanges += textureChanged;
+                statistics.vertexArrayChanges += vertexArrayChanged;
+                draw(item, programChanged, materialChanged, textureChanged, vertexArrayChanged);
+                previous = &item;
+            }
+            return statistics;
+        }
+
+        // NOTE(cme): ids are handed out in order of first use and kept across frames.
+        //            Once a field of the key runs out of bits, the values left share
+        //            the last id until the next flush resets the ids, so those queued
+        //            already keep theirs.
+        template<typename T>
+        static uint32_t intern(std::unordered_map<T, uint32_t> &ids, const T &value, uint64_t bits)
+        {
+            auto hit = ids.find(value);
+            if (hit != ids.end()) 
+                return hit->second;
+            auto id = (uint32_t)ids.size();
+            if (id >= SortKey::mask(bits))
+                return (uint32_t)SortKey::mask(bits);
+            ids.emplace(value, id);
+            return id;
+        }
+
+        std::vector<Item> mItems;
+        std::vector<uint64_t> mKeys, mScratchKeys;
+        std::vector<uint32_t> mIndices, mScratchIndices;
+        std::unordered_map<const ShaderProgram *, uint32_t> mPrograms;
+        std::unordered_map<GLuint, uint32_t> mTextures;
+        Statistics mUnsortedStatistics, mSortedStatistics;
+    };
+
+}}
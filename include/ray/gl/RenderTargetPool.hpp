@@ -0,0 +1,127 @@
+#pragma once
+
+#include <ray/gl/Framebuffer.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    // Hands out transient render targets by description and recycles them across
+    // frames, so post effects don't allocate textures every frame or on every
+    // resize. Targets are only borrowed for the current frame: beginFrame() takes
+    // them all back, and destroys the ones nobody asked for in a while.
+    template<typename Target>
+    class BasicRenderTargetPool
+    {
+    public:
+        struct Statistics
+        {
+            size_t targets = 0, targetsInUse = 0;
+            size_t bytes = 0, bytesInUse = 0, peakBytes = 0;
+            size_t allocations = 0, reuses = 0, evictions = 0;
+        };
+
+        BasicRenderTargetPool(uint32_t maximumIdleFrames=3) : mMaximumIdleFrames(maximumIdleFrames) {}
+
+        void beginFrame()
+        {
+            ++mFrame;
+            for (auto entry = mEntries.begin(); entry != mEntries.end();)
+            {
+                entry->isInUse = false;
+                if (mFrame - entry->lastUsedFrame <= mMaximumIdleFrames)
+                {
+                    ++entry;
+                    continue;
+                }
+                mStatistics.bytes -= entry->target->byteSize();
+                ++mStatistics.evictions;
+                entry = mEntries.erase(entry);
+            }
+        }
+
+        Target &acquire(const RenderTargetDescription &description)
+        {
+            for (auto &entry : mEntries)
+            {
+                if (!entry.isInUse && entry.target->description() == description)
+                {
+                    ++mStatistics.reuses;
+                    return use(entry);
+                }
+            }
+
+            mEntries.push_back(Entry{ std::unique_ptr<Target>(new Target(description)), false, mFrame });
+            ++mStatistics.allocations;
+            mStatistics.bytes += mEntries.back().target->byteSize();
+            mStatistics.peakBytes = std::max(mStatistics.peakBytes, mStatistics.bytes);
+            return use(mEntries.back());
+        }
+
+        Target &acquire(int width, int height, GLenum format=GL_RGBA8, int samples=1)
+        {
+            RenderTargetDescription description;
+            description.width = width;
+            description.height = height;
+            description.format = format;
+            description.samples = samples;
+            return acquire(description);
+        }
+
+        // Gives a target back before the end of the frame, so that a later pass of
+        // the same frame can reuse it.
+        void release(const Target &target)
+        {
+            for (auto &entry : mEntries)
+                if (entry.target.get() == &target)
+                    entry.isInUse = false;
+        }
+
+        // Destroys every target, e.g. when the context goes away.
+        void clear()
+        {
+            mStatistics.evictions += mEntries.size();
+            mStatistics.bytes = 0;
+            mEntries.clear();
+        }
+
+        Statistics statistics() const
+        {
+            auto result = mStatistics;
+            result.targets = mEntries.size();
+            for (auto &entry : mEntries)
+            {
+                if (!entry.isInUse)
+                    continue;
+                ++result.targetsInUse;
+                result.bytesInUse += entry.target->byteSize();
+            }
+            return result;
+        }
+
+    private:
+        struct Entry
+        {
+            std::unique_ptr<Target> target;
+            bool isInUse;
+            uint64_t lastUsedFrame;
+        };
+
+        Target &use(Entry &entry)
+        {
+            entry.isInUse = true;
+            entry.lastUsedFrame = mFrame;
+            return *entry.target;
+        }
+
+        uint32_t mMaximumIdleFrames;
+        uint64_t mFrame = 0;
+        std::vector<Entry> mEntries;
+        Statistics mStatistics;
+    };
+
+    using RenderTargetPool = BasicRenderTargetPool<RenderTarget>;
+
+}}
@@ -17,11 +17,23 @@ namespace ray { namespace gl {
 
         void loadSource(const std::string &shaderText)
         {
-            GLint success;
+            compile(shaderText);
+            checkCompileStatus();
+        }
+
+        // NOTE(cme): compile() only queues the work, the driver is free to compile in the
+        //            background until the status is queried by checkCompileStatus().
+        void compile(const std::string &shaderText) const
+        {
             const GLchar *sources[] = { shaderText.c_str() };
     
             gl(ShaderSource(mHandle, 1, sources, NULL));
             gl(CompileShader(mHandle));
+        }
+
+        void checkCompileStatus() const
+        {
+            GLint success;
             gl(GetShaderiv(mHandle, GL_COMPILE_STATUS, &success));
     
             if (!success)
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/platform/OpenGL.hpp>
+#include <functional>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    // Submits a batch of programs up front and finalizes them as they become
+    // ready, so that the driver compiles while the application loads its assets.
+    // With KHR_parallel_shader_compile, poll() only finalizes the programs the
+    // driver reports as complete and never blocks; without it, poll() finalizes
+    // one program per call. The programs must not move until they are finalized.
+    class ShaderCompiler
+    {
+    public:
+        using ReadyCallback = std::function<void(ShaderProgram &)>;
+
+        ShaderCompiler() : mCache(nullptr) { initialize(); }
+        ShaderCompiler(ProgramBinaryCache &cache) : mCache(&cache) { initialize(); }
+
+        void submit(ShaderProgram &program, const char *vertexShader, const char *fragmentShader, ReadyCallback onReady = nullptr)
+        {
+            if (mCache)
+                program.submit(vertexShader, fragmentShader, *mCache);
+            else
+                program.submit(vertexShader, fragmentShader);
+
+            if (program.isPending())
+                mPending.push_back(Pending{&program, std::move(onReady)});
+            else if (onReady)
+                onReady(program);
+        }
+
+        size_t poll()
+        {
+            for (size_t index = 0; index < mPending.size(); )
+            {
+                if (mParallel && !mPending[index].program->isLinkComplete())
+                {
+                    ++index;
+                    continue;
+                }
+
+                auto pending = std::move(mPending[index]);
+                mPending.erase(mPending.begin() + (std::ptrdiff_t)index);
+                pending.program->finalize();
+                if (pending.onReady) 
+                    pending.onReady(*pending.program);
+                
+                if (!mParallel) 
+                    break;
+            }
+            return mPending.size();
+        }
+
+        void finish()
+        {
+            while (!mPending.empty())
+            {
+                auto pending = std::move(mPending.front());
+                mPending.erase(mPending.begin());
+                pending.program->finalize();
+                if (pending.onReady) 
+                    pending.onReady(*pending.program);
+            }
+        }
+
+        size_t pending() const { return mPending.size(); }
+        bool isParallel() const { return mParallel; }
+
+    private:
+        struct Pending
+        {
+            ShaderProgram *program;
+            ReadyCallback onReady;
+        };
+
+        void initialize()
+        {
+            mParallel = platform::hasOpenGLExtension("GL_KHR_parallel_shader_compile") || platform::hasOpenGLExtension("GL_ARB_parallel_shader_compile");
+            if (mParallel)
+                gl(MaxShaderCompilerThreadsKHR(0xFFFFFFFFu));
+        }
+
+        ProgramBinaryCache *mCache;
+        std::vector<Pending> mPending;
+        bool mParallel;
+    };
+
+}}
@@ -5,28 +5,83 @@
 #include <ray/gl/Attribute.hpp>
 #include <ray/gl/Shader.hpp>
 #include <ray/gl/Uniform.hpp>
+#include <ray/gl/UniformBlock.hpp>
 #include <ray/gl/Type.hpp>
-#include <unordered_map>
+#include <ray/gl/Name.hpp>
+#include <ray/gl/ProgramBinaryCache.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 namespace ray { namespace gl {
 
     class ShaderProgram 
     {
+        struct Variable { GLint location; GLenum type; };
+
     public:
         ShaderProgram() = default;
         ShaderProgram(const char *vertexShader, const char *fragmentShader) 
         {
             load(vertexShader, fragmentShader);
         }
+        ShaderProgram(const char *vertexShader, const char *fragmentShader, ProgramBinaryCache &cache) 
+        {
+            load(vertexShader, fragmentShader, cache);
+        }
 
         void load(const char *vertexShader, const char *fragmentShader)
         {
-            attach(VertexShader(vertexShader));
-            attach(FragmentShader(fragmentShader));
-            link();
+            submit(vertexShader, fragmentShader);
+            finalize();
+            start();
+        }
+
+        void load(const char *vertexShader, const char *fragmentShader, ProgramBinaryCache &cache)
+        {
+            submit(vertexShader, fragmentShader, cache);
+            if (isPending()) 
+                finalize();
             start();
         }
 
+        // Queues the compilation and the link without waiting for either of them. The
+        // program can be used once finalize() has checked the results, see ShaderCompiler
+        // for polling a batch of programs. A program found in the cache is linked right away.
+        void submit(const char *vertexShader, const char *fragmentShader) { submit(vertexShader, fragmentShader, nullptr); }
+        void submit(const char *vertexShader, const char *fragmentShader, ProgramBinaryCache &cache) { submit(vertexShader, fragmentShader, &cache); }
+
+        bool isPending() const { return mPending != nullptr; }
+        bool isLinked() const { return mLinked; }
+
+        // NOTE(cme): only valid when KHR_parallel_shader_compile is supported, otherwise
+        //            there is no way to know whether finalize() is going to block.
+        bool isLinkComplete() const
+        {
+            GLint complete = GL_FALSE;
+            gl(GetProgramiv(mHandle, GL_COMPLETION_STATUS_KHR, &complete));
+            return complete == GL_TRUE;
+        }
+
+        void finalize()
+        {
+            panicif(!isPending(), "program must be submitted before being finalized");
+            platform::Stopwatch stopwatch;
+
+            mPending->vertexShader->checkCompileStatus();
+            mPending->fragmentShader->checkCompileStatus();
+            checkLinkStatus();
+            reflect();
+
+            if (mPending->cache)
+            {
+                mPending->cache->store(mHandle, mPending->key);
+                mPending->cache->record(false, mPending->elapsed + stopwatch.lap());
+            }
+            mPending.reset();
+        }
+
         void start() const { gl(UseProgram(mHandle)); }
         void stop()  const { gl(UseProgram(0)); }
         
@@ -38,9 +93,123 @@ namespace ray { namespace gl {
 
         void link()
         {
-            GLint success;
+            gl(LinkProgram(mHandle));
+            checkLinkStatus();
+            reflect();
+        }
+
+        template<typename T>
+        auto getUniform(const UniformName &name) const
+        {
+            panicif(!mLinked, "uniforms must be bound after the program has been linked");
+            auto hit = mUniforms.find(name);
+            panicif(hit == nullptr, "cannot find location of uniform '%s'", name.text);
             
+            auto typeInShaderCode = hit->type;
+            auto typeInCPPCode    = getType<T>();
+            if (typeInShaderCode != typeInCPPCode) 
+            {
+                auto cppName = getTypeName(typeInCPPCode);
+                auto shaderName = getTypeName(typeInShaderCode);
+                panic("type mismatch: uniform '%s' is declared as '%s', but in shader code, it is declared as '%s'", name.text, cppName, shaderName);
+            }
+
+            return Uniform<T>{hit->location};
+        }
+
+        template<typename V>
+        auto getAttribute(const AttributeName &name) const
+        {            
+            panicif(!mLinked, "program should be linked before attempting to get an attribute");
+            auto hit = mAttributes.find(name);
+            panicif(hit == nullptr, "cannot find location of attribute '%s'", name.text);
+
+            auto typeInShaderCode = hit->type;
+            auto typeInCPPCode    = getType<V>();
+            if (typeInShaderCode != typeInCPPCode) 
+            {
+                auto cppName = getTypeName(typeInCPPCode);
+                auto shaderName = getTypeName(typeInShaderCode);
+                panic("type mismatch: attribute '%s' is declared as '%s', but in shader code, it is declared as '%s'", name.text, cppName, shaderName);
+            }
+
+            return Attribute<V>{hit->location};
+        }
+
+        template<typename S>
+        void bindUniformBlock(const std::string &name, const UniformBlock<S> &block) const
+        {
+            using Layout = typename UniformBlock<S>::Layout;
+
+            panicif(!mLinked, "uniform blocks must be bound after the program has been linked");
+            auto blockIndex = glGetUniformBlockIndex(mHandle, name.c_str());
+            panicif(blockIndex == GL_INVALID_INDEX, "cannot find uniform block '%s'", name);
+
+            GLint dataSize = 0, memberCount = 0;
+            gl(GetActiveUniformBlockiv(mHandle, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize));
+            gl(GetActiveUniformBlockiv(mHandle, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &memberCount));
+
+            auto expectedSize = Layout::size();
+            if ((size_t)dataSize < expectedSize || (size_t)dataSize > std140::details::roundUp(expectedSize, 16))
+                panic("size mismatch: uniform block '%s' is %d bytes in C++ code, but %d bytes in shader code", name, expectedSize, dataSize);
+            if ((size_t)memberCount != Layout::count())
+                panic("member count mismatch: uniform block '%s' has %d members in C++ code, but %d members in shader code", name, Layout::count(), memberCount);
+
+            std::vector<GLint> memberIndices(memberCount), memberOffsets(memberCount);
+            gl(GetActiveUniformBlockiv(mHandle, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, memberIndices.data()));
+            gl(GetActiveUniformsiv(mHandle, memberCount, reinterpret_cast<const GLuint*>(memberIndices.data()), GL_UNIFORM_OFFSET, memberOffsets.data()));
+            std::sort(memberOffsets.begin(), memberOffsets.end());
+
+            for (size_t member = 0; member < Layout::count(); ++member)
+            {
+                if ((size_t)memberOffsets[member] != Layout::offset(member))
+                    panic("layout mismatch: member %d of uniform block '%s' is at offset %d in C++ code, but at offset %d in shader code", member, name, Layout::offset(member), memberOffsets[member]);
+            }
+
+            gl(UniformBlockBinding(mHandle, blockIndex, block.bindingPoint()));
+        }
+
+    private:
+        struct PendingLink
+        {
+            std::unique_ptr<VertexShader> vertexShader;
+            std::unique_ptr<FragmentShader> fragmentShader;
+            ProgramBinaryCache *cache;
+            uint64_t key;
+            platform::sec elapsed;
+        };
+
+        void submit(const char *vertexShader, const char *fragmentShader, ProgramBinaryCache *cache)
+        {
+            panicif(isPending(), "program has already been submitted");
+            platform::Stopwatch stopwatch;
+            uint64_t key = 0;
+
+            if (cache)
+            {
+                key = cache->key(vertexShader, fragmentShader);
+                if (cache->load(mHandle, key))
+                {
+                    reflect();
+                    cache->record(true, stopwatch.lap());
+                    return;
+                }
+                if (cache->isSupported())
+                    gl(ProgramParameteri(mHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+            }
+
+            mPending.reset(new PendingLink{ std::make_unique<VertexShader>(), std::make_unique<FragmentShader>(), cache, key, platform::sec(0) });
+            mPending->vertexShader->compile(vertexShader);
+            mPending->fragmentShader->compile(fragmentShader);
+            attach(*mPending->vertexShader);
+            attach(*mPending->fragmentShader);
             gl(LinkProgram(mHandle));
+            mPending->elapsed = stopwatch.lap();
+        }
+
+        void checkLinkStatus() const
+        {
+            GLint success;
             gl(GetProgramiv(mHandle, GL_LINK_STATUS, &success));
     
             if (!success)
@@ -49,7 +218,13 @@ namespace ray { namespace gl {
                 gl(GetProgramInfoLog(mHandle, sizeof(errorMessage), NULL, errorMessage));
                 panic("could not link shader program: %s", errorMessage);
             }
-            
+        }
+
+        void reflect()
+        {
+            mUniforms.clear();
+            mAttributes.clear();
+
             GLint uniformCount = 0;
             gl(GetProgramiv(mHandle, GL_ACTIVE_UNIFORMS, &uniformCount));
 
@@ -62,8 +237,7 @@ namespace ray { namespace gl {
                 gl(GetActiveUniform(mHandle, (GLuint)uniformIndex, sizeof(uniformName), nullptr, &uniformSize, &uniformType, uniformName));
                 auto uniformLocation = glGetUniformLocation(mHandle, uniformName);
     
-                mUniformTypesByLocation[uniformLocation] = uniformType;
-                mUniformLocationByName[uniformName] = uniformLocation;
+                mUniforms.add(uniformName, Variable{uniformLocation, uniformType});
             }
 
             GLint attributeCount = 0;
@@ -78,57 +252,17 @@ namespace ray { namespace gl {
                 gl(GetActiveAttrib(mHandle, (GLuint)attributeIndex, sizeof(attributeName), nullptr, &attributeSize, &attributeType, attributeName));
                 auto attributeLocation = glGetAttribLocation(mHandle, attributeName);
 
-                mAttributeTypesByLocation[attributeLocation] = attributeType;
-                mAttributeLocationByName[attributeName] = attributeLocation;
+                mAttributes.add(attributeName, Variable{attributeLocation, attributeType});
             }
 
-            mLinked = true;                        
+            mLinked = true;
         }
 
-        template<typename T>
-        auto getUniform(const std::string &name) const
-        {
-            panicif(!mLinked, "uniforms must be bound after the program has been linked");
-            auto hit = mUniformLocationByName.find(name);
-            panicif(hit == mUniformLocationByName.end(), "cannot find location of uniform '%s'", name);
-            
-            auto typeInShaderCode = mUniformTypesByLocation.at(hit->second);
-            auto typeInCPPCode    = getType<T>();
-            if (typeInShaderCode != typeInCPPCode) 
-            {
-                auto cppName = getTypeName(typeInCPPCode);
-                auto shaderName = getTypeName(typeInShaderCode);
-                panic("type mismatch: uniform '%s' is declared as '%s', but in shader code, it is declared as '%s'", name, cppName, shaderName);
-            }
-
-            return Uniform<T>{hit->second};
-        }
-
-        template<typename V>
-        auto getAttribute(const std::string &name) const
-        {            
-            panicif(!mLinked, "program should be linked before attempting to get an attribute");
-            auto hit = mAttributeLocationByName.find(name);
-            panicif(hit == mAttributeLocationByName.end(), "cannot find location of attribute '%s'", name);
-
-            auto typeInShaderCode = mAttributeTypesByLocation.at(hit->second);
-            auto typeInCPPCode    = getType<V>();
-            if (typeInShaderCode != typeInCPPCode) 
-            {
-                auto cppName = getTypeName(typeInCPPCode);
-                auto shaderName = getTypeName(typeInShaderCode);
-                panic("type mismatch: attribute '%s' is declared as '%s', but in shader code, it is declared as '%s'", name, cppName, shaderName);
-            }
-
-            return Attribute<V>{glGetAttribLocation(mHandle, name.c_str())};
-        }
-
-    private:
         static void create(GLuint &handle) { handle = glCreateProgram(); }
         static void destroy(GLuint handle) { gl(DeleteProgram(handle)); }
         Handle<create, destroy> mHandle;
-        std::unordered_map<GLint, GLenum> mUniformTypesByLocation, mAttributeTypesByLocation;
-        std::unordered_map<std::string, GLint> mUniformLocationByName, mAttributeLocationByName;
+        NameTable<Variable> mUniforms, mAttributes;
+        std::unique_ptr<PendingLink> mPending;
         bool mLinked=false;
     };
 
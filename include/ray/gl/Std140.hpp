@@ -0,0 +1,93 @@
+#pragma once
+
+#include <ray/math/LinearAlgebra.hpp>
+#include <cstddef>
+
+namespace ray { namespace gl { namespace std140 {
+
+    namespace details
+    {
+        constexpr size_t roundUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+        // NOTE(cme): no rule for mat3 on purpose, it is packed in C++ but each column
+        //            is padded to a vec4 in std140, use a mat4 instead.
+        template<typename T> struct Rules { };
+        template<> struct Rules<math::f32>   { static constexpr size_t alignment = 4,  size = 4;  };
+        template<> struct Rules<math::i32>   { static constexpr size_t alignment = 4,  size = 4;  };
+        template<> struct Rules<math::u32>   { static constexpr size_t alignment = 4,  size = 4;  };
+        template<> struct Rules<math::vec2>  { static constexpr size_t alignment = 8,  size = 8;  };
+        template<> struct Rules<math::ivec2> { static constexpr size_t alignment = 8,  size = 8;  };
+        template<> struct Rules<math::vec3>  { static constexpr size_t alignment = 16, size = 12; };
+        template<> struct Rules<math::ivec3> { static constexpr size_t alignment = 16, size = 12; };
+        template<> struct Rules<math::vec4>  { static constexpr size_t alignment = 16, size = 16; };
+        template<> struct Rules<math::ivec4> { static constexpr size_t alignment = 16, size = 16; };
+        template<> struct Rules<math::mat4>  { static constexpr size_t alignment = 16, size = 64; };
+
+        template<typename T, size_t N>
+        struct Rules<T[N]>
+        {
+            static constexpr size_t stride = roundUp(Rules<T>::size, 16);
+            static constexpr size_t alignment = roundUp(Rules<T>::alignment, 16);
+            static constexpr size_t size = N * stride;
+        };
+    }
+
+    // Where the members of a block actually are, in declaration order. Blocks list
+    // them in a static member function, where the struct is already complete:
+    //
+    //     static constexpr auto offsets() { return std140::offsets(offsetof(Block, a), offsetof(Block, b)); }
+    template<size_t N>
+    struct Offsets
+    {
+        size_t values[N];
+    };
+
+    template<typename... T>
+    constexpr Offsets<sizeof...(T)> offsets(T... values) { return Offsets<sizeof...(T)>{{ static_cast<size_t>(values)... }}; }
+
+    // Describes the members of a uniform block, in declaration order, and computes
+    // where std140 expects each of them to be.
+    template<typename... Members>
+    struct Layout
+    {
+        static_assert(sizeof...(Members) > 0, "a uniform block needs at least one member");
+
+        static constexpr size_t count() { return sizeof...(Members); }
+
+        static constexpr size_t offset(size_t index)
+        {
+            const size_t alignments[] = { details::Rules<Members>::alignment... };
+            const size_t sizes[] = { details::Rules<Members>::size... };
+            size_t result = 0;
+            for (size_t member = 0; member < index; ++member)
+                result = details::roundUp(result, alignments[member]) + sizes[member];
+            return details::roundUp(result, alignments[index]);
+        }
+
+        static constexpr size_t size()
+        {
+            const size_t sizes[] = { details::Rules<Members>::size... };
+            return offset(count()-1) + sizes[count()-1];
+        }
+
+        template<typename... Offsets>
+        static constexpr bool matches(Offsets... offsets)
+        {
+            if (sizeof...(Offsets) != count()) return false;
+            const size_t actual[] = { static_cast<size_t>(offsets)... };
+            for (size_t member = 0; member < count(); ++member)
+                if (actual[member] != offset(member)) return false;
+            return true;
+        }
+
+        template<size_t N>
+        static constexpr bool matches(const Offsets<N> &offsets)
+        {
+            if (N != count()) return false;
+            for (size_t member = 0; member < count(); ++member)
+                if (offsets.values[member] != offset(member)) return false;
+            return true;
+        }
+    };
+
+}}}
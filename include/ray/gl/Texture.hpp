@@ -1,7 +1,11 @@
 #pragma once
 
 #include <ray/gl/AbstractTexture.hpp>
-#include <ray/assets/Bitmap.hpp>
+#include <ray/assets/BitmapView.hpp>
+#include <ray/assets/Cooked.hpp>
+#include <ray/assets/PixelPool.hpp>
+#include <ray/platform/Registry.hpp>
+#include <memory>
 #include <string>
 
 namespace ray { namespace gl {
@@ -12,6 +16,7 @@ namespace ray { namespace gl {
     {
     protected:
         using Bitmap = assets::Bitmap;
+        using BitmapView = assets::BitmapView;
         using Color = assets::Color;
         using u8 = unsigned char;
 
@@ -20,7 +25,7 @@ namespace ray { namespace gl {
         Texture(int width, int height, int depth, u8* pixels=nullptr) : Texture() { load(width, height, depth, pixels); }
         Texture(int width, int height, int depth, const Color &color) : Texture() { load(width, height, depth, color); }        
         Texture(const char *filename) : Texture() { load(filename); }
-        Texture(const Bitmap &bitmap) : Texture() { load(bitmap); }
+        Texture(const BitmapView &bitmap) : Texture() { load(bitmap); }
         Texture(const Color &color)   : Texture() { load(color); }
         Texture(const Texture &other) = delete;
         Texture(Texture &&other) = default;
@@ -28,15 +33,59 @@ namespace ray { namespace gl {
         Texture &operator=(const Texture &other) = delete;
         Texture &operator=(Texture &&other) = default;
 
-        void load(const std::string &filename) const { load(Bitmap(filename)); }
-        void load(const Bitmap &bitmap)        const { load(bitmap.width(), bitmap.height(), bitmap.depth(), bitmap.pixels()); }
-        void load(const Color &color)    const { load(Bitmap(1, 1, 4, color)); }
-        void load(int width, int height, int depth, const Color &color)    const { load(Bitmap(width, height, depth, color)); }        
+        // Prefers the cooked texture, with its mips, when there is one.
+        void load(const std::string &filename) const 
+        {
+            auto cooked = assets::cooked::find(assets::cooked::texturePath(filename));
+            if (!cooked.empty())
+                load(assets::CookedTexture(cooked));
+            else
+                load(Bitmap(filename));
+        }
+
+        // Compressed levels the driver can't sample are decoded first.
+        void load(const assets::CookedTexture &texture) const
+        {
+            auto format = texture.format();
+            for (int level = 0; level < texture.levelCount(); ++level)
+            {
+                auto mip = texture.level(level);
+                if (format == assets::TextureFormat::Uncompressed)
+                    loadLevel(level, mip.width, mip.height, texture.depth(), mip.pixels);
+                else if (supportsCompression(format))
+                    loadCompressedLevel(level, mip.width, mip.height, format, mip.pixels, mip.size);
+                else
+                {
+                    auto decoded = assets::bc::decode(mip.pixels, format, mip.width, mip.height);
+                    loadLevel(level, decoded.width(), decoded.height(), decoded.depth(), decoded.pixels());
+                }
+            }
+            setLevelCount(texture.levelCount());
+        }
+
+        // Encodes the bitmap and its mips to the block format that fits its channels.
+        void loadCompressed(const BitmapView &bitmap, platform::JobSystem *jobs=nullptr) const
+        {
+            assets::cooked::TextureOptions options;
+            options.compress = true;
+            options.jobs = jobs;
+            load(assets::CookedTexture(platform::fs::FileData(assets::cooked::cookTexture(bitmap, options))));
+        }
+
+        void load(const BitmapView &bitmap)    const { AbstractTexture::load(bitmap, GL_TEXTURE_2D); }
+        void load(const Color &color)    const { load(1, 1, 4, &color.r); }
+        void load(int width, int height, int depth, const Color &color) const
+        {
+            // NOTE(cme): only needed until GL has it, the pool takes it back right after.
+            auto bitmap = Bitmap(width, height, depth, Bitmap::Stride::Tight, &assets::PixelPool::shared());
+            bitmap.fill(color);
+            load(bitmap);
+        }
         void load(int width, int height, int depth, const GLubyte *pixels) const { AbstractTexture::load(width, height, depth, pixels, GL_TEXTURE_2D); }
         
         void loadAt(int x, int y, const std::string &filename) const { loadAt(x, y, Bitmap(filename)); }
-        void loadAt(int x, int y, const Bitmap &bitmap)        const { loadAt(x, y, bitmap.width(), bitmap.height(), bitmap.depth(), bitmap.pixels()); }
-        void loadAt(int x, int y, int width, int height, int depth, const GLubyte *pixels) const;
+        void loadAt(int x, int y, const BitmapView &bitmap) const;
+        void loadAt(int x, int y, int width, int height, int depth, const GLubyte *pixels) const { loadAt(x, y, BitmapView(pixels, width, height, depth)); }
 
         void resize(int width, int height, int depth) const { load(width, height, depth, nullptr); }
         
@@ -47,6 +96,20 @@ namespace ray { namespace gl {
         int size()   const { return stride() * depth(); }
         
         int  getParameter(GLenum parameter) const;    
+
+        // Loads the file once and shares the texture with every other user of it.
+        static std::shared_ptr<Texture> shared(const std::string &filename)
+        {
+            return registry().acquire(filename, [&]() { return Texture(filename.c_str()); });
+        }
+
+        // NOTE(cme): sizes are estimated as RGBA with a full mip chain, which is what
+        //            most drivers allocate regardless of the number of channels.
+        static platform::Registry<Texture> &registry()
+        {
+            static platform::Registry<Texture> instance([](const Texture &texture) { return (size_t)texture.width() * texture.height() * 4 * 4 / 3; });
+            return instance;
+        }
     };
 
 }}
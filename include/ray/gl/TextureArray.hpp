@@ -0,0 +1,188 @@
+#pragma once
+
+#include <ray/gl/AbstractTexture.hpp>
+#include <ray/assets/BitmapView.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    using sampler2DArray = sampler<GL_TEXTURE_2D_ARRAY>;
+
+    namespace details
+    {
+        // Copies the bitmap in the bottom left corner of a width x height layer and
+        // repeats its last column and row over the rest, so that neither filtering
+        // nor the lower mips read texels the bitmap doesn't cover.
+        inline std::vector<uint8_t> padToLayer(const assets::BitmapView &bitmap, int width, int height)
+        {
+            panicif(bitmap.width() <= 0 || bitmap.height() <= 0, "cannot pad an empty bitmap");
+            auto depth = (size_t)bitmap.depth();
+            std::vector<uint8_t> result((size_t)width * height * depth);
+            for (int y = 0; y < height; ++y)
+            {
+                auto source = bitmap.row(std::min(y, bitmap.height() - 1));
+                auto destination = &result[(size_t)y * width * depth];
+                std::memcpy(destination, source, bitmap.width() * depth);
+                auto last = source + (bitmap.width() - 1) * depth;
+                for (int x = bitmap.width(); x < width; ++x)
+                    std::memcpy(destination + x * depth, last, depth);
+            }
+            return result;
+        }
+    }
+
+    // A stack of same-sized RGBA layers sampled with a sampler2DArray, so draws that
+    // use different images from the same array don't need a texture switch.
+    class TextureArray : public AbstractTexture<GL_TEXTURE_2D_ARRAY>
+    {
+    protected:
+        using Bitmap = assets::Bitmap;
+
+    public:
+        TextureArray(int width, int height, int layers) : mWidth(width), mHeight(height), mLayers(layers)
+        {
+            // NOTE(cme): a layer can be larger than its image, uvs are scaled down to the
+            //            image and would repeat the padding. Tile with fract(uv) * uvScale.
+            setWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+            setFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+            bind();
+            gl(TexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        }
+
+        TextureArray(const TextureArray &other) = delete;
+        TextureArray(TextureArray &&other) = default;
+
+        // NOTE(cme): smaller bitmaps land in the bottom left corner of the layer, padded
+        //            with their edges, the material scales the texture coordinates accordingly.
+        //            When loading several layers, generate the mips once after the last one.
+        void loadLayer(int layer, const assets::BitmapView &bitmap, bool generateMipmap=true) const
+        {
+            panicif(layer < 0 || layer >= mLayers, "layer %d out of a texture array of %d layers", layer, mLayers);
+            panicif(bitmap.width() > mWidth || bitmap.height() > mHeight, "%dx%d bitmap does not fit in a %dx%d layer", bitmap.width(), bitmap.height(), mWidth, mHeight);
+
+            std::vector<uint8_t> padded;
+            auto view = bitmap;
+            if (bitmap.width() < mWidth || bitmap.height() < mHeight)
+            {
+                padded = details::padToLayer(bitmap, mWidth, mHeight);
+                view = assets::BitmapView(padded.data(), mWidth, mHeight, bitmap.depth());
+            }
+
+            bind();
+            {
+                details::UnpackRows rows(view);
+                gl(TexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, view.width(), view.height(), 1, getFormat(view.depth()), GL_UNSIGNED_BYTE, view.pixels()));
+            }
+            if (generateMipmap)
+                this->generateMipmap();
+        }
+
+        void generateMipmap() const
+        {
+            bind();
+            gl(GenerateMipmap(GL_TEXTURE_2D_ARRAY));
+        }
+
+        int width()  const { return mWidth; }
+        int height() const { return mHeight; }
+        int layers() const { return mLayers; }
+        size_t byteSize() const { return (size_t)mWidth * mHeight * mLayers * 4 * 4 / 3; }
+
+    private:
+        static GLenum getFormat(int depth)
+        {
+            switch(depth)
+            {
+            case 3: return GL_RGB;
+            case 4: return GL_RGBA;
+            default: panic("texture arrays only take RGB or RGBA bitmaps, not '%d' channels", depth);
+            }
+        }
+
+        int mWidth, mHeight, mLayers;
+    };
+
+    namespace details
+    {
+        // Hands out layers of fixed-size arrays, grouped by size classes of power of
+        // two extents. Knows nothing about OpenGL so that the policy can be tested.
+        class LayerAllocator
+        {
+        public:
+            struct Slot
+            {
+                uint32_t array = UINT32_MAX, layer = 0;
+                bool isValid() const { return array != UINT32_MAX; }
+            };
+
+            struct Array
+            {
+                int width, height;
+                std::vector<uint32_t> freeLayers;
+            };
+
+            LayerAllocator(uint32_t layersPerArray, int minimumExtent=16) : mLayersPerArray(layersPerArray), mMinimumExtent(minimumExtent) {}
+
+            static int sizeClass(int extent, int minimumExtent)
+            {
+                int result = minimumExtent;
+                while (result < extent) result *= 2;
+                return result;
+            }
+
+            // Returns the slot and whether it comes from a new array the caller has to create.
+            Slot allocate(int width, int height, bool &isNewArray)
+            {
+                auto classWidth = sizeClass(width, mMinimumExtent), classHeight = sizeClass(height, mMinimumExtent);
+                Slot slot;
+                isNewArray = false;
+                for (uint32_t index = 0; index < mArrays.size() && !slot.isValid(); ++index)
+                {
+                    auto &array = mArrays[index];
+                    if (array.width == classWidth && array.height == classHeight && !array.freeLayers.empty())
+                        slot.array = index;
+                }
+                if (!slot.isValid())
+                {
+                    Array array{ classWidth, classHeight, {} };
+                    for (auto layer = mLayersPerArray; layer > 0; --layer)
+                        array.freeLayers.push_back(layer - 1);
+                    mArrays.push_back(std::move(array));
+                    slot.array = (uint32_t)(mArrays.size() - 1);
+                    isNewArray = true;
+                }
+                slot.layer = mArrays[slot.array].freeLayers.back();
+                mArrays[slot.array].freeLayers.pop_back();
+                return slot;
+            }
+
+            void free(const Slot &slot)
+            {
+                panicif(!slot.isValid() || slot.array >= mArrays.size(), "freeing an invalid texture array slot");
+                mArrays[slot.array].freeLayers.push_back(slot.layer);
+            }
+
+            const Array &array(uint32_t index) const { return mArrays[index]; }
+            size_t arrayCount() const { return mArrays.size(); }
+            uint32_t layersPerArray() const { return mLayersPerArray; }
+
+            size_t usedLayers() const
+            {
+                size_t result = 0;
+                for (auto &array : mArrays)
+                    result += mLayersPerArray - array.freeLayers.size();
+                return result;
+            }
+
+        private:
+            uint32_t mLayersPerArray;
+            int mMinimumExtent;
+            std::vector<Array> mArrays;
+        };
+    }
+
+}}
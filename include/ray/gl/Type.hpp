@@ -21,6 +21,7 @@ namespace ray { namespace gl {
         template<> struct OpenGLType<assets::Color> { static constexpr GLenum value = GL_UNSIGNED_BYTE; }; 
         template<> struct OpenGLType<sampler<GL_TEXTURE_CUBE_MAP>> { static constexpr GLenum value = GL_SAMPLER_CUBE; }; 
         template<> struct OpenGLType<sampler<GL_TEXTURE_2D>>       { static constexpr GLenum value = GL_SAMPLER_2D; }; 
+        template<> struct OpenGLType<sampler<GL_TEXTURE_2D_ARRAY>> { static constexpr GLenum value = GL_SAMPLER_2D_ARRAY; }; 
 
     }
 
@@ -36,6 +37,7 @@ namespace ray { namespace gl {
             case GL_FLOAT_MAT4: return "mat4";
             case GL_SAMPLER_2D: return "sampler2D";   
             case GL_SAMPLER_CUBE: return "samplerCube";        
+            case GL_SAMPLER_2D_ARRAY: return "sampler2DArray";
             default: return platform::fmt("unknown(%d)", type);
         }
     }
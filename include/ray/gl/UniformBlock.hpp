@@ -0,0 +1,134 @@
+#pragma once
+
+#include <ray/gl/Buffer.hpp>
+#include <ray/gl/Std140.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace ray { namespace gl {
+
+    // Streams instances of a std140 struct through a ring of slots in a single
+    // uniform buffer. Each call to set() copies the struct once and rebinds the
+    // binding point to the new slot with glBindBufferRange, so the slots still in
+    // flight on the GPU are never overwritten.
+    //
+    // With GL 4.4 or GL_ARB_buffer_storage the buffer stays mapped, and each quarter
+    // of the ring is fenced when left, so a lap only waits on the GPU if it is a
+    // whole ring behind. Otherwise slots are written with glBufferSubData and the
+    // storage is orphaned when the ring wraps around.
+    template<typename S>
+    class UniformBlock
+    {
+        static_assert(std::is_trivially_copyable<S>::value, "uniform block structs are copied byte for byte");
+        static_assert(S::std140::size() <= sizeof(S), "struct is smaller than its std140 layout");
+        static_assert(S::std140::matches(S::offsets()), "struct members are not where std140 expects them");
+
+        static constexpr size_t SEGMENT_COUNT = 4;
+
+    public:
+        using Layout = typename S::std140;
+
+        UniformBlock(GLuint bindingPoint, size_t slotCount=256) : mBindingPoint(bindingPoint), mOffset(0)
+        {
+            GLint alignment = 0;
+            gl(GetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+            mSlotSize = std140::details::roundUp(sizeof(S), (size_t)alignment);
+            mCapacity = mSlotSize * std140::details::roundUp(std::max<size_t>(slotCount, SEGMENT_COUNT), SEGMENT_COUNT);
+
+            if (platform::hasOpenGLVersion(4, 4) || platform::hasOpenGLExtension("GL_ARB_buffer_storage"))
+            {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                mBuffer.bind();
+                gl(BufferStorage(GL_UNIFORM_BUFFER, (GLsizeiptr)mCapacity, nullptr, flags));
+                mMapped = reinterpret_cast<GLubyte *>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)mCapacity, flags));
+                panicif(mMapped == nullptr, "could not map a uniform block of %d bytes", mCapacity);
+            }
+            else
+                mBuffer.reserve(mCapacity, GL_STREAM_DRAW);
+        }
+
+        UniformBlock(const UniformBlock &other) = delete;
+        UniformBlock(UniformBlock &&other)
+            : mBuffer(std::move(other.mBuffer)), mBindingPoint(other.mBindingPoint), mSlotSize(other.mSlotSize), mCapacity(other.mCapacity), mOffset(other.mOffset),
+              mMapped(other.mMapped), mHasWritten(other.mHasWritten)
+        {
+            std::copy(std::begin(other.mFences), std::end(other.mFences), std::begin(mFences));
+            std::fill(std::begin(other.mFences), std::end(other.mFences), nullptr);
+            other.mMapped = nullptr;
+        }
+        UniformBlock &operator=(const UniformBlock &other) = delete;
+
+        // NOTE(cme): deleting the buffer unmaps it.
+        ~UniformBlock()
+        {
+            for (auto fence : mFences)
+                if (fence) glDeleteSync(fence);
+        }
+
+        void set(const S &data)
+        {
+            if (mOffset + mSlotSize > mCapacity)
+            {
+                if (!mMapped)
+                    mBuffer.reserve(mCapacity, GL_STREAM_DRAW);
+                mOffset = 0;
+            }
+
+            if (mMapped)
+            {
+                auto segmentSize = mCapacity / SEGMENT_COUNT;
+                if (mOffset % segmentSize == 0)
+                    enterSegment(mOffset / segmentSize);
+                std::memcpy(mMapped + mOffset, &data, sizeof(S));
+            }
+            else
+            {
+                mBuffer.bind();
+                gl(BufferSubData(GL_UNIFORM_BUFFER, (GLintptr)mOffset, (GLsizeiptr)sizeof(S), &data));
+            }
+
+            gl(BindBufferRange(GL_UNIFORM_BUFFER, mBindingPoint, mBuffer.handle(), (GLintptr)mOffset, (GLsizeiptr)sizeof(S)));
+            mOffset += mSlotSize;
+        }
+
+        void operator=(const S &data) { set(data); }
+
+        GLuint bindingPoint() const { return mBindingPoint; }
+        size_t slotSize() const { return mSlotSize; }
+        size_t capacity() const { return mCapacity; }
+
+    private:
+        // Fences the segment being left, and waits for the GPU to be done with the
+        // draws that read the new one the last time around.
+        void enterSegment(size_t segment)
+        {
+            auto previous = (segment + SEGMENT_COUNT - 1) % SEGMENT_COUNT;
+            if (mHasWritten)
+                mFences[previous] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            mHasWritten = true;
+
+            auto &fence = mFences[segment];
+            if (fence)
+            {
+                while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        UniformBuffer mBuffer;
+        GLuint mBindingPoint;
+        size_t mSlotSize, mCapacity, mOffset;
+        GLubyte *mMapped = nullptr;
+        GLsync mFences[SEGMENT_COUNT] = {};
+        bool mHasWritten = false;
+    };
+
+    template<typename S>
+    constexpr size_t UniformBlock<S>::SEGMENT_COUNT;
+
+}}
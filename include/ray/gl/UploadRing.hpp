@@ -0,0 +1,362 @@
+#pragma once
+
+#include <ray/assets/BitmapView.hpp>
+#include <ray/assets/PixelPool.hpp>
+#include <ray/gl/CubeMap.hpp>
+#include <ray/gl/Texture.hpp>
+#include <ray/platform/OpenGL.hpp>
+#include <ray/platform/Panic.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    // One TexSubImage2D of tight rows from the staging memory.
+    struct StagedUpload
+    {
+        GLenum target;      // GL_TEXTURE_2D or a face of a cube map
+        GLuint texture;
+        int level, x, y, width, height, depth;
+        size_t offset;
+        bool generateMipmap;
+    };
+
+    // Staging memory in a GL_PIXEL_UNPACK_BUFFER, mapped once and for all with GL 4.4
+    // or GL_ARB_buffer_storage. Without them it is plain memory the uploads read as
+    // client memory, which still keeps workers off the render thread.
+    class PixelUnpackBuffer
+    {
+    public:
+        using Fence = GLsync;
+
+        uint8_t *create(size_t capacity)
+        {
+            if (platform::hasOpenGLVersion(4, 4) || platform::hasOpenGLExtension("GL_ARB_buffer_storage"))
+            {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                gl(GenBuffers(1, &mBuffer));
+                gl(BindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer));
+                gl(BufferStorage(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)capacity, nullptr, flags));
+                mPixels = reinterpret_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)capacity, flags));
+                gl(BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+                panicif(mPixels == nullptr, "could not map %d bytes of staging memory", capacity);
+            }
+            else
+                mPixels = assets::PixelPool::allocateAligned(capacity);
+            return mPixels;
+        }
+
+        void destroy()
+        {
+            if (mBuffer)
+            {
+                gl(BindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer));
+                gl(UnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+                gl(BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+                gl(DeleteBuffers(1, &mBuffer));
+            }
+            else
+                assets::PixelPool::freeAligned(mPixels);
+        }
+
+        void begin()
+        {
+            if (mBuffer) gl(BindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer));
+            gl(PixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        }
+
+        void upload(const StagedUpload &upload)
+        {
+            // NOTE(cme): with a buffer bound, the pointer is an offset into it.
+            auto pixels = mBuffer ? reinterpret_cast<const GLvoid *>(upload.offset) : mPixels + upload.offset;
+            gl(BindTexture(bindingOf(upload.target), upload.texture));
+            gl(TexSubImage2D(upload.target, upload.level, upload.x, upload.y, upload.width, upload.height, formatOf(upload.depth), GL_UNSIGNED_BYTE, pixels));
+        }
+
+        void generateMipmap(GLenum target, GLuint texture)
+        {
+            gl(BindTexture(bindingOf(target), texture));
+            gl(GenerateMipmap(bindingOf(target)));
+        }
+
+        void end()
+        {
+            gl(PixelStorei(GL_UNPACK_ALIGNMENT, 4));
+            if (mBuffer) gl(BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+        }
+
+        // Client memory is copied by the time the call returns, nothing to wait for.
+        Fence fence() { return mBuffer ? glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) : nullptr; }
+        void release(Fence fence) { if (fence) glDeleteSync(fence); }
+        bool isSignaled(Fence fence)
+        {
+            if (fence == nullptr)
+                return true;
+            auto status = glClientWaitSync(fence, 0, 0);
+            return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+        }
+
+        bool isPersistent() const { return mBuffer != 0; }
+
+    private:
+        static GLenum bindingOf(GLenum target)
+        {
+            return target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z ? GL_TEXTURE_CUBE_MAP : target;
+        }
+
+        static GLenum formatOf(int depth)
+        {
+            switch(depth)
+            {
+            case 1: return GL_RED;
+            case 2: return GL_RG;
+            case 3: return GL_RGB;
+            case 4: return GL_RGBA;
+            default: panic("unexpected number of channels '%d'", depth);
+            }
+        }
+
+        GLuint mBuffer = 0;
+        uint8_t *mPixels = nullptr;
+    };
+
+    // Streams pixels to textures through a ring of staging memory. Any thread can
+    // reserve room, write its pixels there and submit the upload; the render thread
+    // issues what was submitted on flush() and, at the end of the frame, fences it.
+    // The memory of a frame is written again only once the GPU is past its fence.
+    //
+    // NOTE(cme): memory is reclaimed in the order it was reserved, every reservation
+    //            must be submitted or the ring fills up behind it.
+    template<typename Buffers>
+    class BasicUploadRing
+    {
+        using u8 = uint8_t;
+
+    public:
+        static constexpr size_t ALIGNMENT = assets::PixelPool::ALIGNMENT;
+
+        struct Statistics
+        {
+            size_t uploads = 0, bytes = 0;
+            size_t rejected = 0;                    // reservations the ring had no room for
+            platform::sec uploadTime = platform::sec(0.0);  // spent by the render thread issuing uploads
+        };
+
+        // Where the pixels of one upload go, rows are tight.
+        class Staging
+        {
+        public:
+            Staging() = default;
+
+            bool isValid()   const { return mPixels != nullptr; }
+            int width()      const { return mWidth; }
+            int height()     const { return mHeight; }
+            int depth()      const { return mDepth; }
+            int stride()     const { return mWidth * mDepth; }
+            size_t size()    const { return (size_t)stride() * mHeight; }
+            u8 *pixels()     const { return mPixels; }
+            u8 *row(int y)   const { return mPixels + (size_t)y * stride(); }
+
+        private:
+            friend class BasicUploadRing;
+            Staging(u8 *pixels, size_t offset, uint64_t sequence, int width, int height, int depth)
+                : mPixels(pixels), mOffset(offset), mSequence(sequence), mWidth(width), mHeight(height), mDepth(depth) {}
+
+            u8 *mPixels = nullptr;
+            size_t mOffset = 0;
+            uint64_t mSequence = 0;
+            int mWidth = 0, mHeight = 0, mDepth = 0;
+        };
+
+        explicit BasicUploadRing(size_t capacity=32 << 20, Buffers buffers=Buffers())
+            : mBuffers(buffers), mCapacity(capacity - capacity % ALIGNMENT)
+        {
+            panicif(mCapacity == 0, "an upload ring needs at least %d bytes", ALIGNMENT);
+            mPixels = mBuffers.create(mCapacity);
+        }
+
+        BasicUploadRing(const BasicUploadRing &other) = delete;
+        BasicUploadRing &operator=(const BasicUploadRing &other) = delete;
+
+        ~BasicUploadRing()
+        {
+            for (auto &fence : mFences)
+                mBuffers.release(fence.fence);
+            mBuffers.destroy();
+        }
+
+        // Invalid when the ring has no room left until the GPU catches up.
+        Staging reserve(int width, int height, int depth)
+        {
+            auto size = alignUp((size_t)width * height * depth);
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mUsed == 0)
+                mHead = 0;
+            auto offset = mHead, padding = (size_t)0;
+            if (offset + size > mCapacity)
+            {
+                padding = mCapacity - offset;
+                offset = 0;
+            }
+            if (size > mCapacity || mUsed + padding + size > mCapacity)
+            {
+                ++mCurrent.rejected;
+                return Staging();
+            }
+            mBlocks.push_back(Block{ padding + size, 0, false });
+            mUsed += padding + size;
+            mHead = offset + size;
+            return Staging(mPixels + offset, offset, mFirstSequence + mBlocks.size() - 1, width, height, depth);
+        }
+
+        void submit(const Staging &staging, GLenum target, GLuint texture, int level, int x, int y, bool generateMipmap)
+        {
+            panicif(!staging.isValid(), "submitting an upload that has no staging memory");
+            std::lock_guard<std::mutex> lock(mMutex);
+            mSubmitted.push_back(Submitted{ StagedUpload{ target, texture, level, x, y, staging.width(), staging.height(), staging.depth(), staging.mOffset, generateMipmap }, staging.mSequence });
+        }
+
+        void submit(const Staging &staging, const Texture &texture, int x, int y, bool generateMipmap=true)
+        {
+            submit(staging, GL_TEXTURE_2D, texture.handle(), 0, x, y, generateMipmap);
+        }
+
+        void submit(const Staging &staging, const CubeMap &cubeMap, int face)
+        {
+            submit(staging, (GLenum)(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face), cubeMap.handle(), 0, 0, 0, false);
+        }
+
+        // Copies the bitmap to staging memory and submits it, false when the ring is full.
+        bool upload(const Texture &texture, int x, int y, const assets::BitmapView &bitmap, bool generateMipmap=true)
+        {
+            auto staging = reserve(bitmap.width(), bitmap.height(), bitmap.depth());
+            if (!staging.isValid())
+                return false;
+            for (int row = 0; row < bitmap.height(); ++row)
+                std::memcpy(staging.row(row), bitmap.row(row), (size_t)staging.stride());
+            submit(staging, texture, x, y, generateMipmap);
+            return true;
+        }
+
+        // Render thread only: issues the uploads submitted so far, the mips of the
+        // textures that want them are generated once for all of their uploads.
+        void flush()
+        {
+            std::vector<Submitted> submitted;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                submitted.swap(mSubmitted);
+                for (auto &entry : submitted)
+                {
+                    auto &block = mBlocks[(size_t)(entry.sequence - mFirstSequence)];
+                    block.frame = mFrame;
+                    block.isIssued = true;
+                }
+            }
+            if (submitted.empty())
+                return;
+
+            auto stopwatch = platform::Stopwatch();
+            mMipmaps.clear();
+            mBuffers.begin();
+            for (auto &entry : submitted)
+            {
+                mBuffers.upload(entry.upload);
+                mCurrent.bytes += (size_t)entry.upload.width * entry.upload.height * entry.upload.depth;
+                auto mipmap = std::make_pair(entry.upload.target, entry.upload.texture);
+                if (entry.upload.generateMipmap && std::find(mMipmaps.begin(), mMipmaps.end(), mipmap) == mMipmaps.end())
+                    mMipmaps.push_back(mipmap);
+            }
+            mBuffers.end();
+            for (auto &mipmap : mMipmaps)
+                mBuffers.generateMipmap(mipmap.first, mipmap.second);
+            mCurrent.uploads += submitted.size();
+            mCurrent.uploadTime += stopwatch.elapsed();
+            mIsFrameIssued = true;
+        }
+
+        // Render thread only, once a frame: flushes, fences the frame and takes back
+        // the memory of the frames the GPU is done with.
+        void endFrame()
+        {
+            flush();
+            if (mIsFrameIssued)
+                mFences.push_back(FrameFence{ mFrame, mBuffers.fence() });
+            mIsFrameIssued = false;
+
+            auto completed = mCompletedFrames;
+            while (!mFences.empty() && mBuffers.isSignaled(mFences.front().fence))
+            {
+                completed = mFences.front().frame + 1;
+                mBuffers.release(mFences.front().fence);
+                mFences.pop_front();
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCompletedFrames = completed;
+            while (!mBlocks.empty() && mBlocks.front().isIssued && mBlocks.front().frame < mCompletedFrames)
+            {
+                mUsed -= mBlocks.front().size;
+                mBlocks.pop_front();
+                ++mFirstSequence;
+            }
+            mLastFrame = mCurrent;
+            mCurrent = Statistics();
+            ++mFrame;
+        }
+
+        const Statistics &lastFrame() const { return mLastFrame; }
+        size_t capacity() const { return mCapacity; }
+        size_t usedBytes() const { std::lock_guard<std::mutex> lock(mMutex); return mUsed; }
+        Buffers &buffers() { return mBuffers; }
+
+    private:
+        struct Block
+        {
+            size_t size;            // with the padding skipped to wrap around before it
+            uint64_t frame;
+            bool isIssued;
+        };
+
+        struct Submitted
+        {
+            StagedUpload upload;
+            uint64_t sequence;
+        };
+
+        struct FrameFence
+        {
+            uint64_t frame;
+            typename Buffers::Fence fence;
+        };
+
+        static size_t alignUp(size_t size) { return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+        Buffers mBuffers;
+        u8 *mPixels = nullptr;
+        size_t mCapacity, mHead = 0, mUsed = 0;
+
+        mutable std::mutex mMutex;
+        std::deque<Block> mBlocks;
+        uint64_t mFirstSequence = 0;
+        std::vector<Submitted> mSubmitted;
+
+        std::deque<FrameFence> mFences;
+        std::vector<std::pair<GLenum, GLuint>> mMipmaps;
+        uint64_t mFrame = 0, mCompletedFrames = 0;
+        bool mIsFrameIssued = false;
+        Statistics mCurrent, mLastFrame;
+    };
+
+    template<typename Buffers>
+    constexpr size_t BasicUploadRing<Buffers>::ALIGNMENT;
+
+    using UploadRing = BasicUploadRing<PixelUnpackBuffer>;
+
+}}
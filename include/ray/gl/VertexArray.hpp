@@ -13,6 +13,7 @@ namespace ray { namespace gl {
     public:
         inline void bind() const { gl(BindVertexArray(mHandle)); }
         inline void unbind() const { gl(BindVertexArray(0)); }
+        inline GLuint handle() const { return mHandle; }
 
         template<typename V, typename F, size_t stride>
         void bindAttributeAtOffset(GLuint offset, Attribute<V> attribute, const VertexBuffer<F, stride> &vbo, GLboolean normalized=GL_FALSE) const
@@ -22,6 +23,23 @@ namespace ray { namespace gl {
             unbind();
         }
 
+        template<typename V>
+        void bindAttributeAtByteOffset(Attribute<V> attribute, GLuint buffer, size_t byteStride, size_t byteOffset, GLboolean normalized=GL_FALSE) const
+        {
+            bind();
+            attribute.bind(buffer, attribute.scalarType(), byteStride, byteOffset, normalized == GL_TRUE);
+            unbind();
+        }
+
+        // Binds an attribute that advances once every 'divisor' instances instead of once per vertex.
+        template<typename V, typename F, size_t stride>
+        void bindInstanceAttributeAtOffset(GLuint offset, Attribute<V> attribute, const VertexBuffer<F, stride> &vbo, GLuint divisor=1) const
+        {
+            bind();
+            attribute.bind(vbo, false, offset, divisor); 
+            unbind();
+        }
+
         template<typename V, typename F, size_t stride>
         void bindAttribute(Attribute<V> attribute, const VertexBuffer<F, stride> &vbo, bool normalized=false) const
         {
@@ -35,6 +53,14 @@ namespace ray { namespace gl {
             unbind();
         }
 
+        // Reads the indices from any buffer object, e.g. a page of a BufferHeap.
+        void bindIndices(GLuint buffer) const
+        {
+            bind();
+            gl(BindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer));
+            unbind();
+        }
+
     private:        
         static void destroy(GLuint handle) { gl(DeleteVertexArrays(1, &handle)); }
         static void create(GLuint &handle) { gl(GenVertexArrays(1, &handle)); }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <ray/math/Vector3.hpp>
+#include <ray/math/Vector4.hpp>
+#include <ray/math/Matrix.hpp>
+#include <ray/math/Utils.hpp>
+#include <array>
+
+namespace ray { namespace math {
+
+    // The six planes of a view volume, extracted from a (row major) projection
+    // or view-projection matrix. Each plane is (normal, distance) with the
+    // normal pointing inside, so a point p is inside when dot(normal,p)+d >= 0.
+    template<typename S>
+    class Frustum
+    {
+        using vector3 = Vector3<S>;
+        using vector4 = Vector4<S>;
+        using matrix4 = Matrix<S,4,4>;
+    
+    public:
+        enum { LEFT_PLANE, RIGHT_PLANE, BOTTOM_PLANE, TOP_PLANE, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+        Frustum() = default;
+        Frustum(const matrix4 &viewProjection)
+        {
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                mPlanes[2*axis+0] = normalizePlane(row(viewProjection, 3) + row(viewProjection, axis));
+                mPlanes[2*axis+1] = normalizePlane(row(viewProjection, 3) - row(viewProjection, axis));
+            }
+        }
+
+        S distance(size_t planeIndex, const vector3 &point) const
+        {
+            auto &plane = mPlanes[planeIndex];
+            return dot(plane.xyz, point) + plane.w;
+        }
+
+        bool contains(const vector3 &point) const 
+        { 
+            return intersects(point, S(0)); 
+        }
+
+        bool intersects(const vector3 &center, S radius) const
+        {
+            for (size_t planeIndex = 0; planeIndex < PLANE_COUNT; ++planeIndex)
+                if (distance(planeIndex, center) < -radius)
+                    return false;
+            return true;
+        }
+
+        const vector4 &plane(size_t planeIndex) const { return mPlanes[planeIndex]; }
+
+    private:
+        static vector4 row(const matrix4 &m, size_t line) { return vector4(m(line,0), m(line,1), m(line,2), m(line,3)); }
+        static vector4 normalizePlane(const vector4 &plane) { return plane / S(length(plane.xyz)); }
+
+        std::array<vector4, PLANE_COUNT> mPlanes;
+    };
+
+}}
@@ -8,6 +8,7 @@
 #include <ray/math/Utils.hpp>
 #include <ray/math/Transform.hpp>
 #include <ray/math/Rectangle.hpp>
+#include <ray/math/Frustum.hpp>
 
 namespace ray { namespace math {
 
@@ -72,4 +73,7 @@ namespace ray { namespace math {
 
     using quat  = Quaternion<f32>;
     using dquat = Quaternion<f64>;
+
+    using frustum  = Frustum<f32>;
+    using dfrustum = Frustum<f64>;
 }}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/MappedFile.hpp>
+#include <ray/platform/Pack.hpp>
+#include <memory>
+#include <string>
+
+namespace ray { namespace platform { namespace fs {
+
+    enum class ReadMode
+    {
+        Map,    // borrowed from the page cache, or from a mounted pack
+        Copy,   // owned, e.g. for files about to be modified or deleted
+    };
+
+    // A file being read on the job system.
+    class AsyncRead
+    {
+    public:
+        AsyncRead() = default;
+
+        bool isDone() const { return !mState || mState->counter.isDone(); }
+
+        // Runs other jobs until the read is done, the data can then be moved out.
+        FileData &wait(JobSystem &jobs)
+        {
+            jobs.wait(mState->counter);
+            return mState->data;
+        }
+
+        const std::string &filename() const { return mState->filename; }
+
+    private:
+        struct State
+        {
+            std::string filename;
+            FileData data;
+            JobSystem::Counter counter;
+        };
+
+        friend AsyncRead readAsync(JobSystem &jobs, const std::string &filename, ReadMode mode);
+        std::shared_ptr<State> mState;
+    };
+
+    // NOTE(cme): a mapped file has each of its pages touched by the job, so that
+    //            the disk is read on a worker rather than when a loader first
+    //            looks at the bytes on the main thread.
+    inline AsyncRead readAsync(JobSystem &jobs, const std::string &filename, ReadMode mode=ReadMode::Map)
+    {
+        AsyncRead result;
+        result.mState = std::make_shared<AsyncRead::State>();
+        result.mState->filename = filename;
+
+        auto state = result.mState;
+        jobs.submit([state, mode]() {
+            if (mode == ReadMode::Copy)
+            {
+                state->data = readFile(state->filename);
+                return;
+            }
+
+            state->data = load(state->filename, Access::WillNeed);
+            const volatile uint8_t *bytes = state->data.data();
+            uint8_t touched = 0;
+            for (size_t offset = 0; offset < state->data.size(); offset += 4096)
+                touched ^= bytes[offset];
+            (void)touched;
+        }, &state->counter);
+        return result;
+    }
+
+}}}
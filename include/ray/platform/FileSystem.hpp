@@ -1,14 +1,19 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace ray { namespace platform { namespace fs {
 
     bool        exists(const std::string &path);    
+    bool        createDirectories(const std::string &path);
     bool        isAbsolute(const std::string &path);
     std::string extension(const std::string &path);
     std::string filename(const std::string &path);
     std::string parent(const std::string &path);
     std::string join(const std::string &pathPrefix, const std::string pathSuffix);
 
+    // Every regular file under 'directory', relative to it and with '/' separators.
+    std::vector<std::string> listFiles(const std::string &directory);
+
 }}}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <ray/platform/Time.hpp>
+#include <cstdint>
+
+namespace ray { namespace platform {
+
+    // Turns variable frame times into a whole number of fixed simulation steps. What
+    // is left over is kept for the next frame and exposed as alpha(), the fraction of
+    // a step the renderer should interpolate between the last two states.
+    class FixedTimestep
+    {
+    public:
+        // NOTE(cme): when a frame takes so long that more than 'maximumSteps' are due,
+        //            the extra time is dropped rather than spiraling into ever longer frames.
+        FixedTimestep(sec step, uint32_t maximumSteps=8) : mStep(step), mAccumulator(0), mMaximumSteps(maximumSteps) {}
+
+        template<typename Update>
+        uint32_t advance(sec elapsed, Update update)
+        {
+            mAccumulator += elapsed;
+            uint32_t steps = 0;
+            while (mAccumulator >= mStep && steps < mMaximumSteps)
+            {
+                update(mStep);
+                mAccumulator -= mStep;
+                ++steps;
+            }
+            if (steps == mMaximumSteps && mAccumulator >= mStep)
+                mAccumulator = sec(0);
+            return steps;
+        }
+
+        float alpha() const { return (float)(mAccumulator / mStep); }
+        sec step() const { return mStep; }
+
+    private:
+        sec mStep, mAccumulator;
+        uint32_t mMaximumSteps;
+    };
+
+}}
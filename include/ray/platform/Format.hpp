@@ -0,0 +1,490 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+namespace ray { namespace platform {
+
+    // A format string that is read in place, string literals and std::string alike.
+    class FormatString
+    {
+    public:
+        FormatString(const char *text) : mData(text), mSize(std::strlen(text)) {}
+        FormatString(const std::string &text) : mData(text.data()), mSize(text.size()) {}
+
+        const char *data() const { return mData; }
+        size_t size() const { return mSize; }
+
+    private:
+        const char *mData;
+        size_t mSize;
+    };
+
+    namespace details
+    {
+        struct FormatSpec
+        {
+            bool left = false, plus = false, space = false, zero = false, alternate = false;
+            int width = 0, precision = -1;
+            char conversion = 0;
+        };
+
+        // Collects the formatted text in a fixed buffer. With a stream, the buffer is
+        // handed to it whenever it fills up, without one the text is truncated but
+        // size() still counts all of it, like snprintf.
+        class FormatWriter
+        {
+        public:
+            FormatWriter(char *buffer, size_t capacity, std::ostream *out=nullptr) : mBuffer(buffer), mCapacity(capacity), mUsed(0), mTotal(0), mOut(out) {}
+
+            void write(const char *text, size_t size)
+            {
+                mTotal += size;
+                while (size > 0)
+                {
+                    if (mUsed == mCapacity && !flush())
+                        return;
+                    auto count = size < mCapacity - mUsed ? size : mCapacity - mUsed;
+                    std::memcpy(mBuffer + mUsed, text, count);
+                    mUsed += count;
+                    text += count;
+                    size -= count;
+                }
+            }
+
+            void put(char c) { write(&c, 1); }
+
+            void fill(char c, size_t count)
+            {
+                char chunk[32];
+                std::memset(chunk, c, sizeof(chunk));
+                for (; count > sizeof(chunk); count -= sizeof(chunk))
+                    write(chunk, sizeof(chunk));
+                write(chunk, count);
+            }
+
+            bool flush()
+            {
+                if (mOut == nullptr)
+                    return false;
+                mOut->write(mBuffer, (std::streamsize)mUsed);
+                mUsed = 0;
+                return true;
+            }
+
+            size_t used() const { return mUsed; }
+            size_t size() const { return mTotal; }
+
+        private:
+            char *mBuffer;
+            size_t mCapacity, mUsed, mTotal;
+            std::ostream *mOut;
+        };
+
+        // Lets types that only have an operator<< be formatted without allocating.
+        class FormatStreambuf : public std::streambuf
+        {
+        public:
+            FormatStreambuf(char *buffer, size_t capacity) { setp(buffer, buffer + capacity); }
+            size_t size() const { return (size_t)(pptr() - pbase()); }
+        };
+
+        // NOTE(cme): 'prefix' characters, a sign or a 0x, stay in front of zero padding.
+        inline void writePadded(FormatWriter &writer, const FormatSpec &spec, const char *text, size_t size, size_t prefix=0, bool canZeroPad=false)
+        {
+            auto padding = (size_t)spec.width > size ? spec.width - size : 0;
+            if (spec.left)
+            {
+                writer.write(text, size);
+                writer.fill(' ', padding);
+            }
+            else if (spec.zero && canZeroPad)
+            {
+                writer.write(text, prefix);
+                writer.fill('0', padding);
+                writer.write(text + prefix, size - prefix);
+            }
+            else
+            {
+                writer.fill(' ', padding);
+                writer.write(text, size);
+            }
+        }
+
+        template<typename T>
+        void formatInteger(FormatWriter &writer, const FormatSpec &spec, T value)
+        {
+            using Unsigned = typename std::make_unsigned<T>::type;
+            auto base = 10u;
+            auto digits = "0123456789abcdef";
+            switch (spec.conversion)
+            {
+                case 'x': base = 16; break;
+                case 'X': base = 16; digits = "0123456789ABCDEF"; break;
+                case 'o': base = 8; break;
+                case 'p': base = 16; break;
+            }
+
+            auto isNegative = base == 10 && value < T(0);
+            auto magnitude = isNegative ? Unsigned(Unsigned(0) - Unsigned(value)) : Unsigned(value);
+
+            char text[80];
+            auto end = text + sizeof(text), first = end;
+            do
+            {
+                *--first = digits[magnitude % base];
+                magnitude = Unsigned(magnitude / base);
+            } while (magnitude != 0);
+
+            auto last = first;
+            if ((spec.alternate || spec.conversion == 'p') && base == 16)
+            {
+                *--first = spec.conversion == 'X' ? 'X' : 'x';
+                *--first = '0';
+            }
+            else if (spec.alternate && base == 8 && *first != '0')
+                *--first = '0';
+            if (isNegative)
+                *--first = '-';
+            else if (spec.plus && base == 10)
+                *--first = '+';
+            else if (spec.space && base == 10)
+                *--first = ' ';
+
+            writePadded(writer, spec, first, (size_t)(end - first), (size_t)(last - first), true);
+        }
+
+        template<typename T>
+        void formatFloat(FormatWriter &writer, const FormatSpec &spec, T value)
+        {
+            char conversion = 'g';
+            switch (spec.conversion)
+            {
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                    conversion = spec.conversion;
+                    break;
+            }
+
+            char format[12], *flag = format;
+            *flag++ = '%';
+            if (spec.plus) *flag++ = '+';
+            if (spec.space) *flag++ = ' ';
+            if (spec.alternate) *flag++ = '#';
+            *flag++ = '.';
+            *flag++ = '*';
+            *flag++ = conversion;
+            *flag = 0;
+
+            // NOTE(cme): large enough for %f of the largest double.
+            char text[512];
+            auto size = std::snprintf(text, sizeof(text), format, spec.precision, (double)value);
+            if (size < 0)
+                return;
+            auto length = (size_t)size < sizeof(text) ? (size_t)size : sizeof(text) - 1;
+            auto hasSign = text[0] == '-' || text[0] == '+' || text[0] == ' ';
+            auto isFinite = value == value && value - value == value - value;
+            writePadded(writer, spec, text, length, hasSign ? 1 : 0, isFinite);
+        }
+
+        inline void formatString(FormatWriter &writer, const FormatSpec &spec, const char *text, size_t size)
+        {
+            if (spec.precision >= 0 && (size_t)spec.precision < size)
+                size = (size_t)spec.precision;
+            writePadded(writer, spec, text, size);
+        }
+
+        inline void formatValue(FormatWriter &writer, const FormatSpec &spec, const char *value)
+        {
+            if (value == nullptr)
+                value = "(null)";
+            formatString(writer, spec, value, std::strlen(value));
+        }
+
+        inline void formatValue(FormatWriter &writer, const FormatSpec &spec, const std::string &value) { formatString(writer, spec, value.data(), value.size()); }
+        inline void formatValue(FormatWriter &writer, const FormatSpec &spec, char value) { formatString(writer, spec, &value, 1); }
+        inline void formatValue(FormatWriter &writer, const FormatSpec &spec, bool value) { formatInteger(writer, spec, value ? 1 : 0); }
+
+        // NOTE(cme): boost::format streams 8-bit integers, so they print as characters.
+        //            That is kept for %c, %s and untyped directives, the others print numbers.
+        template<typename T>
+        void formatByte(FormatWriter &writer, const FormatSpec &spec, T value)
+        {
+            if (spec.conversion == 'c' || spec.conversion == 's' || spec.conversion == 0)
+            {
+                auto c = (char)value;
+                formatString(writer, spec, &c, 1);
+            }
+            else
+                formatInteger(writer, spec, value);
+        }
+
+        inline void formatValue(FormatWriter &writer, const FormatSpec &spec, signed char value) { formatByte(writer, spec, value); }
+        inline void formatValue(FormatWriter &writer, const FormatSpec &spec, unsigned char value) { formatByte(writer, spec, value); }
+
+        inline void formatValue(FormatWriter &writer, const FormatSpec &spec, const void *value)
+        {
+            auto pointer = spec;
+            pointer.conversion = 'p';
+            formatInteger(writer, pointer, (uintptr_t)value);
+        }
+
+        template<typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+        void formatValue(FormatWriter &writer, const FormatSpec &spec, T value) { formatInteger(writer, spec, value); }
+
+        template<typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+        void formatValue(FormatWriter &writer, const FormatSpec &spec, T value) { formatFloat(writer, spec, value); }
+
+        template<typename T>
+        using IsStreamed = std::integral_constant<bool, !std::is_arithmetic<T>::value && !std::is_pointer<T>::value && !std::is_array<T>::value && !std::is_same<T, std::string>::value>;
+
+        // Anything else goes through its operator<<, e.g. vectors and matrices.
+        template<typename T, typename std::enable_if<IsStreamed<T>::value, int>::type = 0>
+        void formatValue(FormatWriter &writer, const FormatSpec &spec, const T &value)
+        {
+            char text[256];
+            FormatStreambuf buffer(text, sizeof(text));
+            std::ostream out(&buffer);
+            if (spec.precision >= 0)
+                out.precision(spec.precision);
+            if (spec.conversion == 'f' || spec.conversion == 'F')
+                out.setf(std::ios::fixed, std::ios::floatfield);
+            if (spec.conversion == 'x' || spec.conversion == 'X')
+                out.setf(std::ios::hex, std::ios::basefield);
+            out << value;
+            writePadded(writer, spec, text, buffer.size());
+        }
+
+        struct FormatArgument
+        {
+            const void *value;
+            void (*write)(FormatWriter &writer, const FormatSpec &spec, const void *value);
+        };
+
+        template<typename T>
+        void writeArgument(FormatWriter &writer, const FormatSpec &spec, const void *value) { formatValue(writer, spec, *static_cast<const T *>(value)); }
+
+        template<typename T>
+        FormatArgument makeArgument(const T &value) { return FormatArgument{ &value, &writeArgument<T> }; }
+
+        inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+        inline int parseNumber(const char *&text, const char *end)
+        {
+            auto result = 0;
+            for (; text != end && isDigit(*text); ++text)
+                result = 10*result + (*text - '0');
+            return result;
+        }
+
+        // Parses what follows a '%': flags, width, precision, length modifiers and a
+        // conversion. Returns false if it isn't a valid directive.
+        inline bool parseSpec(const char *&text, const char *end, FormatSpec &spec, bool isBracketed)
+        {
+            for (; text != end; ++text)
+            {
+                if (*text == '-') spec.left = true;
+                else if (*text == '+') spec.plus = true;
+                else if (*text == ' ') spec.space = true;
+                else if (*text == '0') spec.zero = true;
+                else if (*text == '#') spec.alternate = true;
+                else break;
+            }
+            spec.width = parseNumber(text, end);
+            if (text != end && *text == '.')
+            {
+                ++text;
+                spec.precision = parseNumber(text, end);
+            }
+            while (text != end && std::strchr("hlLqjzt", *text) != nullptr)
+                ++text;
+            if (text == end)
+                return false;
+            if (std::strchr("diouxXeEfFgGaAcsSp", *text) != nullptr)
+                spec.conversion = *text++;
+            else if (!isBracketed)
+                return false;
+            if (isBracketed)
+            {
+                if (text == end || *text != '|')
+                    return false;
+                ++text;
+            }
+            return true;
+        }
+
+        // Understands the boost::format syntax: printf directives, with their type
+        // only used as a hint, '%N%' and '%N$...' for positional arguments, '%|...|'
+        // and '%%'.
+        // NOTE(cme): where boost::format throws, too few or too many arguments abort
+        //            debug builds. Release builds leave missing ones out and ignore extra ones.
+        inline void formatArguments(FormatWriter &writer, FormatString format, const FormatArgument *arguments, size_t count)
+        {
+            auto text = format.data(), end = text + format.size();
+            size_t next = 0, expected = 0;
+            while (text != end)
+            {
+                auto percent = static_cast<const char *>(std::memchr(text, '%', (size_t)(end - text)));
+                if (percent == nullptr)
+                {
+                    writer.write(text, (size_t)(end - text));
+                    break;
+                }
+                writer.write(text, (size_t)(percent - text));
+                auto directive = percent + 1;
+                if (directive != end && *directive == '%')
+                {
+                    writer.put('%');
+                    text = directive + 1;
+                    continue;
+                }
+
+                FormatSpec spec;
+                auto cursor = directive;
+                auto argument = next;
+                auto isValid = false;
+                if (cursor != end && isDigit(*cursor) && *cursor != '0')
+                {
+                    auto position = parseNumber(cursor, end);
+                    if (cursor != end && *cursor == '%')
+                    {
+                        argument = (size_t)position - 1;
+                        ++cursor;
+                        isValid = true;
+                    }
+                    else if (cursor != end && *cursor == '$')
+                    {
+                        argument = (size_t)position - 1;
+                        ++cursor;
+                        isValid = parseSpec(cursor, end, spec, false);
+                    }
+                    else
+                    {
+                        cursor = directive;
+                        isValid = parseSpec(cursor, end, spec, false);
+                        ++next;
+                    }
+                }
+                else if (cursor != end && *cursor == '|')
+                {
+                    ++cursor;
+                    isValid = parseSpec(cursor, end, spec, true);
+                    ++next;
+                }
+                else
+                {
+                    isValid = parseSpec(cursor, end, spec, false);
+                    ++next;
+                }
+
+                if (!isValid)
+                {
+                    writer.put('%');
+                    text = directive;
+                    continue;
+                }
+                if (argument < count)
+                    arguments[argument].write(writer, spec, arguments[argument].value);
+                expected = std::max(expected, argument + 1);
+                text = cursor;
+            }
+#ifndef NDEBUG
+            if (expected != count)
+            {
+                std::fprintf(stderr, "format \"%.*s\" expects %zu arguments, got %zu\n", (int)format.size(), format.data(), expected, count);
+                std::abort();
+            }
+#else
+            (void)expected;
+#endif
+        }
+
+        template<typename... Args>
+        void format(FormatWriter &writer, FormatString format, const Args &... args)
+        {
+            // NOTE(cme): one more than needed, arrays can't be empty.
+            const FormatArgument arguments[] = { makeArgument(args)..., FormatArgument{ nullptr, nullptr } };
+            formatArguments(writer, format, arguments, sizeof...(Args));
+        }
+    }
+
+    // Formats into 'buffer', which is always null terminated, and returns the size
+    // of the whole text like snprintf, even when it got truncated.
+    template<typename... Args>
+    size_t formatTo(char *buffer, size_t capacity, FormatString format, const Args &... args)
+    {
+        if (capacity == 0)
+        {
+            char ignored[1];
+            details::FormatWriter counter(ignored, 0);
+            details::format(counter, format, args...);
+            return counter.size();
+        }
+        details::FormatWriter writer(buffer, capacity - 1);
+        details::format(writer, format, args...);
+        buffer[writer.used()] = 0;
+        return writer.size();
+    }
+
+    // Replaces the content of 'out', which keeps its capacity from one call to the next.
+    template<typename... Args>
+    void formatTo(std::string &out, FormatString format, const Args &... args)
+    {
+        char buffer[256];
+        auto size = formatTo(buffer, sizeof(buffer), format, args...);
+        if (size < sizeof(buffer))
+        {
+            out.assign(buffer, size);
+            return;
+        }
+        out.resize(size);
+        formatTo(&out[0], size + 1, format, args...);
+    }
+
+    template<typename... Args>
+    void formatTo(std::ostream &out, FormatString format, const Args &... args)
+    {
+        char buffer[256];
+        details::FormatWriter writer(buffer, sizeof(buffer), &out);
+        details::format(writer, format, args...);
+        writer.flush();
+    }
+
+    // Text formatted in place, e.g. on the stack.
+    //
+    //      FormatBuffer<64> text("average frame time = %6.3fmsec", time);
+    //
+    template<size_t Capacity>
+    class FormatBuffer
+    {
+    public:
+        FormatBuffer() : mSize(0) { mText[0] = 0; }
+
+        template<typename... Args>
+        FormatBuffer(FormatString format, const Args &... args) { this->format(format, args...); }
+
+        template<typename... Args>
+        const char *format(FormatString format, const Args &... args)
+        {
+            mSize = formatTo(mText, Capacity, format, args...);
+            return mText;
+        }
+
+        const char *c_str() const { return mText; }
+        size_t size() const { return isTruncated() ? Capacity - 1 : mSize; }
+        bool isTruncated() const { return mSize >= Capacity; }
+        std::string str() const { return std::string(mText, size()); }
+
+    private:
+        char mText[Capacity];
+        size_t mSize;
+    };
+
+}}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <ray/platform/JobSystem.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ray { namespace platform {
+
+    // State handed from the simulation to the renderer. The simulation writes the
+    // back copy while the renderer reads the front one, publish() swaps them once
+    // both are done with the frame.
+    // NOTE(cme): the back copy holds the state of two frames ago, the simulation is
+    //            expected to write all of it every frame.
+    class AbstractSnapshot
+    {
+    public:
+        virtual ~AbstractSnapshot() = default;
+        virtual void publish() = 0;
+    };
+
+    template<typename T>
+    class Snapshot : public AbstractSnapshot
+    {
+    public:
+        Snapshot() = default;
+        Snapshot(const T &initial) : mBuffers{ initial, initial } {}
+
+        T &write() { return mBuffers[1 - mFront]; }
+        const T &read() const { return mBuffers[mFront]; }
+        void publish() override { mFront = 1 - mFront; }
+
+    private:
+        T mBuffers[2];
+        int mFront = 0;
+    };
+
+    // The tasks of a frame with the resources each of them reads and writes. Tasks
+    // are declared in program order and only wait for the tasks they conflict
+    // with: the last writer of what they read or write, and the readers of what
+    // they write. Everything else runs in parallel on the job system.
+    class FrameGraph
+    {
+    public:
+        using Resource = uint32_t;
+        using TaskId = uint32_t;
+
+        class TaskBuilder
+        {
+        public:
+            TaskBuilder &reads(Resource resource) { mGraph.mTasks[mTask].reads.push_back(resource); mGraph.mIsCompiled = false; return *this; }
+            TaskBuilder &writes(Resource resource) { mGraph.mTasks[mTask].writes.push_back(resource); mGraph.mIsCompiled = false; return *this; }
+
+            // E.g. for tasks that make GL calls.
+            TaskBuilder &onMainThread() { mGraph.mTasks[mTask].isOnMainThread = true; return *this; }
+
+            TaskId id() const { return mTask; }
+
+        private:
+            friend class FrameGraph;
+            TaskBuilder(FrameGraph &graph, TaskId task) : mGraph(graph), mTask(task) {}
+            FrameGraph &mGraph;
+            TaskId mTask;
+        };
+
+        FrameGraph() = default;
+        FrameGraph(const FrameGraph &other) = delete;
+        FrameGraph &operator=(const FrameGraph &other) = delete;
+
+        // Returns the same resource for the same name.
+        Resource resource(const std::string &name);
+
+        TaskBuilder addTask(const std::string &name, std::function<void()> function);
+
+        // Starts the tasks on the job system and returns without waiting.
+        void start(JobSystem &jobs);
+        void wait(JobSystem &jobs) { jobs.wait(mFrame); }
+        void execute(JobSystem &jobs) { start(jobs); wait(jobs); }
+        bool isDone() const { return mFrame.isDone(); }
+
+        // Snapshots swapped by publish() when a frame is done.
+        void addSnapshot(AbstractSnapshot &snapshot) { mSnapshots.push_back(&snapshot); }
+        void publish();
+
+        const std::vector<TaskId> &dependencies(TaskId task);
+        const std::string &name(TaskId task) const { return mTasks[task].name; }
+        size_t taskCount() const { return mTasks.size(); }
+
+    private:
+        struct Task
+        {
+            std::string name;
+            std::function<void()> function;
+            std::vector<Resource> reads, writes;
+            std::vector<TaskId> dependencies, successors;
+            bool isOnMainThread = false;
+        };
+
+        void compile();
+        void launch(JobSystem &jobs, TaskId task);
+
+        std::vector<Task> mTasks;
+        std::unordered_map<std::string, Resource> mResources;
+        std::unique_ptr<std::atomic<uint32_t>[]> mRemaining;
+        std::vector<AbstractSnapshot *> mSnapshots;
+        JobSystem::Counter mFrame;
+        bool mIsCompiled = false;
+    };
+
+}}
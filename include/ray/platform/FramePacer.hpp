@@ -0,0 +1,78 @@
+#pragma once
+
+#include <ray/platform/Time.hpp>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace ray { namespace platform {
+
+    // Waits for the start of the next frame. The bulk of the wait is a sleep, but
+    // sleeps overshoot by up to a scheduler quantum, so the last stretch before the
+    // deadline is spent spinning. How long that stretch is comes from measuring
+    // how late sleeps actually wake up, at startup and after every frame.
+    class FramePacer
+    {
+        using Clock = std::chrono::steady_clock;
+
+    public:
+        FramePacer(sec period) : mPeriod(period), mDeadline(Clock::now()) { calibrate(); }
+
+        void setPeriod(sec period) { mPeriod = period; }
+        sec period() const { return mPeriod; }
+        sec spinThreshold() const { return mSpinThreshold; }
+
+        // Returns once the current frame has lasted a full period.
+        void wait()
+        {
+            auto deadline = mDeadline + std::chrono::duration_cast<Clock::duration>(mPeriod);
+            auto now = Clock::now();
+
+            // NOTE(cme): a late frame starts the schedule over instead of rushing the
+            //            next frames to catch up.
+            if (now >= deadline)
+            {
+                mDeadline = now;
+                return;
+            }
+
+            auto sleepTime = sec(deadline - now) - mSpinThreshold;
+            if (sleepTime > sec(0))
+            {
+                auto beforeSleep = Clock::now();
+                std::this_thread::sleep_for(sleepTime);
+                observe(sec(Clock::now() - beforeSleep) - sleepTime);
+            }
+
+            while (Clock::now() < deadline)
+                std::this_thread::yield();
+            mDeadline = deadline;
+        }
+
+    private:
+        void calibrate()
+        {
+            mSpinThreshold = minimumSpin();
+            for (int i = 0; i < 5; ++i)
+            {
+                auto before = Clock::now();
+                std::this_thread::sleep_for(1_msec);
+                observe(sec(Clock::now() - before) - sec(1_msec));
+            }
+        }
+
+        // Grows at once when a sleep is late, shrinks slowly when they get better.
+        void observe(sec oversleep)
+        {
+            auto wanted = std::min(maximumSpin(), std::max(minimumSpin(), oversleep * 1.25));
+            mSpinThreshold = wanted > mSpinThreshold ? wanted : mSpinThreshold * 0.99 + wanted * 0.01;
+        }
+
+        static sec minimumSpin() { return 200_usec; }
+        static sec maximumSpin() { return 4_msec; }
+
+        sec mPeriod, mSpinThreshold;
+        Clock::time_point mDeadline;
+    };
+
+}}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <ray/platform/Time.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ray { namespace platform {
+
+    // Keeps the durations of the last frames for averages and percentiles.
+    class FrameStatistics
+    {
+    public:
+        FrameStatistics(size_t capacity=256) : mCapacity(capacity), mNext(0), mSum(0) 
+        {
+            mSamples.reserve(capacity);
+        }
+
+        void add(sec sample)
+        {
+            if (mSamples.size() < mCapacity)
+            {
+                mSamples.push_back(sample);
+            }
+            else
+            {
+                mSum -= mSamples[mNext];
+                mSamples[mNext] = sample;
+            }
+            mSum += sample;
+            mNext = (mNext + 1) % mCapacity;
+        }
+
+        size_t count() const { return mSamples.size(); }
+        sec average() const { return mSamples.empty() ? sec(0) : mSum / (double)mSamples.size(); }
+
+        // Nearest rank percentile, e.g. percentile(0.99) is the p99 frame time.
+        sec percentile(double fraction) const
+        {
+            if (mSamples.empty())
+                return sec(0);
+            mSorted = mSamples;
+            auto rank = (size_t)std::ceil(fraction * mSorted.size());
+            auto index = std::min(mSorted.size() - 1, rank > 0 ? rank - 1 : 0);
+            std::nth_element(mSorted.begin(), mSorted.begin() + index, mSorted.end());
+            return mSorted[index];
+        }
+
+        sec p50() const { return percentile(0.50); }
+        sec p95() const { return percentile(0.95); }
+        sec p99() const { return percentile(0.99); }
+
+        sec maximum() const { return mSamples.empty() ? sec(0) : *std::max_element(mSamples.begin(), mSamples.end()); }
+
+    private:
+        size_t mCapacity, mNext;
+        sec mSum;
+        std::vector<sec> mSamples;
+        mutable std::vector<sec> mSorted;
+    };
+
+}}
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <ray/platform/FixedTimestep.hpp>
+#include <ray/platform/FrameGraph.hpp>
+#include <ray/platform/FramePacer.hpp>
+#include <ray/platform/FrameStatistics.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/Profiler.hpp>
 #include <ray/platform/Stopwatch.hpp>
 #include <ray/platform/Window.hpp>
-#include <vector>
-#include <thread>
+#include <algorithm>
+#include <functional>
 
 namespace ray { namespace platform {
 
@@ -19,54 +25,98 @@ namespace ray { namespace platform {
     public:
 
         GameLoop(Window &window, fps targetFPS, bool vSync=true) 
-            : mWindow(window), mFrameTimesSum(1_sec), mFrameCount(0), mTargetFPS(targetFPS), mLastFrameTimeIndex(0)
+            : mWindow(window), mPacer(1_sec/targetFPS), mFrameTime(1_sec/targetFPS), mWorkTime(0), mFrameCount(0), mTargetFPS(targetFPS)
         {
             window.swapInterval(vSync ? 1 : 0);
-            mFrameTimes.resize(targetFPS, 1_sec/mTargetFPS);            
         }
 
         void run(std::function<void(void)> doOneFrame)
         {
+            mStopwatch.lap();
             while ( !mWindow.shouldClose() )
             {
-                mStopwatch.lap();            
-                {
-                    mWindow.pollEvents();
-                    doOneFrame();
-                    mWindow.swapBuffers();        
-                }
-                mFrameTime = mStopwatch.lap();
+                mWindow.pollEvents();
+                doOneFrame();
+                mWindow.swapBuffers();        
+                endFrame();
+            }
+        }        
 
-                mFrameTimesSum += mFrameTime - mFrameTimes[mLastFrameTimeIndex];
-                mFrameTimes[mLastFrameTimeIndex] = mFrameTime;
-                mLastFrameTimeIndex = (mLastFrameTimeIndex+1) % mFrameTimes.size();
-                mFrameCount += 1;
-            
-                auto waitTime = (1_sec/mTargetFPS) - mFrameTime;
-                while(waitTime > 100_usec)
-                {
-                    std::this_thread::sleep_for(100_usec);
-                    waitTime -= 100_usec;
-                }
+        // Updates the simulation in fixed steps, as many as the measured frame time
+        // calls for, and renders with how far into the next step the frame is.
+        void run(sec step, std::function<void(sec)> update, std::function<void(float)> render)
+        {
+            FixedTimestep timestep(step);
+            mStopwatch.lap();
+            while ( !mWindow.shouldClose() )
+            {
+                mWindow.pollEvents();
+                timestep.advance(dt(), update);
+                render(timestep.alpha());
+                mWindow.swapBuffers();        
+                endFrame();
             }
         }        
+
+        // Simulates frame N+1 on the job system while the main thread renders frame N. 
+        // The renderer only reads the snapshots published at the end of the previous
+        // frame, the simulation writes the next ones.
+        void run(JobSystem &jobs, FrameGraph &simulation, std::function<void(void)> render)
+        {
+            simulation.execute(jobs);
+            simulation.publish();
+            mStopwatch.lap();
+            while ( !mWindow.shouldClose() )
+            {
+                mWindow.pollEvents();
+                simulation.start(jobs);
+                render();
+                mWindow.swapBuffers();
+                simulation.wait(jobs);
+                simulation.publish();
+                endFrame();
+            }
+        }
         
+        // Frame times are measured from the start of a frame to the start of the next, 
+        // the work time is the part of it spent before waiting for the next frame.
         sec lastFrameTime()           const { return mFrameTime; }
-        sec averageFrameTime()        const { return mFrameTimesSum / mTargetFPS; }
+        sec lastWorkTime()            const { return mWorkTime; }
+        sec averageFrameTime()        const { return mFrameTimes.count() ? mFrameTimes.average() : targetFrameTime(); }
+        sec averageWorkTime()         const { return mWorkTimes.average(); }
+        sec frameTimePercentile(double fraction) const { return mFrameTimes.percentile(fraction); }
         sec targetFrameTime()         const { return 1_sec / mTargetFPS; }
-        fps averageFramesPerSeconds() const { return fps((double)mTargetFPS / mFrameTimesSum.count()); }
+        fps averageFramesPerSeconds() const { return fps(1.0 / averageFrameTime().count()); }
         fps targetFramesPerSeconds()  const { return mTargetFPS; }
         u64 frameCount()              const { return mFrameCount; }
         
-        sec dt()                      const { return targetFrameTime(); }
+        const FrameStatistics &frameTimes() const { return mFrameTimes; }
+        const FrameStatistics &workTimes()  const { return mWorkTimes; }
+        
+        // NOTE(cme): capped so that a hitch, or a breakpoint, doesn't teleport everything.
+        sec dt()                      const { return std::min(mFrameTime, maximumDt()); }
 
     private:
+        static sec maximumDt() { return 250_msec; }
+
+        void endFrame()
+        {
+            mWorkTime = mStopwatch.elapsed();
+            mPacer.wait();
+            mFrameTime = mStopwatch.lap();
+
+            mWorkTimes.add(mWorkTime);
+            mFrameTimes.add(mFrameTime);
+            mFrameCount += 1;
+            PROFILE_FRAME();
+        }
+
         Window &mWindow;
+        FramePacer mPacer;
         platform::Stopwatch mStopwatch;
-        sec mFrameTime, mFrameTimesSum;
+        sec mFrameTime, mWorkTime;
+        FrameStatistics mFrameTimes, mWorkTimes;
         u64 mFrameCount;        
         fps mTargetFPS;
-        u16 mLastFrameTimeIndex;
-        std::vector<sec> mFrameTimes;
     };
 }}
\ No newline at end of file
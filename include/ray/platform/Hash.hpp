@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ray { namespace platform {
+
+    constexpr uint32_t fnv1a(const char *text, size_t length)
+    {
+        uint32_t hash = 0x811C9DC5u;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<uint8_t>(text[i]);
+            hash *= 0x01000193u;
+        }
+        return hash;
+    }
+
+    constexpr uint64_t fnv1a64(const char *text, size_t length, uint64_t hash=0xCBF29CE484222325ull)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<uint8_t>(text[i]);
+            hash *= 0x00000100000001B3ull;
+        }
+        return hash;
+    }
+
+    constexpr size_t length(const char *text)
+    {
+        size_t result = 0;
+        while (text[result]) ++result;
+        return result;
+    }
+
+    constexpr uint32_t fnv1a(const char *text) { return fnv1a(text, length(text)); }
+
+}}
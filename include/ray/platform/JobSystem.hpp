@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ray { namespace platform {
+
+    // Runs jobs on a fixed set of worker threads. Each worker owns a deque it pushes
+    // and pops at the back, idle workers steal from the front of the others. Threads
+    // that wait on a counter run jobs too instead of blocking, so waiting inside a
+    // job never deadlocks the pool.
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+        // Counts the jobs of a group that haven't finished yet.
+        class Counter
+        {
+        public:
+            Counter() : mValue(0) {}
+            Counter(const Counter &other) = delete;
+            Counter &operator=(const Counter &other) = delete;
+
+            bool isDone() const { return mValue.load(std::memory_order_acquire) == 0; }
+            uint32_t value() const { return mValue.load(std::memory_order_acquire); }
+
+        private:
+            friend class JobSystem;
+            std::atomic<uint32_t> mValue;
+        };
+
+        // By default, one worker per core besides the main thread.
+        JobSystem(size_t workerCount=defaultWorkerCount());
+        JobSystem(const JobSystem &other) = delete;
+        JobSystem &operator=(const JobSystem &other) = delete;
+        ~JobSystem();
+
+        void submit(Job job, Counter *counter=nullptr);
+
+        // Holds the job back until every job counted by 'dependency' has finished.
+        void submitAfter(const Counter &dependency, Job job, Counter *counter=nullptr);
+
+        // Runs other jobs until the counter reaches zero.
+        void wait(const Counter &counter);
+
+        // Splits [first, last) in chunks of at least 'grain' indices and calls
+        // function(chunkFirst, chunkLast) for each of them, returns when all are done.
+        template<typename Function>
+        void parallelFor(size_t first, size_t last, size_t grain, Function function)
+        {
+            if (first >= last)
+                return;
+            grain = grain ? grain : 1;
+            auto count = last - first;
+            auto chunkCount = (count + grain - 1) / grain;
+            if (chunkCount == 1)
+            {
+                function(first, last);
+                return;
+            }
+
+            Counter counter;
+            for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+            {
+                auto chunkFirst = first + chunk * grain;
+                auto chunkLast = chunkFirst + grain < last ? chunkFirst + grain : last;
+                submit([=, &function]() { function(chunkFirst, chunkLast); }, &counter);
+            }
+            function(first, first + grain);
+            wait(counter);
+        }
+
+        // Jobs that have to run on the main thread, e.g. because they make GL calls.
+        void submitToMainThread(Job job, Counter *counter=nullptr);
+
+        // Runs the main thread jobs queued so far, returns how many ran.
+        size_t runMainThreadJobs();
+
+        size_t workerCount() const { return mWorkers.size(); }
+        bool isMainThread() const { return std::this_thread::get_id() == mMainThread; }
+
+        static size_t defaultWorkerCount()
+        {
+            auto cores = std::thread::hardware_concurrency();
+            return cores > 1 ? cores - 1 : 1;
+        }
+
+    private:
+        struct Task
+        {
+            Job job;
+            Counter *counter;
+        };
+
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::thread thread;
+        };
+
+        struct Deferred
+        {
+            const Counter *dependency;
+            Task task;
+        };
+
+        void push(Task task);
+        bool pop(size_t worker, Task &task);
+        bool steal(size_t thief, Task &task);
+        bool runOne(size_t worker);
+        void run(Task &task);
+        void releaseDeferred();
+        void work(size_t worker);
+
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+        std::atomic<size_t> mNextWorker, mQueued;
+        std::atomic<bool> mIsRunning;
+        std::mutex mSleepMutex;
+        std::condition_variable mWakeUp;
+
+        std::mutex mDeferredMutex;
+        std::vector<Deferred> mDeferred;
+
+        std::mutex mMainThreadMutex;
+        std::deque<Task> mMainThreadTasks;
+        std::thread::id mMainThread;
+    };
+
+}}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ray { namespace platform { namespace lz4 {
+
+    // The LZ4 block format: fast to decode and good enough on meshes, fonts and
+    // uncompressed images. Compatible with LZ4_compress_default and
+    // LZ4_decompress_safe, without the frame format around it.
+
+    // The most a block of 'size' bytes can grow to.
+    constexpr size_t compressBound(size_t size) { return size + size / 255 + 16; }
+
+    // The most a block of 'size' bytes can decode to, each byte of a match length
+    // adds at most 255 bytes.
+    constexpr uint64_t decompressBound(uint64_t size) { return size * 255 + 16; }
+
+    // Returns the compressed size, or 0 if it doesn't fit in 'capacity'.
+    size_t compress(const uint8_t *source, size_t size, uint8_t *destination, size_t capacity);
+
+    // Returns false if 'source' isn't a valid block that decodes to exactly 'size' bytes.
+    bool decompress(const uint8_t *source, size_t sourceSize, uint8_t *destination, size_t size);
+
+    inline std::vector<uint8_t> compress(const uint8_t *source, size_t size)
+    {
+        std::vector<uint8_t> result(compressBound(size));
+        result.resize(compress(source, size, result.data(), result.size()));
+        return result;
+    }
+
+}}}
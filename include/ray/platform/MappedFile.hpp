@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ray { namespace platform { namespace fs {
+
+    // How a mapping is going to be read, passed on to the kernel (madvise).
+    enum class Access
+    {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed,
+    };
+
+    // A read-only view of a whole file, served straight from the page cache.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const std::string &filename, Access access=Access::Normal);
+        MappedFile(const MappedFile &other) = delete;
+        MappedFile(MappedFile &&other) { *this = std::move(other); }
+        MappedFile &operator=(const MappedFile &other) = delete;
+        MappedFile &operator=(MappedFile &&other);
+        ~MappedFile() { close(); }
+
+        // Unlike the constructor, doesn't panic when the file can't be mapped.
+        bool open(const std::string &filename, Access access=Access::Normal, std::string *error=nullptr);
+        void close();
+
+        // Hints at how part of the mapping is going to be read next.
+        void advise(Access access, size_t offset=0, size_t size=SIZE_MAX);
+
+        bool isOpen() const { return mIsOpen; }
+        const uint8_t *data() const { return mData; }
+        size_t size() const { return mSize; }
+
+    private:
+        const uint8_t *mData = nullptr;
+        size_t mSize = 0;
+        bool mIsOpen = false;
+#ifdef _WIN32
+        void *mFile = nullptr, *mMapping = nullptr;
+#endif
+    };
+
+    // The bytes of a file: owned by a buffer, kept alive by a mapping, or borrowed
+    // from something that outlives them, e.g. a mounted pack.
+    class FileData
+    {
+    public:
+        FileData() = default;
+        FileData(MappedFile file) : mFile(std::move(file)), mData(mFile.data()), mSize(mFile.size()), mIsValid(mFile.isOpen()) {}
+        FileData(std::vector<uint8_t> bytes) : mBytes(std::move(bytes)), mData(mBytes.data()), mSize(mBytes.size()), mIsValid(true) {}
+
+        static FileData borrow(const uint8_t *data, size_t size) { FileData result; result.mData = data; result.mSize = size; result.mIsValid = result.mIsBorrowed = true; return result; }
+        static FileData failed(std::string error) { FileData result; result.mError = std::move(error); return result; }
+
+        const uint8_t *data() const { return mData; }
+        size_t size() const { return mSize; }
+        bool isMapped() const { return mFile.isOpen(); }
+        bool isBorrowed() const { return mIsBorrowed; }
+        bool isValid() const { return mIsValid; }
+        const std::string &error() const { return mError; }
+
+    private:
+        // NOTE(cme): moving the mapping or the vector leaves their bytes where they are.
+        MappedFile mFile;
+        std::vector<uint8_t> mBytes;
+        const uint8_t *mData = nullptr;
+        size_t mSize = 0;
+        std::string mError;
+        bool mIsValid = false, mIsBorrowed = false;
+    };
+
+    // Maps the file, or copies it into memory. Either way, check isValid().
+    FileData mapFile(const std::string &filename, Access access=Access::Normal);
+    FileData readFile(const std::string &filename);
+
+    // Reads bytes in place through a std::istream, for parsers that want one.
+    class MemoryStreambuf : public std::streambuf
+    {
+    public:
+        MemoryStreambuf(const uint8_t *data, size_t size)
+        {
+            auto begin = const_cast<char *>(reinterpret_cast<const char *>(data));
+            setg(begin, begin, begin + size);
+        }
+    };
+
+}}}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ray { namespace platform {
+
+    // Two-level segregated fit (TLSF) allocator over a range of offsets. It does
+    // not own any memory, it only hands out [offset, offset+size) ranges inside
+    // [0, capacity), so it can manage GPU buffers as well as CPU arenas. free()
+    // runs in constant time and merges freed ranges with their free neighbours
+    // right away. allocate() finds a bin with bitmap scans in constant time, but
+    // when only the bin of the size itself has room left, it walks the free list
+    // of that bin, as long as the number of regions in it.
+    class OffsetAllocator
+    {
+    public:
+        using u32 = uint32_t;
+        static constexpr u32 NO_SPACE = 0xFFFFFFFF;
+
+        struct Allocation
+        {
+            u32 offset = NO_SPACE;
+            u32 node = NO_SPACE;
+            bool isValid() const { return offset != NO_SPACE; }
+        };
+
+        struct Statistics
+        {
+            u32 capacity = 0, usedSpace = 0, freeSpace = 0, largestFreeRegion = 0;
+            u32 allocationCount = 0, freeRegionCount = 0;
+            
+            // NOTE(cme): 0 when all the free space is in one region, close to 1 when it is scattered.
+            float fragmentation() const { return freeSpace ? 1.0f - float(largestFreeRegion) / float(freeSpace) : 0.0f; }
+        };
+
+        OffsetAllocator(u32 capacity);
+
+        Allocation allocate(u32 size);
+        void free(const Allocation &allocation);
+        void reset();
+
+        u32 sizeOf(const Allocation &allocation) const;
+        u32 capacity() const { return mCapacity; }
+        Statistics statistics() const;
+
+    private:
+        static constexpr u32 SECOND_LEVEL_BITS = 3;
+        static constexpr u32 SECOND_LEVEL_COUNT = 1 << SECOND_LEVEL_BITS;
+        static constexpr u32 FIRST_LEVEL_COUNT = 32;
+        
+        struct Node
+        {
+            u32 offset = 0, size = 0;
+            u32 previousPhysical = NO_SPACE, nextPhysical = NO_SPACE;
+            u32 previousFree = NO_SPACE, nextFree = NO_SPACE;
+            bool used = false;
+        };
+
+        u32 createNode(u32 offset, u32 size, u32 previousPhysical, u32 nextPhysical);
+        void releaseNode(u32 node);
+        void insertFree(u32 node);
+        void removeFree(u32 node);
+        u32 findFree(u32 size) const;
+        u32 findExactFit(u32 size) const;
+
+        u32 mCapacity, mUsedSpace, mAllocationCount;
+        std::vector<Node> mNodes;
+        std::vector<u32> mUnusedNodes;
+        u32 mFirstLevelBitmap;
+        std::array<u32, FIRST_LEVEL_COUNT> mSecondLevelBitmaps;
+        std::array<std::array<u32, SECOND_LEVEL_COUNT>, FIRST_LEVEL_COUNT> mFreeLists;
+    };
+
+}}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <ray/platform/MappedFile.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ray { namespace platform { namespace fs {
+
+    enum class Compression : uint32_t
+    {
+        None = 0,
+        Lz4 = 1,
+    };
+
+    // A pack is many files in one, mapped once and looked up by the hash of their
+    // path. It is laid out as:
+    //
+    //      header | entry data, 16 bytes aligned | table of contents | hash index | names
+    //
+    // The index is an open addressing table of entry indices + 1, with 0 for an
+    // empty slot, probed linearly from the path hash.
+    namespace pack
+    {
+        constexpr uint32_t VERSION = 1;
+        constexpr size_t DATA_ALIGNMENT = 16;
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version, entryCount;
+            uint64_t tocOffset, indexOffset, indexSize, namesOffset, namesSize;
+            uint64_t reserved;
+        };
+
+        struct Entry
+        {
+            uint64_t pathHash, contentHash;
+            uint64_t offset, storedSize, size;
+            uint32_t nameOffset, nameSize;
+            Compression compression;
+            uint32_t reserved;
+        };
+
+        static_assert(sizeof(Header) == 64, "the pack header has a fixed size");
+        static_assert(sizeof(Entry) == 56, "pack entries have a fixed size");
+
+        // Paths are looked up with '/' separators and without a leading './'.
+        std::string normalize(const std::string &path);
+        uint64_t hashPath(const std::string &normalizedPath);
+        uint64_t hashContent(const uint8_t *data, size_t size);
+    }
+
+    class PackWriter
+    {
+    public:
+        // Compressed entries that don't save at least an eighth of their size are
+        // stored as is. Adding a path twice replaces the first one.
+        void add(const std::string &path, const uint8_t *data, size_t size, Compression compression=Compression::Lz4);
+        bool addFile(const std::string &path, const std::string &filename, Compression compression=Compression::Lz4);
+
+        bool write(const std::string &filename, std::string *error=nullptr) const;
+
+        size_t entryCount() const { return mEntries.size(); }
+        uint64_t size() const;
+        uint64_t storedSize() const;
+
+    private:
+        struct Pending
+        {
+            std::string path;
+            std::vector<uint8_t> stored;
+            uint64_t size, contentHash;
+            Compression compression;
+        };
+
+        std::vector<Pending> mEntries;
+    };
+
+    class PackFile
+    {
+    public:
+        PackFile() = default;
+
+        // Checks the header and that every entry is inside the file.
+        bool open(const std::string &filename, std::string *error=nullptr);
+
+        const pack::Entry *find(const std::string &path) const;
+
+        // Uncompressed entries are borrowed from the mapping, valid as long as the
+        // pack is open.
+        FileData read(const pack::Entry &entry) const;
+        bool verify(const pack::Entry &entry) const;
+
+        size_t entryCount() const { return mHeader ? mHeader->entryCount : 0; }
+        const pack::Entry &entry(size_t index) const { return mEntries[index]; }
+        std::string name(const pack::Entry &entry) const { return std::string(mNames + entry.nameOffset, entry.nameSize); }
+        const std::string &filename() const { return mFilename; }
+
+    private:
+        MappedFile mFile;
+        std::string mFilename;
+        const pack::Header *mHeader = nullptr;
+        const pack::Entry *mEntries = nullptr;
+        const uint32_t *mIndex = nullptr;
+        const char *mNames = nullptr;
+    };
+
+    // Mounted packs are searched, the last mounted first, before the disk. Paths
+    // under 'prefix' are looked up in the pack without it, e.g. a pack built
+    // from res/ is mounted under "res/".
+    bool mount(const std::string &packFilename, const std::string &prefix="", std::string *error=nullptr);
+    void unmount(const std::string &packFilename);
+    void unmountAll();
+    bool isPacked(const std::string &path);
+
+    // Reads from a mounted pack if one has the path, maps the file otherwise.
+    // NOTE(cme): bytes borrowed from a pack must not outlive its unmount().
+    FileData load(const std::string &path, Access access=Access::Normal);
+
+}}}
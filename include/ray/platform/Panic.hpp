@@ -8,7 +8,7 @@ namespace ray { namespace platform {
     namespace details {
 
         template<typename ...Args>
-        [[ noreturn]] inline void _panic(const std::string &file, int line, const std::string &format, Args&&... args)
+        [[ noreturn]] inline void _panic(const char *file, int line, FormatString format, Args&&... args)
         {
             fprint(std::cerr, "%s:%d: ", file, line);
             fprintln(format, std::forward<Args>(args)...);
@@ -1,8 +1,8 @@
 #pragma once
 
+#include <ray/platform/Format.hpp>
 #include <iostream>
 #include <sstream>
-#include <boost/format.hpp>
 
 namespace ray { namespace platform {
     
@@ -12,11 +12,6 @@ namespace ray { namespace platform {
         
         template <typename T, typename... Args>
         inline void printHelper(std::ostream &out, T &&value, Args&&... args) { printHelper(out << std::forward<T>(value), std::forward<Args>(args)...); }        
-
-        inline std::string fprintHelper(boost::format &formatter) { return boost::str(formatter); }
-        
-        template <class T, class... Args>
-        inline std::string fprintHelper(boost::format &formatter, T &&value, Args &&... args) { return fprintHelper(formatter % std::forward<T>(value), std::forward<Args>(args)...); }    
     }
 
     template <typename... Args>
@@ -41,26 +36,30 @@ namespace ray { namespace platform {
     inline std::string cat(Args&&... args) { std::stringstream buffer; details::printHelper(buffer, std::forward<Args>(args)...); return buffer.str(); }
     
     template <typename... Args>
-    void fprint(std::ostream &out, const std::string &format, Args &&... args)
-    {
-        boost::format formatter(format);
-        out << details::fprintHelper(formatter, std::forward<Args>(args)...);
-    }
+    void fprint(std::ostream &out, FormatString format, Args &&... args) { formatTo(out, format, args...); }
     
     template <typename... Args>
-    void fprint(std::string const &format, Args &&... args) { fprint(std::cout, format, std::forward<Args>(args)...); }
+    void fprint(FormatString format, Args &&... args) { fprint(std::cout, format, std::forward<Args>(args)...); }
     
     template <typename... Args>
-    void fprintln(std::ostream &out, std::string const &format, Args &&... args) { fprint(out, format + "\n", std::forward<Args>(args)...); }
+    void fprintln(std::ostream &out, FormatString format, Args &&... args) 
+    { 
+        char buffer[256];
+        details::FormatWriter writer(buffer, sizeof(buffer), &out);
+        details::format(writer, format, args...);
+        writer.put('\n');
+        writer.flush();
+    }
     
     template <typename... Args>
-    void fprintln(std::string const &format, Args &&... args) { fprintln(std::cout, format, std::forward<Args>(args)...);  }
+    void fprintln(FormatString format, Args &&... args) { fprintln(std::cout, format, std::forward<Args>(args)...);  }
     
     template <typename... Args>
-    std::string fmt(std::string const &format, Args &&... args)
+    std::string fmt(FormatString format, Args &&... args)
     {
-        boost::format formatter(format);
-        return details::fprintHelper(formatter, std::forward<Args>(args)...);
+        std::string result;
+        formatTo(result, format, args...);
+        return result;
     } 
 
 }}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// NOTE(cme): set by the RAY_ENABLE_PROFILER CMake option, the zones compile to
+//            nothing without it.
+#ifndef RAY_ENABLE_PROFILER
+#define RAY_ENABLE_PROFILER 0
+#endif
+
+#define RAY_PROFILER_CONCAT_(a, b) a ## b
+#define RAY_PROFILER_CONCAT(a, b) RAY_PROFILER_CONCAT_(a, b)
+
+#if RAY_ENABLE_PROFILER
+    // NOTE(cme): the name is kept as a pointer, it has to be a string literal.
+    #define PROFILE_ZONE(name) ray::platform::ProfileZone RAY_PROFILER_CONCAT(__profileZone__, __COUNTER__)(name)
+    #define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+    #define PROFILE_FRAME() ray::platform::Profiler::instance().endFrame()
+#else
+    #define PROFILE_ZONE(name) do {} while (0)
+    #define PROFILE_FUNCTION() do {} while (0)
+    #define PROFILE_FRAME() do {} while (0)
+#endif
+
+namespace ray { namespace platform {
+
+    // Collects timed zones from every thread. Zones are written into a ring buffer
+    // owned by their thread without taking any lock, and drained once per frame by
+    // endFrame(), which aggregates them per name and keeps the most recent ones for
+    // a Chrome trace (chrome://tracing or https://ui.perfetto.dev).
+    class Profiler
+    {
+    public:
+        struct Event
+        {
+            const char *name;
+            uint64_t begin, end;
+            uint32_t depth;
+        };
+
+        struct ZoneStatistics
+        {
+            const char *name;
+            uint32_t calls;
+            uint64_t inclusive, exclusive, maximum;
+        };
+
+        // Written by its thread only, read by whoever calls endFrame().
+        class ThreadBuffer
+        {
+        public:
+            static constexpr size_t CAPACITY = 1 << 14;
+
+            ThreadBuffer(uint32_t threadIndex) : mHead(0), mTail(0), mDropped(0), mDepth(0), mThreadIndex(threadIndex) {}
+
+            uint32_t enter() { return mDepth++; }
+
+            void leave(const char *name, uint64_t begin, uint32_t depth)
+            {
+                --mDepth;
+                auto head = mHead.load(std::memory_order_relaxed);
+                if (head - mTail.load(std::memory_order_acquire) == CAPACITY)
+                {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                mEvents[head % CAPACITY] = Event{ name, begin, now(), depth };
+                mHead.store(head + 1, std::memory_order_release);
+            }
+
+        private:
+            friend class Profiler;
+            Event mEvents[CAPACITY];
+            std::atomic<uint64_t> mHead, mTail, mDropped;
+            uint32_t mDepth, mThreadIndex;
+            std::vector<uint64_t> mChildTime;
+        };
+
+        static Profiler &instance();
+
+        static uint64_t now()
+        {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static ThreadBuffer &threadBuffer()
+        {
+            static thread_local ThreadBuffer *buffer = nullptr;
+            if (!buffer)
+                buffer = &instance().registerThread();
+            return *buffer;
+        }
+
+        // Drains every thread and replaces the statistics of the last frame.
+        void endFrame();
+
+        const std::vector<ZoneStatistics> &lastFrame() const { return mLastFrame; }
+        uint64_t frameCount() const { return mFrameCount; }
+        uint64_t droppedEvents() const;
+
+        // Keeps at most that many zones for the trace, oldest first to go.
+        void setTraceCapacity(size_t capacity) { mTraceCapacity = capacity; }
+        void writeChromeTrace(std::ostream &out) const;
+        void writeChromeTrace(const std::string &filename) const;
+        void clearTrace() { mTrace.clear(); }
+
+        // A named row of the trace for zones timed by something other than a thread,
+        // e.g. the GPU. Their events are added from the thread that calls endFrame().
+        uint32_t addTrack(const char *name);
+        void addTraceEvent(uint32_t track, const Event &event) { if (mTraceCapacity > 0) mTrace.push_back(TraceEvent{ event, track }); }
+
+    private:
+        struct TraceEvent
+        {
+            Event event;
+            uint32_t thread;
+        };
+
+        Profiler() = default;
+        ThreadBuffer &registerThread();
+        void drain(ThreadBuffer &buffer, std::unordered_map<const char *, size_t> &indices);
+
+        mutable std::mutex mThreadsMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> mThreads;
+        std::vector<std::pair<uint32_t, const char *>> mTracks;
+        uint32_t mNextTrack = 0;
+        std::vector<ZoneStatistics> mLastFrame;
+        std::deque<TraceEvent> mTrace;
+        size_t mTraceCapacity = 1 << 16;
+        uint64_t mFrameCount = 0;
+    };
+
+    class ProfileZone
+    {
+    public:
+        ProfileZone(const char *name) : mBuffer(Profiler::threadBuffer()), mName(name), mDepth(mBuffer.enter()), mBegin(Profiler::now()) {}
+        ProfileZone(const ProfileZone &other) = delete;
+        ProfileZone &operator=(const ProfileZone &other) = delete;
+        ~ProfileZone() { mBuffer.leave(mName, mBegin, mDepth); }
+
+    private:
+        Profiler::ThreadBuffer &mBuffer;
+        const char *mName;
+        uint32_t mDepth;
+        uint64_t mBegin;
+    };
+
+}}
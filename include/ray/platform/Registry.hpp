@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ray/platform/Hash.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace ray { namespace platform {
+
+    // Shares resources between their users: the first acquire() of a key loads the
+    // resource, later ones return the same instance for as long as someone still
+    // holds it. The registry only keeps weak references, so a resource is released
+    // with its last user and loaded again on the next acquire().
+    // NOTE(cme): not thread safe, resources are expected to be acquired on the GL thread.
+    template<typename T>
+    class Registry
+    {
+    public:
+        using Key = uint64_t;
+        using SizeOf = std::function<size_t(const T&)>;
+
+        struct Statistics
+        {
+            size_t requests = 0, loads = 0, hits = 0;
+            size_t liveResources = 0, liveBytes = 0, savedBytes = 0;
+            sec loadTime = sec(0), savedTime = sec(0);
+        };
+
+        Registry(SizeOf sizeOf=[](const T&) { return size_t(0); }) : mSizeOf(std::move(sizeOf)) {}
+
+        static Key key(const std::string &source) { return fnv1a64(source.data(), source.size()); }
+        static Key key(const void *data, size_t size, Key seed=0xCBF29CE484222325ull) { return fnv1a64(reinterpret_cast<const char *>(data), size, seed); }
+
+        template<typename Loader>
+        std::shared_ptr<T> acquire(Key key, Loader &&load)
+        {
+            ++mStatistics.requests;
+            auto &entry = mEntries[key];
+            if (auto resource = entry.resource.lock())
+            {
+                ++mStatistics.hits;
+                mStatistics.savedTime += entry.loadTime;
+                return resource;
+            }
+
+            Stopwatch stopwatch;
+            auto resource = std::make_shared<T>(load());
+            entry.loadTime = stopwatch.lap();
+            entry.resource = resource;
+            entry.size = mSizeOf(*resource);
+            ++mStatistics.loads;
+            mStatistics.loadTime += entry.loadTime;
+            return resource;
+        }
+
+        template<typename Loader>
+        std::shared_ptr<T> acquire(const std::string &source, Loader &&load)
+        {
+            return acquire(key(source), std::forward<Loader>(load));
+        }
+
+        // Drops the entries of resources that no one uses anymore.
+        void purge()
+        {
+            for (auto entry = mEntries.begin(); entry != mEntries.end();)
+                entry = entry->second.resource.expired() ? mEntries.erase(entry) : std::next(entry);
+        }
+
+        // Live and saved bytes are measured now, the counters and times since creation.
+        Statistics statistics() const
+        {
+            auto result = mStatistics;
+            for (auto &entry : mEntries)
+            {
+                auto users = (size_t)entry.second.resource.use_count();
+                if (users == 0)
+                    continue;
+                ++result.liveResources;
+                result.liveBytes += entry.second.size;
+                result.savedBytes += (users - 1) * entry.second.size;
+            }
+            return result;
+        }
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<T> resource;
+            size_t size = 0;
+            sec loadTime = sec(0);
+        };
+
+        SizeOf mSizeOf;
+        std::unordered_map<Key, Entry> mEntries;
+        Statistics mStatistics;
+    };
+
+}}
@@ -20,6 +20,11 @@ namespace ray { namespace platform {
 			return result;
 		}
 
+		sec elapsed() const
+		{
+			return HighResClock::now() - mStart;
+		}
+
 	private:
 		TimePoint mStart;
 	};
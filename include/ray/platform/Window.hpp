@@ -44,6 +44,7 @@ namespace ray { namespace platform {
 
             makeContextCurrent();
             gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
+            loadOpenGLEntryPoints((GLADloadproc) glfwGetProcAddress);
             swapInterval(0);
             setUserPointer<Window>(*this);                    
 
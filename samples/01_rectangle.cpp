@@ -30,14 +30,14 @@ int main()
     auto quad   = VertexArray();
     auto shader = ShaderProgram(VERTEX_SHADER, FRAGMENT_SHADER);
     
-    quad.bindAttribute(shader.getAttribute<vec2>("vertPosition"), VertexBuffer<f32,2>{
+    quad.bindAttribute(shader.getAttribute<vec2>("vertPosition"_a), VertexBuffer<f32,2>{
         -0.5f, -0.5f, // bottom left
         -0.5f,  0.5f, // top left
          0.5f, -0.5f, // bottom right
          0.5f,  0.5f  // top right
     });
 
-    quad.bindAttribute(shader.getAttribute<vec4>("vertColor"), VertexBuffer<Color,1>{ RED, GREEN, BLUE, YELLOW }, true);
+    quad.bindAttribute(shader.getAttribute<vec4>("vertColor"_a), VertexBuffer<Color,1>{ RED, GREEN, BLUE, YELLOW }, true);
 
     glClearColor(0.0f, 0.2f, 0.2f, 0.0f);    
 
@@ -43,9 +43,9 @@ int main()
          0.5f,  0.5f,   1.0f, 0.0f, // top right
     });
     
-    quad.bindAttributeAtOffset(0, shader.getAttribute<vec2>("vertPosition"), vbo);
-    quad.bindAttributeAtOffset(2, shader.getAttribute<vec2>("vertTexCoord"), vbo);
-    shader.getUniform<sampler2D>("quadTexture").set(texture.bind(GL_TEXTURE0));
+    quad.bindAttributeAtOffset(0, shader.getAttribute<vec2>("vertPosition"_a), vbo);
+    quad.bindAttributeAtOffset(2, shader.getAttribute<vec2>("vertTexCoord"_a), vbo);
+    shader.getUniform<sampler2D>("quadTexture"_u).set(texture.bind(GL_TEXTURE0));
     
     glClearColor(0.0f, 0.2f, 0.2f, 0.0f);    
 
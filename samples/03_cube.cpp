@@ -50,16 +50,16 @@ public:
     CubeRenderer(const Window &window)
     {
         shader.load(VERTEX_SHADER, FRAGMENT_SHADER);    
-        texture = shader.getUniform<sampler2D>("diffuseTexture");
-        modelMatrix = shader.getUniform<mat4>("modelMatrix");
-        projectionMatrix = shader.getUniform<mat4>("projectionMatrix");    
+        texture = shader.getUniform<sampler2D>("diffuseTexture"_u);
+        modelMatrix = shader.getUniform<mat4>("modelMatrix"_u);
+        projectionMatrix = shader.getUniform<mat4>("projectionMatrix"_u);    
         projectionMatrix = perspective(43_deg, window.aspectRatio(), 0.01f, 1000.0f);        
     }
 
     void bind(const Cube &cube)
     {
-        cube.bindPosition(shader.getAttribute<vec3>("vertPosition"));
-        cube.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"));
+        cube.bindPosition(shader.getAttribute<vec3>("vertPosition"_a));
+        cube.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"_a));
     }
     
     void render(const Cube &cube)
@@ -44,17 +44,17 @@ public:
     MeshRenderer(const Window &window)
     {
         shader.load(VERTEX_SHADER, FRAGMENT_SHADER);    
-        texture = shader.getUniform<sampler2D>("diffuseTexture");
-        modelMatrix = shader.getUniform<mat4>("modelMatrix");
-        projectionMatrix = shader.getUniform<mat4>("projectionMatrix");    
+        texture = shader.getUniform<sampler2D>("diffuseTexture"_u);
+        modelMatrix = shader.getUniform<mat4>("modelMatrix"_u);
+        projectionMatrix = shader.getUniform<mat4>("projectionMatrix"_u);    
 
         projectionMatrix = perspective(43_deg, window.aspectRatio(), 0.01f, 1000.0f);
     }
 
     void bind(const Mesh &mesh) const
     {
-        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"));
-        mesh.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"));            
+        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"_a));
+        mesh.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"_a));            
     }
 
     void render(const TransformableMesh &mesh) const
@@ -89,12 +89,19 @@ int main()
 
     renderer.bind(mesh);
 
-    loop.run([&]() 
+    // The teapot turns at the same speed whatever the frame rate, in steps of 1/120th of a second.
+    loop.run(1_sec/120, [&](sec) 
+    {
+        mesh.rotate(vec3(0,1,0), 1_deg);
+    },
+    [&](float) 
     {
         renderer.render(mesh);
-        mesh.rotate(vec3(0,1,0), 2_deg);
         if (loop.frameCount()%60 == 0)
-            fprintln("average frame time = %1%msec", 1000*loop.averageFrameTime().count());
+            fprintln("frame time: average %.3fmsec, p50 %.3fmsec, p95 %.3fmsec, p99 %.3fmsec (work %.3fmsec)", 
+                1000*loop.averageFrameTime().count(), 1000*loop.frameTimePercentile(0.50).count(), 
+                1000*loop.frameTimePercentile(0.95).count(), 1000*loop.frameTimePercentile(0.99).count(),
+                1000*loop.averageWorkTime().count());
     });
 
     return EXIT_SUCCESS;
@@ -50,17 +50,17 @@ public:
     {
         (void)window;
         shader.load(VERTEX_SHADER, FRAGMENT_SHADER);    
-        texture = shader.getUniform<sampler2D>("diffuseTexture");
-        modelMatrix = shader.getUniform<mat4>("modelMatrix");
-        projectionMatrix = shader.getUniform<mat4>("projectionMatrix");    
-        viewMatrix = shader.getUniform<mat4>("viewMatrix");
+        texture = shader.getUniform<sampler2D>("diffuseTexture"_u);
+        modelMatrix = shader.getUniform<mat4>("modelMatrix"_u);
+        projectionMatrix = shader.getUniform<mat4>("projectionMatrix"_u);    
+        viewMatrix = shader.getUniform<mat4>("viewMatrix"_u);
         projectionMatrix = camera.projectionMatrix();
     }
 
     void bind(const Mesh &mesh) const
     {
-        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"));
-        mesh.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"));            
+        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"_a));
+        mesh.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"_a));            
     }
 
     void render(const Camera &camera, const TransformableMesh &mesh) const
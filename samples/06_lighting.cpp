@@ -7,6 +7,7 @@
 #include <ray/entities/TransformableMesh.hpp>
 #include <ray/components/Movable.hpp>
 #include <cstdlib>
+#include <cstddef>
 
 using namespace ray::platform;
 using namespace ray::gl;
@@ -27,6 +28,24 @@ struct Material
     float reflectivity, shineDamper;
 };
 
+struct PerFrame
+{
+    mat4 projectionMatrix;
+    vec4 lightColor;
+    vec3 lightPosition;
+    using std140 = ray::gl::std140::Layout<mat4, vec4, vec3>;
+    static constexpr auto offsets() { return ray::gl::std140::offsets(offsetof(PerFrame, projectionMatrix), offsetof(PerFrame, lightColor), offsetof(PerFrame, lightPosition)); }
+};
+
+struct PerMaterial
+{
+    vec4 modelColor;
+    float reflectivity;
+    float shineDamper;
+    using std140 = ray::gl::std140::Layout<vec4, float, float>;
+    static constexpr auto offsets() { return ray::gl::std140::offsets(offsetof(PerMaterial, modelColor), offsetof(PerMaterial, reflectivity), offsetof(PerMaterial, shineDamper)); }
+};
+
 class MeshRenderer
 {
     static constexpr auto VERTEX_SHADER = GLSL(330, 
@@ -36,9 +55,14 @@ class MeshRenderer
         out vec3 lightVector;
         out vec3 cameraVector;
 
+        layout(std140, row_major) uniform PerFrame
+        {
+            mat4 projectionMatrix;
+            vec4 lightColor;
+            vec3 lightPosition;
+        };
+
         uniform mat4 modelMatrix;
-        uniform mat4 projectionMatrix;
-        uniform vec3 lightPosition;  
 
         void main() 
         { 
@@ -56,10 +80,19 @@ class MeshRenderer
         in  vec3 cameraVector;        
         out vec4 color;
 
-        uniform vec4 modelColor;        
-        uniform vec4 lightColor;        
-        uniform float reflectivity;
-        uniform float shineDamper;
+        layout(std140, row_major) uniform PerFrame
+        {
+            mat4 projectionMatrix;
+            vec4 lightColor;
+            vec3 lightPosition;
+        };
+
+        layout(std140) uniform PerMaterial
+        {
+            vec4 modelColor;
+            float reflectivity;
+            float shineDamper;
+        };
 
         void main() 
         {     
@@ -75,38 +108,30 @@ class MeshRenderer
     );
 
 public:
-    MeshRenderer(const Window &window)
+    MeshRenderer(const Window &window) : perFrame(0), perMaterial(1)
     {
         shader.load(VERTEX_SHADER, FRAGMENT_SHADER);    
-        modelMatrix = shader.getUniform<mat4>("modelMatrix");
-        projectionMatrix = shader.getUniform<mat4>("projectionMatrix");    
-        modelColor = shader.getUniform<vec4>("modelColor");
-        lightColor = shader.getUniform<vec4>("lightColor");
-        lightPosition = shader.getUniform<vec3>("lightPosition");
-        reflectivity = shader.getUniform<float>("reflectivity");
-        shineDamper = shader.getUniform<float>("shineDamper");
-
+        shader.bindUniformBlock("PerFrame", perFrame);
+        shader.bindUniformBlock("PerMaterial", perMaterial);
+        modelMatrix = shader.getUniform<mat4>("modelMatrix"_u);
         projectionMatrix = perspective(43_deg, window.aspectRatio(), 0.01f, 1000.0f);
     }
 
     void bind(const Mesh &mesh) const
     {
-        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"));
-        mesh.bindNormal(shader.getAttribute<vec3>("vertNormal"));
+        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"_a));
+        mesh.bindNormal(shader.getAttribute<vec3>("vertNormal"_a));
     }
 
-    void render(const TransformableMesh &mesh, const Material &material, const Light &light) const
+    void render(const TransformableMesh &mesh, const Material &material, const Light &light)
     {
         glClearColor(0.0f, 0.2f, 0.2f, 0.0f);    
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         shader.start();
         glEnable(GL_DEPTH_TEST);
+        perFrame.set({ projectionMatrix, light.color, light.position() });
+        perMaterial.set({ material.color, material.reflectivity, material.shineDamper });
         modelMatrix.set(mesh.modelMatrix());
-        modelColor.set(material.color);
-        reflectivity.set(material.reflectivity);
-        shineDamper.set(material.shineDamper);
-        lightColor.set(light.color);
-        lightPosition.set(light.position());
         mesh.draw();
         glDisable(GL_DEPTH_TEST);
         shader.stop();
@@ -114,10 +139,10 @@ public:
 
 private:
     ShaderProgram shader;
-    Uniform<mat4> modelMatrix, projectionMatrix;
-    Uniform<vec4> modelColor, lightColor;
-    Uniform<vec3> lightPosition;
-    Uniform<float> reflectivity, shineDamper;
+    UniformBlock<PerFrame> perFrame;
+    UniformBlock<PerMaterial> perMaterial;
+    Uniform<mat4> modelMatrix;
+    mat4 projectionMatrix;
 };
 
 int main()
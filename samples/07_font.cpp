@@ -49,13 +49,13 @@ public:
             0.0f, 0.0f,   1.0f, 1.0f, // bottom right
             0.0f, 0.0f,   1.0f, 0.0f, // top right
         });
-        mQuad.bindAttributeAtOffset(0, mShader.getAttribute<vec2>("vertPosition"), mVertexBuffer);
-        mQuad.bindAttributeAtOffset(2, mShader.getAttribute<vec2>("vertTexCoord"), mVertexBuffer);            
+        mQuad.bindAttributeAtOffset(0, mShader.getAttribute<vec2>("vertPosition"_a), mVertexBuffer);
+        mQuad.bindAttributeAtOffset(2, mShader.getAttribute<vec2>("vertTexCoord"_a), mVertexBuffer);            
         mAllWhite.load(WHITE);
 
-        mTextColor = mShader.getUniform<vec4>("textColor");
-        mQuadTexture = mShader.getUniform<sampler2D>("quadTexture");
-        mTransform = mShader.getUniform<mat4>("transform");
+        mTextColor = mShader.getUniform<vec4>("textColor"_u);
+        mQuadTexture = mShader.getUniform<sampler2D>("quadTexture"_u);
+        mTransform = mShader.getUniform<mat4>("transform"_u);
     }
 
     static ivec2 getViewport()
@@ -4,6 +4,7 @@
 #include <ray/platform/GameLoop.hpp>
 #include <ray/platform/Print.hpp>
 #include <ray/components/TextureAtlas.hpp>
+#include <ray/gl/UploadRing.hpp>
 #include <ray/assets/Font.hpp>
 #include <unordered_map>
 #include <cstdlib>
@@ -17,7 +18,7 @@ using namespace ray::components;
 class CachedFont : public Font
 {
 public:
-    CachedFont(const std::string &filename, int lineHeight) : Font(filename, lineHeight), mGlyphAtlas(1) {}
+    CachedFont(const std::string &filename, int lineHeight, UploadRing &ring) : Font(filename, lineHeight), mGlyphAtlas(1), mRing(ring) {}
 
     const rect2 &getGlyphTextureCoordinates(u16 index)
     {
@@ -26,10 +27,17 @@ public:
         return (mGlyphCache[index] = mGlyphAtlas.add(rasterizeGlyph(index)));
     }
 
-    const Texture &glyphAtlas() const { return mGlyphAtlas; }
+    // NOTE(cme): the new glyphs are staged in the ring, which has to issue them before the atlas is bound.
+    const Texture &glyphAtlas() 
+    { 
+        mGlyphAtlas.flush(mRing); 
+        mRing.flush(); 
+        return mGlyphAtlas; 
+    }
 
 private:
     TextureAtlas mGlyphAtlas;    
+    UploadRing &mRing;
     std::unordered_map<u16, rect2> mGlyphCache;    
 };
 
@@ -72,12 +80,12 @@ public:
     {        
         mVertexBuffer.reserve(MAX_LETTERS * N_FLOATS_PER_LETTER, GL_STREAM_DRAW);
         mIndexBuffer.reserve(MAX_LETTERS * N_INDICES_PER_LETTER);        
-        mQuads.bindAttributeAtOffset(0, mShader.getAttribute<vec2>("vertPosition"), mVertexBuffer);
-        mQuads.bindAttributeAtOffset(2, mShader.getAttribute<vec2>("vertTexCoord"), mVertexBuffer);            
+        mQuads.bindAttributeAtOffset(0, mShader.getAttribute<vec2>("vertPosition"_a), mVertexBuffer);
+        mQuads.bindAttributeAtOffset(2, mShader.getAttribute<vec2>("vertTexCoord"_a), mVertexBuffer);            
         mQuads.bindIndices(mIndexBuffer);
-        mTextColor = mShader.getUniform<vec4>("textColor");
-        mQuadsTexture = mShader.getUniform<sampler2D>("quadTexture");
-        mTransform = mShader.getUniform<mat4>("transform");
+        mTextColor = mShader.getUniform<vec4>("textColor"_u);
+        mQuadsTexture = mShader.getUniform<sampler2D>("quadTexture"_u);
+        mTransform = mShader.getUniform<mat4>("transform"_u);
 
         auto mappedIndices = mIndexBuffer.map(GL_WRITE_ONLY);
         auto index = 0;
@@ -166,17 +174,20 @@ int main()
 {
     auto window    = Window(1920, 1080, "Text Sample");
     auto loop      = GameLoop(window, 60);    
-    auto small     = CachedFont("res/fonts/Roboto-Regular.ttf", 50);
-    auto big       = CachedFont("res/fonts/Roboto-Regular.ttf", 350);
+    UploadRing ring(8 << 20);
+    auto small     = CachedFont("res/fonts/Roboto-Regular.ttf", 50, ring);
+    auto big       = CachedFont("res/fonts/Roboto-Regular.ttf", 350, ring);
     auto renderer1 = TextRenderer();
     auto renderer2 = TextRenderer();
     auto renderer3 = TextRenderer();
 
+    auto text      = std::string();
+
     glClearColor(0.0f, 0.2f, 0.2f, 0.0f);    
     loop.run([&]() 
     {   
         glClear(GL_COLOR_BUFFER_BIT);
-        auto text = fmt("average frame time = %6.3fmsec", 1000*loop.averageFrameTime().count());
+        formatTo(text, "average frame time = %6.3fmsec", 1000*loop.averageFrameTime().count());
 #ifdef FAST        
         renderer1.renderText(vec2(2,2), small, BLACK, text);
         renderer2.renderText(vec2(0,0), small, YELLOW, text);
@@ -191,6 +202,7 @@ int main()
         renderer1.renderText(vec2(0,0), small, YELLOW, text);
         renderer1.renderText(vec2(100,100), big, RED, "Hello World!!");
 #endif        
+        ring.endFrame();
     });
 
     return EXIT_SUCCESS;
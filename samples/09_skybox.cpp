@@ -57,10 +57,10 @@ class SkyboxRenderer
 public:
     SkyboxRenderer() : mShader(VERTEX_SHADER, FRAGMENT_SHADER) 
     {
-        projection = mShader.getUniform<mat4>("projection");
-        view       = mShader.getUniform<mat4>("view");
-        cubeMap    = mShader.getUniform<samplerCube>("cubeMap");
-        position   = mShader.getAttribute<vec3>("vertPosition");
+        projection = mShader.getUniform<mat4>("projection"_u);
+        view       = mShader.getUniform<mat4>("view"_u);
+        cubeMap    = mShader.getUniform<samplerCube>("cubeMap"_u);
+        position   = mShader.getAttribute<vec3>("vertPosition"_a);
     }
 
     void bind(const Skybox &skybox)
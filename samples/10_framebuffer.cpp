@@ -3,6 +3,7 @@
 #include <ray/gl/VertexArray.hpp>
 #include <ray/gl/ShaderProgram.hpp>
 #include <ray/gl/Texture.hpp>
+#include <ray/gl/RenderTargetPool.hpp>
 #include <ray/components/Transformable.hpp>
 #include <cstdlib>
 
@@ -47,19 +48,25 @@ class CubeRenderer
     );
 
 public:
-    CubeRenderer(const Window &window)
+    CubeRenderer()
     {
         shader.load(VERTEX_SHADER, FRAGMENT_SHADER);    
-        texture = shader.getUniform<sampler2D>("diffuseTexture");
-        modelMatrix = shader.getUniform<mat4>("modelMatrix");
-        projectionMatrix = shader.getUniform<mat4>("projectionMatrix");    
-        projectionMatrix = perspective(43_deg, window.aspectRatio(), 0.01f, 1000.0f);        
+        texture = shader.getUniform<sampler2D>("diffuseTexture"_u);
+        modelMatrix = shader.getUniform<mat4>("modelMatrix"_u);
+        projectionMatrix = shader.getUniform<mat4>("projectionMatrix"_u);    
+    }
+
+    void resize(int width, int height)
+    {
+        shader.start();
+        projectionMatrix = perspective(43_deg, (float)width / (float)height, 0.01f, 1000.0f);        
+        shader.stop();
     }
 
     void bind(const Cube &cube)
     {
-        cube.bindPosition(shader.getAttribute<vec3>("vertPosition"));
-        cube.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"));
+        cube.bindPosition(shader.getAttribute<vec3>("vertPosition"_a));
+        cube.bindTexCoord(shader.getAttribute<vec2>("vertTexCoord"_a));
     }
     
     void render(const Cube &cube)
@@ -79,13 +86,65 @@ private:
     Uniform<mat4> modelMatrix, projectionMatrix, viewMatrix;
 };
 
+// Draws a texture over the whole viewport with a vignette on top.
+class PostRenderer
+{
+    static constexpr auto VERTEX_SHADER = GLSL(330, 
+        in  vec2 vertPosition;
+        out vec2 fragTexCoord;
+        void main() 
+        { 
+            fragTexCoord = vertPosition * 0.5 + 0.5;
+            gl_Position = vec4(vertPosition,0,1); 
+        }
+    );
+    
+    static constexpr auto FRAGMENT_SHADER = GLSL(330,
+        in  vec2 fragTexCoord;
+        out vec4 color;
+        uniform sampler2D scene;
+        void main() 
+        {                         
+            float vignette = 1.0 - 0.8 * dot(fragTexCoord - 0.5, fragTexCoord - 0.5);
+            color = vec4(texture(scene, fragTexCoord).rgb * vignette, 1.0);
+        }
+    );
+
+public:
+    PostRenderer() : shader(VERTEX_SHADER, FRAGMENT_SHADER), vbo({ -1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, -1.0f,  1.0f, 1.0f })
+    {
+        scene = shader.getUniform<sampler2D>("scene"_u);
+        quad.bindAttribute(shader.getAttribute<vec2>("vertPosition"_a), vbo);
+    }
+
+    void render(const RenderTarget &target)
+    {
+        shader.start();
+        scene.set(target.bind(GL_TEXTURE0));
+        quad.bind();
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        quad.unbind();
+        shader.stop();
+    }
+
+private:
+    ShaderProgram shader;
+    VertexArray quad;
+    VertexBuffer<f32,2> vbo;
+    Uniform<sampler2D> scene;
+};
+
 int main()
 {    
-    auto window   = Window(1920, 1080, "Cube Sample");
-    auto renderer = CubeRenderer(window);
-    auto cube     = Cube("res/images/awesomeface.png");
+    constexpr int SAMPLES = 4;
 
-    panicif(180_deg != PI, "oops");
+    auto window   = Window(1920, 1080, "Framebuffer Sample");
+    auto renderer = CubeRenderer();
+    auto post     = PostRenderer();
+    auto cube     = Cube("res/images/awesomeface.png");
+    auto pool     = RenderTargetPool();
+    auto frame    = 0;
+    Framebuffer multisampled, single;
 
     renderer.bind(cube);
 
@@ -95,13 +154,45 @@ int main()
 
     while (!window.shouldClose())
     {
+        int width, height;
+        window.getFrameBufferSize(width, height);
+        renderer.resize(width, height);
+
+        // The scene is rendered multisampled, resolved into a texture, and the texture 
+        // is drawn on screen by the post effect. All three targets come from the pool 
+        // so they are only allocated again when the window changes size, attaching
+        // them again every frame is cheap.
+        pool.beginFrame();
+        auto &color    = pool.acquire(width, height, GL_RGBA8, SAMPLES);
+        auto &depth    = pool.acquire(width, height, GL_DEPTH24_STENCIL8, SAMPLES);
+        auto &resolved = pool.acquire(width, height, GL_RGBA8);
+
+        multisampled.attach(GL_COLOR_ATTACHMENT0, color);
+        multisampled.attach(Framebuffer::depthAttachment(depth), depth);
+        single.attach(GL_COLOR_ATTACHMENT0, resolved);
+        panicif(!multisampled.isComplete() || !single.isComplete(), "incomplete framebuffer");
+
+        multisampled.start();
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         renderer.render(cube);
+        multisampled.resolve(single);
+
+        single.unbind();
+        glViewport(0, 0, width, height);
+        glClear(GL_COLOR_BUFFER_BIT);
+        post.render(resolved);
         cube.update();
 
+        if (++frame % 60 == 0)
+        {
+            auto statistics = pool.statistics();
+            fprintln("render targets: %d alive, %d bytes (peak %d), %d allocations, %d reuses, %d evictions",
+                statistics.targets, statistics.bytes, statistics.peakBytes, statistics.allocations, statistics.reuses, statistics.evictions);
+        }
+
         window.pollEvents();
         window.swapBuffers();
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
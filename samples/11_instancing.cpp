@@ -0,0 +1,183 @@
+#include <ray/platform/Window.hpp>
+#include <ray/platform/GameLoop.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <ray/entities/Cube.hpp>
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/gl/InstanceBuffer.hpp>
+#include <ray/components/Transformable.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+using namespace ray::platform;
+using namespace ray::gl;
+using namespace ray::math;
+using namespace ray::components;
+using namespace ray::entities;
+
+struct Box : public Transformable
+{
+    vec4 color;
+};
+
+struct BoxInstance
+{
+    mat4 model;
+    vec4 color;
+};
+
+// Draws every box with its own draw call and its own uniforms.
+class BoxRenderer
+{
+    static constexpr auto VERTEX_SHADER = GLSL(330, 
+        in  vec3 vertPosition;
+        in  vec3 vertNormal;
+        out vec4 fragColor;
+        uniform mat4 modelMatrix;
+        uniform mat4 viewProjectionMatrix;
+        uniform vec4 modelColor;
+        void main() 
+        { 
+            float light = 0.4 + 0.6 * abs(normalize(mat3(modelMatrix) * vertNormal).z);
+            fragColor = vec4(modelColor.rgb * light, 1.0);
+            gl_Position = viewProjectionMatrix * modelMatrix * vec4(vertPosition,1); 
+        }
+    );
+    
+    static constexpr auto FRAGMENT_SHADER = GLSL(330,
+        in  vec4 fragColor;
+        out vec4 color;
+        void main() { color = fragColor; }
+    );
+
+public:
+    BoxRenderer(const mat4 &viewProjection) : mShader(VERTEX_SHADER, FRAGMENT_SHADER)
+    {
+        mModelMatrix = mShader.getUniform<mat4>("modelMatrix"_u);
+        mModelColor = mShader.getUniform<vec4>("modelColor"_u);
+        mShader.getUniform<mat4>("viewProjectionMatrix"_u).set(viewProjection);
+        mCube.bindPosition(mShader.getAttribute<vec3>("vertPosition"_a));
+        mCube.bindNormal(mShader.getAttribute<vec3>("vertNormal"_a));
+    }
+
+    void render(const std::vector<Box> &boxes) const
+    {
+        mShader.start();
+        for (auto &box : boxes)
+        {
+            mModelMatrix.set(box.modelMatrix());
+            mModelColor.set(box.color);
+            mCube.draw();
+        }
+        mShader.stop();
+    }
+
+private:
+    ShaderProgram mShader;
+    Cube mCube;
+    Uniform<mat4> mModelMatrix;
+    Uniform<vec4> mModelColor;
+};
+
+// Streams every box into an instance buffer and draws them all at once.
+class InstancedBoxRenderer
+{
+    static constexpr auto VERTEX_SHADER = GLSL(330, 
+        in  vec3 vertPosition;
+        in  vec3 vertNormal;
+        in  mat4 instanceModel;
+        in  vec4 instanceColor;
+        out vec4 fragColor;
+        uniform mat4 viewProjectionMatrix;
+        void main() 
+        { 
+            float light = 0.4 + 0.6 * abs(normalize(mat3(instanceModel) * vertNormal).z);
+            fragColor = vec4(instanceColor.rgb * light, 1.0);
+            gl_Position = viewProjectionMatrix * instanceModel * vec4(vertPosition,1); 
+        }
+    );
+    
+    static constexpr auto FRAGMENT_SHADER = GLSL(330,
+        in  vec4 fragColor;
+        out vec4 color;
+        void main() { color = fragColor; }
+    );
+
+public:
+    InstancedBoxRenderer(const mat4 &viewProjection, size_t capacity) : mShader(VERTEX_SHADER, FRAGMENT_SHADER), mInstances(capacity)
+    {
+        mShader.getUniform<mat4>("viewProjectionMatrix"_u).set(viewProjection);
+        mCube.bindPosition(mShader.getAttribute<vec3>("vertPosition"_a));
+        mCube.bindNormal(mShader.getAttribute<vec3>("vertNormal"_a));
+        mInstances.bindAttribute(mCube, mShader.getAttribute<mat4>("instanceModel"_a), offsetof(BoxInstance, model));
+        mInstances.bindAttribute(mCube, mShader.getAttribute<vec4>("instanceColor"_a), offsetof(BoxInstance, color));
+    }
+
+    void render(const std::vector<Box> &boxes)
+    {
+        auto count = mInstances.stream(boxes.begin(), boxes.end(), [](const Box &box) {
+            return BoxInstance{ columnMajor(box.modelMatrix()), box.color };
+        });
+        mShader.start();
+        mCube.drawInstanced(count);
+        mShader.stop();
+    }
+
+private:
+    ShaderProgram mShader;
+    Cube mCube;
+    InstanceBuffer<BoxInstance> mInstances;
+};
+
+int main()
+{    
+    constexpr int SIDE = 100;
+
+    auto window     = Window(1920, 1080, "Instancing Sample");
+    auto loop       = GameLoop(window, 240, false);
+    auto projection = perspective(43_deg, window.aspectRatio(), 0.1f, 1000.0f);
+    auto boxes      = std::vector<Box>(SIDE*SIDE);
+    auto instanced  = true;
+    auto axis       = normalize(vec3(1,1,0));
+    JobSystem jobs;
+
+    for (int row = 0; row < SIDE; ++row)
+    {
+        for (int column = 0; column < SIDE; ++column)
+        {
+            auto &box = boxes[row*SIDE + column];
+            box.moveTo(1.5f*(column - SIDE/2), 1.5f*(row - SIDE/2), -150.0f);
+            box.color = vec4((float)column/SIDE, (float)row/SIDE, 0.5f, 1.0f);
+        }
+    }
+
+    BoxRenderer          drawRenderer(projection);
+    InstancedBoxRenderer instancedRenderer(projection, boxes.size());
+
+    println("press SPACE to switch between one draw per box and one instanced draw");
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.2f, 0.2f, 0.0f);    
+
+    loop.run([&]() 
+    {
+        if (window.isKeyPressed(Key::KEY_SPACE))
+            instanced = !instanced;
+
+        jobs.parallelFor(0, boxes.size(), 1024, [&](size_t first, size_t last) {
+            for (auto box = first; box < last; ++box)
+                boxes[box].rotate(axis, 1_deg);
+        });
+        
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (instanced)
+            instancedRenderer.render(boxes);
+        else
+            drawRenderer.render(boxes);
+
+        if (loop.frameCount() % loop.targetFramesPerSeconds() == 0)
+            fprintln("%-9s %d boxes: average frame time = %6.3fmsec", instanced ? "instanced" : "draws", boxes.size(), 1000*loop.averageFrameTime().count());
+    });
+
+    return EXIT_SUCCESS;
+}
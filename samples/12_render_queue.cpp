@@ -0,0 +1,187 @@
+#include <ray/platform/Window.hpp>
+#include <ray/platform/GameLoop.hpp>
+#include <ray/entities/Cube.hpp>
+#include <ray/entities/Mesh.hpp>
+#include <ray/gl/BufferHeap.hpp>
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/gl/RenderQueue.hpp>
+#include <ray/gl/Texture.hpp>
+#include <ray/components/Transformable.hpp>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace ray::platform;
+using namespace ray::gl;
+using namespace ray::math;
+using namespace ray::components;
+using namespace ray::entities;
+
+static constexpr auto VERTEX_SHADER = GLSL(330, 
+    layout(location = 0) in vec3 vertPosition;
+    layout(location = 1) in vec2 vertTexCoord;
+    layout(location = 2) in vec3 vertNormal;
+    out vec2  fragTexCoord;
+    out float fragLight;
+    uniform mat4 modelMatrix;
+    uniform mat4 viewProjectionMatrix;
+    void main() 
+    { 
+        fragTexCoord = vertTexCoord;
+        fragLight = 0.4 + 0.6 * abs(normalize(mat3(modelMatrix) * vertNormal).z);
+        gl_Position = viewProjectionMatrix * modelMatrix * vec4(vertPosition,1); 
+    }
+);
+
+static constexpr auto TEXTURED_FRAGMENT_SHADER = GLSL(330,
+    in  vec2  fragTexCoord;
+    in  float fragLight;
+    out vec4  color;
+    uniform sampler2D diffuseTexture;
+    uniform vec4 modelColor;
+    void main() { color = vec4(texture(diffuseTexture, fragTexCoord).rgb * modelColor.rgb * fragLight, 1.0); }
+);
+
+static constexpr auto COLORED_FRAGMENT_SHADER = GLSL(330,
+    in  float fragLight;
+    out vec4  color;
+    uniform vec4 modelColor;
+    void main() { color = vec4(modelColor.rgb * fragLight, 1.0); }
+);
+
+struct Program
+{
+    Program(const char *fragmentShader, const mat4 &viewProjection, bool textured) : shader(VERTEX_SHADER, fragmentShader), textured(textured)
+    {
+        modelMatrix = shader.getUniform<mat4>("modelMatrix"_u);
+        modelColor = shader.getUniform<vec4>("modelColor"_u);
+        shader.getUniform<mat4>("viewProjectionMatrix"_u).set(viewProjection);
+        if (textured) 
+            shader.getUniform<sampler2D>("diffuseTexture"_u).set(sampler2D{0});
+    }
+
+    ShaderProgram shader;
+    Uniform<mat4> modelMatrix;
+    Uniform<vec4> modelColor;
+    bool textured;
+};
+
+struct Material
+{
+    u32 id;
+    vec4 color;
+    const Program *program;
+};
+
+struct Object : public Transformable
+{
+    const Program *program;
+    const Material *material;
+    const Texture *texture;
+    const VertexArray *vertexArray;
+    size_t vertexCount, indexCount, indexOffset;
+};
+
+int main()
+{    
+    constexpr size_t OBJECT_COUNT = 2000;
+
+    auto window     = Window(1920, 1080, "Render Queue Sample");
+    auto loop       = GameLoop(window, 60);
+    auto viewProjection = perspective(43_deg, window.aspectRatio(), 0.1f, 100.0f);
+    auto random     = std::mt19937(1234);
+
+    Program textured(TEXTURED_FRAGMENT_SHADER, viewProjection, true);
+    Program colored(COLORED_FRAGMENT_SHADER, viewProjection, false);
+    const Program *programs[] = { &textured, &colored };
+
+    Texture face("res/images/awesomeface.png"), marble("res/images/marble.jpg");
+    const Texture *textures[] = { &face, &marble };
+
+    BufferHeap heap(4*1024*1024);
+    Cube cube;
+    Mesh teapot("res/mesh/teapot.obj", heap);
+    auto heapStatistics = heap.statistics();
+    fprintln("buffer heap: %d pages, %d/%d bytes used by %d allocations", 
+        heapStatistics.pages, heapStatistics.usedBytes, heapStatistics.reservedBytes, heapStatistics.allocations);
+    cube.bindPosition(textured.shader.getAttribute<vec3>("vertPosition"_a));
+    cube.bindTexCoord(textured.shader.getAttribute<vec2>("vertTexCoord"_a));
+    cube.bindNormal(textured.shader.getAttribute<vec3>("vertNormal"_a));
+    teapot.bindPosition(textured.shader.getAttribute<vec3>("vertPosition"_a));
+    teapot.bindTexCoord(textured.shader.getAttribute<vec2>("vertTexCoord"_a));
+    teapot.bindNormal(textured.shader.getAttribute<vec3>("vertNormal"_a));
+
+    std::vector<Material> materials;
+    for (u32 id = 0; id < 8; ++id)
+        materials.push_back(Material{id, vec4(0.3f + 0.1f*id, 1.0f - 0.1f*id, 0.5f, 1.0f), programs[id % 2]});
+
+    // NOTE(cme): objects are created in random order on purpose, it is the worst case for the draw order.
+    std::vector<Object> objects(OBJECT_COUNT);
+    for (auto &object : objects)
+    {
+        object.material = &materials[random() % materials.size()];
+        object.program = object.material->program;
+        object.texture = object.program->textured ? textures[random() % 2] : nullptr;
+        object.vertexArray = (random() % 2) ? static_cast<const VertexArray *>(&cube) : &teapot.vertexArray();
+        object.vertexCount = (object.vertexArray == &cube) ? cube.vertexCount() : teapot.vertexCount();
+        // NOTE(cme): the cooked teapot is indexed.
+        object.indexCount = (object.vertexArray == &cube) ? 0 : teapot.indexCount();
+        object.indexOffset = (object.vertexArray == &cube) ? 0 : teapot.indexOffset();
+        object.moveTo((float)(random() % 40) - 20.0f, (float)(random() % 24) - 12.0f, -10.0f - (float)(random() % 50));
+        object.scale(vec3(0.5f, 0.5f, 0.5f));
+    }
+
+    auto applyMaterial = [](const void *data) 
+    {
+        auto &material = *static_cast<const Material *>(data);
+        material.program->modelColor.set(material.color);
+    };
+    auto applyUniforms = [](const void *data) 
+    {
+        auto &object = *static_cast<const Object *>(data);
+        object.program->modelMatrix.set(object.modelMatrix());
+    };
+
+    auto queue = RenderQueue();
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.2f, 0.2f, 0.0f);    
+
+    loop.run([&]() 
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        for (auto &object : objects)
+        {
+            object.rotate(vec3(0,1,0), 1_deg);
+
+            RenderQueue::Item item;
+            item.program = &object.program->shader;
+            item.material = object.material->id;
+            item.applyMaterial = applyMaterial;
+            item.materialData = object.material;
+            item.texture = object.texture ? object.texture->handle() : 0;
+            item.applyUniforms = applyUniforms;
+            item.uniformData = &object;
+            item.vertexArray = object.vertexArray->handle();
+            item.vertexCount = (GLsizei)object.vertexCount;
+            item.indexCount = (GLsizei)object.indexCount;
+            item.indexOffset = object.indexOffset;
+            item.depth = (-object.position().z - 0.1f) / (100.0f - 0.1f);
+            queue.submit(item);
+        }
+        queue.flush();
+
+        if (loop.frameCount() % loop.targetFramesPerSeconds() == 0)
+        {
+            auto &unsorted = queue.unsortedStatistics();
+            auto &sorted = queue.sortedStatistics();
+            fprintln("%d draws, state changes: %d unsorted (program %d, material %d, texture %d, vao %d), %d sorted (program %d, material %d, texture %d, vao %d)",
+                sorted.draws,
+                unsorted.stateChanges(), unsorted.programChanges, unsorted.materialChanges, unsorted.textureChanges, unsorted.vertexArrayChanges,
+                sorted.stateChanges(), sorted.programChanges, sorted.materialChanges, sorted.textureChanges, sorted.vertexArrayChanges);
+        }
+    });
+
+    return EXIT_SUCCESS;
+}
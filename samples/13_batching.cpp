@@ -0,0 +1,121 @@
+#include <ray/platform/Window.hpp>
+#include <ray/platform/GameLoop.hpp>
+#include <ray/entities/MeshBatch.hpp>
+#include <ray/entities/Camera.hpp>
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/components/Transformable.hpp>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace ray::platform;
+using namespace ray::gl;
+using namespace ray::math;
+using namespace ray::components;
+using namespace ray::entities;
+
+class BatchRenderer
+{
+    static constexpr auto VERTEX_SHADER = GLSL(330, 
+        in  vec3 vertPosition;
+        in  vec3 vertNormal;
+        in  mat4 drawModel;
+        in  vec4 drawColor;
+        out vec4 fragColor;
+        uniform mat4 viewProjectionMatrix;
+        void main() 
+        { 
+            float light = 0.3 + 0.7 * max(dot(normalize(mat3(drawModel) * vertNormal), normalize(vec3(1,2,3))), 0.0);
+            fragColor = vec4(drawColor.rgb * light, 1.0);
+            gl_Position = viewProjectionMatrix * drawModel * vec4(vertPosition,1); 
+        }
+    );
+    
+    static constexpr auto FRAGMENT_SHADER = GLSL(330,
+        in  vec4 fragColor;
+        out vec4 color;
+        void main() { color = fragColor; }
+    );
+
+public:
+    BatchRenderer(MeshBatch &batch) : mShader(VERTEX_SHADER, FRAGMENT_SHADER)
+    {
+        mViewProjection = mShader.getUniform<mat4>("viewProjectionMatrix"_u);
+        batch.bindPosition(mShader.getAttribute<vec3>("vertPosition"_a));
+        batch.bindNormal(mShader.getAttribute<vec3>("vertNormal"_a));
+        batch.bindModel(mShader.getAttribute<mat4>("drawModel"_a));
+        batch.bindColor(mShader.getAttribute<vec4>("drawColor"_a));
+    }
+
+    void render(MeshBatch &batch, const mat4 &viewProjection) const
+    {
+        mShader.start();
+        mViewProjection.set(viewProjection);
+        batch.draw();
+        mShader.stop();
+    }
+
+private:
+    ShaderProgram mShader;
+    Uniform<mat4> mViewProjection;
+};
+
+struct Object : public Transformable
+{
+    MeshBatch::MeshId mesh;
+    vec4 color;
+};
+
+int main()
+{    
+    constexpr size_t OBJECT_COUNT = 5000;
+
+    auto window   = Window(1920, 1080, "Batching Sample");
+    auto loop     = GameLoop(window, 60);
+    auto camera   = Camera(43_deg, window.aspectRatio(), 0.1f, 100.0f);
+    auto random   = std::mt19937(1234);
+    auto batch    = MeshBatch();
+    MeshBatch::MeshId meshes[] = { batch.add("res/mesh/cube.obj"), batch.add("res/mesh/teapot.obj") };
+    f32 scales[] = { 0.5f, 0.02f };
+
+    BatchRenderer renderer(batch);
+
+    std::vector<Object> objects(OBJECT_COUNT);
+    for (auto &object : objects)
+    {
+        auto kind = random() % 2;
+        object.mesh = meshes[kind];
+        object.color = vec4((float)(random() % 256) / 255.0f, (float)(random() % 256) / 255.0f, (float)(random() % 256) / 255.0f, 1.0f);
+        object.scale(scales[kind]);
+        object.moveTo((float)(random() % 200) - 100.0f, (float)(random() % 20) - 10.0f, (float)(random() % 200) - 100.0f);
+    }
+
+    println(batch.usesMultiDrawIndirect() ? "drawing with glMultiDrawElementsIndirect" : "glMultiDrawElementsIndirect is not available, drawing one command at a time");
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.2f, 0.2f, 0.0f);    
+
+    loop.run([&]() 
+    {
+        camera.update(window, loop.dt().count());
+        auto viewProjection = camera.projectionMatrix() * camera.viewMatrix();
+
+        batch.begin(frustum(viewProjection));
+        for (auto &object : objects)
+            batch.submit(object.mesh, object.modelMatrix(), object.color);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        renderer.render(batch, viewProjection);
+
+        if (loop.frameCount() % loop.targetFramesPerSeconds() == 0)
+        {
+            auto &statistics = batch.statistics();
+            fprintln("%d meshes (%d vertices, %d indices), %d objects, %d culled, %d draw calls, average frame time = %6.3fmsec", 
+                statistics.meshes, statistics.vertices, statistics.indices, 
+                statistics.submitted, statistics.culled, statistics.drawCalls, 
+                1000*loop.averageFrameTime().count());
+        }
+    });
+
+    return EXIT_SUCCESS;
+}
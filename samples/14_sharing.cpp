@@ -0,0 +1,135 @@
+#include <ray/platform/Window.hpp>
+#include <ray/platform/GameLoop.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <ray/entities/Cube.hpp>
+#include <ray/entities/TransformableMesh.hpp>
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/components/Transformable.hpp>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace ray::platform;
+using namespace ray::gl;
+using namespace ray::math;
+using namespace ray::components;
+using namespace ray::entities;
+
+struct TransformableCube : public Cube, public Transformable {};
+
+template<typename T>
+void report(const std::string &name, size_t count, sec spawnTime, const Registry<T> &registry)
+{
+    auto statistics = registry.statistics();
+    fprintln("%d %s spawned in %.3fmsec: %d loads, %d hits, %d resources alive",
+        count, name, 1000*spawnTime.count(), statistics.loads, statistics.hits, statistics.liveResources);
+    fprintln("    %d bytes uploaded, %d bytes of VRAM saved, %.3fmsec of loading saved",
+        statistics.liveBytes, statistics.savedBytes, 1000*statistics.savedTime.count());
+}
+
+class Renderer
+{
+    static constexpr auto VERTEX_SHADER = GLSL(330,
+        in  vec3 vertPosition;
+        in  vec3 vertNormal;
+        out vec4 fragColor;
+        uniform mat4 modelMatrix;
+        uniform mat4 viewProjectionMatrix;
+        uniform vec4 modelColor;
+        void main()
+        {
+            float light = 0.4 + 0.6 * abs(normalize(mat3(modelMatrix) * vertNormal).z);
+            fragColor = vec4(modelColor.rgb * light, 1.0);
+            gl_Position = viewProjectionMatrix * modelMatrix * vec4(vertPosition,1);
+        }
+    );
+
+    static constexpr auto FRAGMENT_SHADER = GLSL(330,
+        in  vec4 fragColor;
+        out vec4 color;
+        void main() { color = fragColor; }
+    );
+
+public:
+    Renderer(const mat4 &viewProjection) : mShader(VERTEX_SHADER, FRAGMENT_SHADER)
+    {
+        mModelMatrix = mShader.getUniform<mat4>("modelMatrix"_u);
+        mModelColor = mShader.getUniform<vec4>("modelColor"_u);
+        mShader.getUniform<mat4>("viewProjectionMatrix"_u).set(viewProjection);
+    }
+
+    template<typename T>
+    void bind(const T &object) const
+    {
+        object.bindPosition(mShader.getAttribute<vec3>("vertPosition"_a));
+        object.bindNormal(mShader.getAttribute<vec3>("vertNormal"_a));
+    }
+
+    template<typename T>
+    void render(const std::vector<T> &objects, const vec4 &color) const
+    {
+        mShader.start();
+        mModelColor.set(color);
+        for (auto &object : objects)
+        {
+            mModelMatrix.set(object.modelMatrix());
+            object.draw();
+        }
+        mShader.stop();
+    }
+
+private:
+    ShaderProgram mShader;
+    Uniform<mat4> mModelMatrix;
+    Uniform<vec4> mModelColor;
+};
+
+int main()
+{
+    constexpr int SIDE = 32;
+    constexpr int COUNT = 1000;
+
+    auto window     = Window(1920, 1080, "Sharing Sample");
+    auto loop       = GameLoop(window, 60, false);
+    auto projection = perspective(43_deg, window.aspectRatio(), 0.1f, 1000.0f);
+    auto renderer   = Renderer(projection);
+    auto axis       = normalize(vec3(1,1,0));
+
+    Stopwatch stopwatch;
+    std::vector<TransformableCube> cubes(COUNT);
+    report("cubes", cubes.size(), stopwatch.lap(), Cube::registry());
+
+    std::vector<TransformableMesh> teapots;
+    teapots.reserve(COUNT);
+    stopwatch.lap();
+    for (int i = 0; i < COUNT; ++i)
+        teapots.emplace_back("res/mesh/teapot.obj");
+    report("teapots", teapots.size(), stopwatch.lap(), Mesh::registry());
+
+    for (int i = 0; i < COUNT; ++i)
+    {
+        auto x = 2.0f*(i % SIDE - SIDE/2), y = 2.0f*(i / SIDE - SIDE/2);
+        cubes[i].moveTo(x, y, -120.0f);
+        teapots[i].moveTo(x + 1.0f, y + 1.0f, -120.0f);
+        teapots[i].scale(0.3f);
+        renderer.bind(cubes[i]);
+        renderer.bind(teapots[i]);
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.2f, 0.2f, 0.0f);
+
+    loop.run([&]()
+    {
+        for (auto &cube : cubes)
+            cube.rotate(axis, 1_deg);
+        for (auto &teapot : teapots)
+            teapot.rotate(axis, -1_deg);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        renderer.render(cubes, vec4(0.9f, 0.5f, 0.2f, 1.0f));
+        renderer.render(teapots, vec4(0.3f, 0.6f, 0.9f, 1.0f));
+    });
+
+    return EXIT_SUCCESS;
+}
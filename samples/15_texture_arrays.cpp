@@ -0,0 +1,139 @@
+#include <ray/platform/Window.hpp>
+#include <ray/platform/GameLoop.hpp>
+#include <ray/entities/Cube.hpp>
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/gl/InstanceBuffer.hpp>
+#include <ray/gl/MaterialLibrary.hpp>
+#include <ray/components/Transformable.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+using namespace ray::platform;
+using namespace ray::gl;
+using namespace ray::math;
+using namespace ray::components;
+using namespace ray::entities;
+
+struct Box : public Transformable
+{
+    MaterialLibrary::MaterialId material;
+};
+
+struct BoxInstance
+{
+    mat4 model;
+    vec4 layer;
+};
+
+// Draws all the boxes whose materials live in the same texture array with one
+// instanced draw, whatever image each of them shows.
+class BoxRenderer
+{
+    static constexpr auto VERTEX_SHADER = GLSL(330,
+        in  vec3 vertPosition;
+        in  vec2 vertTexCoord;
+        in  mat4 instanceModel;
+        in  vec4 instanceLayer;
+        out vec3 fragTexCoord;
+        uniform mat4 viewProjectionMatrix;
+        void main()
+        {
+            fragTexCoord = vec3(vertTexCoord * instanceLayer.xy, instanceLayer.z);
+            gl_Position = viewProjectionMatrix * instanceModel * vec4(vertPosition,1);
+        }
+    );
+
+    static constexpr auto FRAGMENT_SHADER = GLSL(330,
+        in  vec3 fragTexCoord;
+        out vec4 color;
+        uniform sampler2DArray materials;
+        void main() { color = texture(materials, fragTexCoord); }
+    );
+
+public:
+    BoxRenderer(const mat4 &viewProjection, size_t capacity) : mShader(VERTEX_SHADER, FRAGMENT_SHADER), mInstances(capacity)
+    {
+        mMaterials = mShader.getUniform<sampler2DArray>("materials"_u);
+        mShader.getUniform<mat4>("viewProjectionMatrix"_u).set(viewProjection);
+        mCube.bindPosition(mShader.getAttribute<vec3>("vertPosition"_a));
+        mCube.bindTexCoord(mShader.getAttribute<vec2>("vertTexCoord"_a));
+        mInstances.bindAttribute(mCube, mShader.getAttribute<mat4>("instanceModel"_a), offsetof(BoxInstance, model));
+        mInstances.bindAttribute(mCube, mShader.getAttribute<vec4>("instanceLayer"_a), offsetof(BoxInstance, layer));
+    }
+
+    // Returns the number of draw calls.
+    size_t render(const std::vector<Box> &boxes, const MaterialLibrary &library)
+    {
+        mShader.start();
+        for (uint32_t array = 0; array < library.arrayCount(); ++array)
+        {
+            mBatch.clear();
+            for (auto &box : boxes)
+            {
+                auto &material = library[box.material];
+                if (material.array == array)
+                    mBatch.push_back(BoxInstance{ columnMajor(box.modelMatrix()), material.layerData() });
+            }
+            mInstances.load(mBatch);
+            mMaterials.set(library.array(array).bind(GL_TEXTURE0));
+            mCube.drawInstanced(mBatch.size());
+        }
+        mShader.stop();
+        return library.arrayCount();
+    }
+
+private:
+    ShaderProgram mShader;
+    Cube mCube;
+    InstanceBuffer<BoxInstance> mInstances;
+    Uniform<sampler2DArray> mMaterials;
+    std::vector<BoxInstance> mBatch;
+};
+
+int main()
+{
+    constexpr int SIDE = 40;
+
+    auto window     = Window(1920, 1080, "Texture Arrays Sample");
+    auto loop       = GameLoop(window, 60, false);
+    auto projection = perspective(43_deg, window.aspectRatio(), 0.1f, 1000.0f);
+    auto library    = MaterialLibrary();
+    auto boxes      = std::vector<Box>(SIDE*SIDE);
+    auto axis       = normalize(vec3(1,1,0));
+
+    MaterialLibrary::MaterialId materials[] = { library.add("res/images/awesomeface.png"), library.add("res/images/marble.jpg") };
+    library.flush();
+    for (int row = 0; row < SIDE; ++row)
+    {
+        for (int column = 0; column < SIDE; ++column)
+        {
+            auto &box = boxes[row*SIDE + column];
+            box.moveTo(1.5f*(column - SIDE/2), 1.5f*(row - SIDE/2), -80.0f);
+            box.material = materials[(row + column) % 2];
+        }
+    }
+
+    auto statistics = library.statistics();
+    fprintln("%d materials in %d texture arrays, %d/%d layers used, %d bytes",
+        statistics.materials, statistics.arrays, statistics.usedLayers, statistics.reservedLayers, statistics.bytes);
+
+    BoxRenderer renderer(projection, boxes.size());
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.2f, 0.2f, 0.0f);
+
+    loop.run([&]()
+    {
+        for (auto &box : boxes)
+            box.rotate(axis, 1_deg);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto draws = renderer.render(boxes, library);
+
+        if (loop.frameCount() % loop.targetFramesPerSeconds() == 0)
+            fprintln("%d boxes in %d draws: average frame time = %6.3fmsec", boxes.size(), draws, 1000*loop.averageFrameTime().count());
+    });
+
+    return EXIT_SUCCESS;
+}
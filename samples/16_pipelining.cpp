@@ -0,0 +1,167 @@
+#include <ray/platform/Window.hpp>
+#include <ray/platform/GameLoop.hpp>
+#include <ray/platform/FrameGraph.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/Profiler.hpp>
+#include <ray/entities/Cube.hpp>
+#include <ray/gl/GpuProfiler.hpp>
+#include <ray/gl/ShaderProgram.hpp>
+#include <ray/gl/InstanceBuffer.hpp>
+#include <ray/components/Transformable.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+using namespace ray::platform;
+using namespace ray::gl;
+using namespace ray::math;
+using namespace ray::components;
+using namespace ray::entities;
+
+struct Box : public Transformable
+{
+    vec3 axis;
+    vec4 color;
+};
+
+struct BoxInstance
+{
+    mat4 model;
+    vec4 color;
+};
+
+// What the renderer sees of a simulated frame.
+struct Scene
+{
+    mat4 viewProjection;
+    std::vector<BoxInstance> boxes;
+};
+
+class BoxRenderer
+{
+    static constexpr auto VERTEX_SHADER = GLSL(330,
+        in  vec3 vertPosition;
+        in  vec3 vertNormal;
+        in  mat4 instanceModel;
+        in  vec4 instanceColor;
+        out vec4 fragColor;
+        uniform mat4 viewProjectionMatrix;
+        void main()
+        {
+            float light = 0.4 + 0.6 * abs(normalize(mat3(instanceModel) * vertNormal).z);
+            fragColor = vec4(instanceColor.rgb * light, 1.0);
+            gl_Position = viewProjectionMatrix * instanceModel * vec4(vertPosition,1);
+        }
+    );
+
+    static constexpr auto FRAGMENT_SHADER = GLSL(330,
+        in  vec4 fragColor;
+        out vec4 color;
+        void main() { color = fragColor; }
+    );
+
+public:
+    BoxRenderer(size_t capacity) : mShader(VERTEX_SHADER, FRAGMENT_SHADER), mInstances(capacity)
+    {
+        mViewProjection = mShader.getUniform<mat4>("viewProjectionMatrix"_u);
+        mCube.bindPosition(mShader.getAttribute<vec3>("vertPosition"_a));
+        mCube.bindNormal(mShader.getAttribute<vec3>("vertNormal"_a));
+        mInstances.bindAttribute(mCube, mShader.getAttribute<mat4>("instanceModel"_a), offsetof(BoxInstance, model));
+        mInstances.bindAttribute(mCube, mShader.getAttribute<vec4>("instanceColor"_a), offsetof(BoxInstance, color));
+    }
+
+    void render(const Scene &scene)
+    {
+        mInstances.load(scene.boxes);
+        mShader.start();
+        mViewProjection.set(scene.viewProjection);
+        mCube.drawInstanced(scene.boxes.size());
+        mShader.stop();
+    }
+
+private:
+    ShaderProgram mShader;
+    Cube mCube;
+    InstanceBuffer<BoxInstance> mInstances;
+    Uniform<mat4> mViewProjection;
+};
+
+int main()
+{
+    constexpr int SIDE = 100;
+
+    auto window     = Window(1920, 1080, "Pipelining Sample");
+    auto loop       = GameLoop(window, 60, false);
+    auto projection = perspective(43_deg, window.aspectRatio(), 0.1f, 1000.0f);
+    auto boxes      = std::vector<Box>(SIDE*SIDE);
+    auto cameraAngle = 0.0f;
+    auto view       = mat4();
+    JobSystem jobs;
+
+    for (int row = 0; row < SIDE; ++row)
+    {
+        for (int column = 0; column < SIDE; ++column)
+        {
+            auto &box = boxes[row*SIDE + column];
+            box.moveTo(1.5f*(column - SIDE/2), 1.5f*(row - SIDE/2), 0.0f);
+            box.axis = normalize(vec3((float)column, (float)row, 1.0f));
+            box.color = vec4((float)column/SIDE, (float)row/SIDE, 0.5f, 1.0f);
+        }
+    }
+
+    // The simulation: boxes and camera update independently, the snapshot waits for both.
+    Snapshot<Scene> scene;
+    FrameGraph simulation;
+    auto transforms = simulation.resource("transforms"), camera = simulation.resource("camera");
+    simulation.addSnapshot(scene);
+
+    simulation.addTask("animate", [&]() {
+        PROFILE_ZONE("animate");
+        jobs.parallelFor(0, boxes.size(), 512, [&](size_t first, size_t last) {
+            for (auto box = first; box < last; ++box)
+                boxes[box].rotate(boxes[box].axis, 1_deg);
+        });
+    }).writes(transforms);
+
+    simulation.addTask("orbit", [&]() {
+        PROFILE_ZONE("orbit");
+        cameraAngle += 0.002f;
+        view = lookAt(vec3(40.0f*std::sin(cameraAngle), 0.0f, 150.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+    }).writes(camera);
+
+    simulation.addTask("snapshot", [&]() {
+        PROFILE_ZONE("snapshot");
+        auto &next = scene.write();
+        next.viewProjection = projection * view;
+        next.boxes.resize(boxes.size());
+        jobs.parallelFor(0, boxes.size(), 512, [&](size_t first, size_t last) {
+            for (auto box = first; box < last; ++box)
+                next.boxes[box] = BoxInstance{ columnMajor(boxes[box].modelMatrix()), boxes[box].color };
+        });
+    }).reads(transforms).reads(camera);
+
+    BoxRenderer renderer(boxes.size());
+    GpuProfiler gpu;
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.2f, 0.2f, 0.0f);
+
+    loop.run(jobs, simulation, [&]()
+    {
+        PROFILE_ZONE("render");
+        {
+            PROFILE_GPU_ZONE(gpu, "render");
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            renderer.render(scene.read());
+        }
+        gpu.endFrame();
+
+        if (loop.frameCount() % loop.targetFramesPerSeconds() == 0)
+            fprintln("%d boxes on %d workers: average frame time = %6.3fmsec, gpu time = %6.3fmsec", boxes.size(), jobs.workerCount(), 1000*loop.averageFrameTime().count(), 1000*gpu.lastFrameTime().count());
+    });
+
+    // NOTE(cme): open it in chrome://tracing or https://ui.perfetto.dev
+    Profiler::instance().writeChromeTrace("16_pipelining.json");
+    return EXIT_SUCCESS;
+}
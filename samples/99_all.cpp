@@ -3,6 +3,8 @@
 #include <ray/platform/FileSystem.hpp>
 #include <ray/gl/VertexArray.hpp>
 #include <ray/gl/ShaderProgram.hpp>
+#include <ray/gl/ProgramBinaryCache.hpp>
+#include <ray/gl/ShaderCompiler.hpp>
 #include <ray/gl/Texture.hpp>
 #include <ray/gl/CubeMap.hpp>
 #include <ray/entities/TransformableMesh.hpp>
@@ -11,6 +13,7 @@
 #include <ray/components/Movable.hpp>
 #include <ray/assets/Font.hpp>
 #include <ray/components/TextureAtlas.hpp>
+#include <unordered_map>
 #include <cstdlib>
 
 using namespace ray::platform;
@@ -32,7 +35,7 @@ public:
         return (mGlyphCache[index] = mGlyphAtlas.add(rasterizeGlyph(index)));
     }
 
-    const Texture &glyphAtlas() const { return mGlyphAtlas; }
+    const Texture &glyphAtlas() { mGlyphAtlas.flush(); return mGlyphAtlas; }
 
 private:
     TextureAtlas mGlyphAtlas;    
@@ -74,16 +77,19 @@ public:
     static constexpr auto N_FLOATS_PER_LETTER  = N_VERTEX_PER_LETTERS*N_FLOATS_PER_VERTEX;
     static constexpr auto N_INDICES_PER_LETTER = 6;
 
-    TextRenderer() : mShader(VERTEX_SHADER, FRAGMENT_SHADER)
+    TextRenderer(ShaderCompiler &compiler)
     {        
         mVertexBuffer.reserve(MAX_LETTERS * N_FLOATS_PER_LETTER, GL_STREAM_DRAW);
         mIndexBuffer.reserve(MAX_LETTERS * N_INDICES_PER_LETTER);        
-        mQuads.bindAttributeAtOffset(0, mShader.getAttribute<vec2>("vertPosition"), mVertexBuffer);
-        mQuads.bindAttributeAtOffset(2, mShader.getAttribute<vec2>("vertTexCoord"), mVertexBuffer);            
-        mQuads.bindIndices(mIndexBuffer);
-        mTextColor = mShader.getUniform<vec4>("textColor");
-        mQuadsTexture = mShader.getUniform<sampler2D>("quadTexture");
-        mTransform = mShader.getUniform<mat4>("transform");
+        compiler.submit(mShader, VERTEX_SHADER, FRAGMENT_SHADER, [this](ShaderProgram &shader) 
+        {
+            mQuads.bindAttributeAtOffset(0, shader.getAttribute<vec2>("vertPosition"_a), mVertexBuffer);
+            mQuads.bindAttributeAtOffset(2, shader.getAttribute<vec2>("vertTexCoord"_a), mVertexBuffer);            
+            mQuads.bindIndices(mIndexBuffer);
+            mTextColor = shader.getUniform<vec4>("textColor"_u);
+            mQuadsTexture = shader.getUniform<sampler2D>("quadTexture"_u);
+            mTransform = shader.getUniform<mat4>("transform"_u);
+        });
 
         auto mappedIndices = mIndexBuffer.map(GL_WRITE_ONLY);
         auto index = 0;
@@ -233,26 +239,27 @@ class MeshRenderer
     );
 
 public:
-    MeshRenderer(const Window &window)
+    MeshRenderer(const Window &window, ShaderCompiler &compiler)
     {
         (void)window;
-        shader.load(VERTEX_SHADER, FRAGMENT_SHADER);    
-        modelMatrix = shader.getUniform<mat4>("modelMatrix");
-        projectionMatrix = shader.getUniform<mat4>("projectionMatrix");    
-        viewMatrix = shader.getUniform<mat4>("viewMatrix");    
-        modelColor = shader.getUniform<vec4>("modelColor");
-        lightColor = shader.getUniform<vec4>("lightColor");
-        lightPosition = shader.getUniform<vec3>("lightPosition");
-        cameraPosition = shader.getUniform<vec3>("cameraPosition");
-        reflectivity = shader.getUniform<float>("reflectivity");
-        shineDamper = shader.getUniform<float>("shineDamper");
-        shader.stop();
+        compiler.submit(shader, VERTEX_SHADER, FRAGMENT_SHADER, [this](ShaderProgram &shader) 
+        {
+            modelMatrix = shader.getUniform<mat4>("modelMatrix"_u);
+            projectionMatrix = shader.getUniform<mat4>("projectionMatrix"_u);    
+            viewMatrix = shader.getUniform<mat4>("viewMatrix"_u);    
+            modelColor = shader.getUniform<vec4>("modelColor"_u);
+            lightColor = shader.getUniform<vec4>("lightColor"_u);
+            lightPosition = shader.getUniform<vec3>("lightPosition"_u);
+            cameraPosition = shader.getUniform<vec3>("cameraPosition"_u);
+            reflectivity = shader.getUniform<float>("reflectivity"_u);
+            shineDamper = shader.getUniform<float>("shineDamper"_u);
+        });
     }
 
     void bind(const Mesh &mesh) const
     {
-        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"));
-        mesh.bindNormal(shader.getAttribute<vec3>("vertNormal"));
+        mesh.bindPosition(shader.getAttribute<vec3>("vertPosition"_a));
+        mesh.bindNormal(shader.getAttribute<vec3>("vertNormal"_a));
     }
 
     void render(const TransformableMesh &mesh, const Material &material, const Light &light, const Camera &camera) const
@@ -317,12 +324,15 @@ class SkyboxRenderer
     );
 
 public:
-    SkyboxRenderer() : mShader(VERTEX_SHADER, FRAGMENT_SHADER) 
+    SkyboxRenderer(ShaderCompiler &compiler)
     {
-        projection = mShader.getUniform<mat4>("projection");
-        view       = mShader.getUniform<mat4>("view");
-        cubeMap    = mShader.getUniform<samplerCube>("cubeMap");
-        position   = mShader.getAttribute<vec3>("vertPosition");
+        compiler.submit(mShader, VERTEX_SHADER, FRAGMENT_SHADER, [this](ShaderProgram &shader) 
+        {
+            projection = shader.getUniform<mat4>("projection"_u);
+            view       = shader.getUniform<mat4>("view"_u);
+            cubeMap    = shader.getUniform<samplerCube>("cubeMap"_u);
+            position   = shader.getAttribute<vec3>("vertPosition"_a);
+        });
     }
 
     void bind(const Skybox &skybox)
@@ -356,15 +366,20 @@ int main()
 {    
     auto window   = Window(1920, 1080, "Lighting Sample");
     auto loop     = GameLoop(window, 60);
-    auto renderer = MeshRenderer(window);
+    auto shaders  = ProgramBinaryCache("cache/shaders");
+    auto compiler = ShaderCompiler(shaders);
+
+    // NOTE(cme): the renderers register callbacks on themselves, so they must not be moved.
+    MeshRenderer   renderer(window, compiler);
+    TextRenderer   texter(compiler);
+    SkyboxRenderer skyboxRenderer(compiler);
+
     auto mesh     = TransformableMesh("res/mesh/bunny.obj");
     auto material = Material{DARK_GRAY, 1.0f, 10.0f};
     auto light    = Light(vec3(2,2,5), YELLOW);
     auto small    = CachedFont("res/fonts/Roboto-Regular.ttf", 30);
-    auto texter   = TextRenderer();
     auto camera   = Camera(43_deg, window.aspectRatio(), 0.001f, 1000.0f);
-    auto skyboxRenderer = SkyboxRenderer();
-    auto skybox         = Skybox({
+    auto skybox   = Skybox({
         "res/images/skybox/right.jpg",
         "res/images/skybox/left.jpg",
         "res/images/skybox/top.jpg",
@@ -373,6 +388,14 @@ int main()
         "res/images/skybox/front.jpg",
     });
 
+    compiler.finish();
+
+    auto &shaderStatistics = shaders.statistics();
+    print(fmt("shader programs: %d cached (%.3fmsec), %d linked (%.3fmsec), %d rejected\n", 
+        shaderStatistics.hits, msec(shaderStatistics.warmTime).count(), 
+        shaderStatistics.misses, msec(shaderStatistics.coldTime).count(), 
+        shaderStatistics.rejected));
+
     skyboxRenderer.bind(skybox);
     
     mesh.moveTo(0,-0.8f,-3.5f);
@@ -1,5 +1,10 @@
 #include <ray/assets/Bitmap.hpp>
+#include <ray/assets/PixelPool.hpp>
+#include <ray/platform/Pack.hpp>
 #include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 // NOTE(cme): silence two unused parameters
 //            fixed in https://github.com/nothings/stb/pull/662
@@ -27,49 +32,124 @@
 
 namespace ray { namespace assets {
 
+    namespace
+    {
+        std::vector<uint8_t> packed(const Bitmap &bitmap)
+        {
+            auto rowSize = (size_t)bitmap.width() * bitmap.depth();
+            std::vector<uint8_t> result(rowSize * bitmap.height());
+            for (int y = 0; y < bitmap.height(); ++y)
+                std::memcpy(&result[y * rowSize], bitmap.row(y), rowSize);
+            return result;
+        }
+    }
+
     Bitmap::Bitmap(const std::string &filename) 
     {
-        mPixels = stbi_load(filename.c_str(), &mWidth, &mHeight, &mDepth, 0);
-        panicif(mPixels == nullptr, "could not load bitmap '%s'", filename);
+        auto file = platform::fs::load(filename, platform::fs::Access::Sequential);
+        panicif(!file.isValid(), "could not load bitmap: %s", file.error());
+        mPixels = stbi_load_from_memory(file.data(), (int)file.size(), &mWidth, &mHeight, &mDepth, 0);
+        panicif(mPixels == nullptr, "could not load bitmap '%s': %s", filename, stbi_failure_reason());
+        mStride = mWidth * mDepth;
+    }
+
+    Bitmap::Bitmap(const u8 *encoded, size_t size)
+    {
+        mPixels = stbi_load_from_memory(encoded, (int)size, &mWidth, &mHeight, &mDepth, 0);
+        panicif(mPixels == nullptr, "could not decode bitmap: %s", stbi_failure_reason());
+        mStride = mWidth * mDepth;
     }
 
-    Bitmap::Bitmap(int width, int height, int depth, const Color &color) : Bitmap(width, height, depth)
+    Bitmap::Bitmap(int width, int height, int depth, const Color &color) : Bitmap(width, height, depth, Stride::Tight)
     {
-        const auto end = mPixels + size();
-        for (auto pixel = mPixels; pixel < end; pixel += depth)
-            std::memcpy(pixel, &color, depth);
+        fill(color);
     }
 
-    Bitmap::Bitmap(Bitmap &&other)
+    Bitmap::Bitmap(int width, int height, int depth, Stride stride, PixelPool *pool) : mPixels(nullptr), mIsAligned(stride == Stride::Aligned), mPool(pool)
+    {
+        allocate(width, height, depth);
+    }
+
+    Bitmap::Bitmap(Bitmap &&other) : Bitmap()
     {
         (*this) = std::move(other);
     }
 
     Bitmap &Bitmap::operator=(Bitmap &&other)
     {
+        if (this == &other)
+            return (*this);
+        release();
         mPixels = other.mPixels;
         mHeight = other.mHeight;
         mWidth = other.mWidth;
         mDepth = other.mDepth;
+        mStride = other.mStride;
+        mIsAligned = other.mIsAligned;
+        mPool = other.mPool;
         other.mPixels = nullptr;
-        other.mHeight = other.mWidth = other.mDepth = 0;
+        other.mHeight = other.mWidth = other.mDepth = other.mStride = 0;
         return (*this);
     }
 
     Bitmap::~Bitmap() 
     {
-        free(mPixels);
+        release();
     }
 
     void Bitmap::resize(int width, int height, int depth)
+    {
+        release();
+        allocate(width, height, depth);
+        memset(mPixels, 0x00, size());
+    }
+
+    void Bitmap::fill(const Color &color)
+    {
+        // NOTE(cme): one pixel, then doubling what is filled so far, a few large copies
+        //            for the first row, which the others copy.
+        const auto rowSize = (size_t)mWidth * mDepth;
+        if (rowSize == 0 || mHeight == 0)
+            return;
+        std::memcpy(mPixels, &color, mDepth);
+        for (auto filled = (size_t)mDepth; filled < rowSize; filled *= 2)
+            std::memcpy(mPixels + filled, mPixels, std::min(filled, rowSize - filled));
+        for (int y = 1; y < mHeight; ++y)
+            std::memcpy(row(y), mPixels, rowSize);
+    }
+
+    int Bitmap::alignedStride(int width, int depth)
+    {
+        // NOTE(cme): a multiple of both, 64 for every depth but 3.
+        auto alignment = depth == 3 ? 3 * (int)PixelPool::ALIGNMENT : (int)PixelPool::ALIGNMENT;
+        return (width * depth + alignment - 1) / alignment * alignment;
+    }
+
+    void Bitmap::allocate(int width, int height, int depth)
     {
         mWidth = width;
         mHeight = height;
         mDepth = depth;
-        free(mPixels);
-        mPixels = reinterpret_cast<uint8_t*>(malloc(width * height * depth));
-        memset(mPixels, 0x00, width * height * depth);
-        panicif(mPixels == nullptr, "could not allocate buffer for bitmap");
+        mStride = mIsAligned ? alignedStride(width, depth) : width * depth;
+        auto bytes = (size_t)mStride * height;
+        if (mPool)
+            mPixels = mPool->acquire(bytes);
+        else if (mIsAligned)
+            mPixels = PixelPool::allocateAligned(bytes);
+        else
+            mPixels = reinterpret_cast<uint8_t*>(malloc(bytes));
+        panicif(mPixels == nullptr && bytes > 0, "could not allocate buffer for bitmap");
+    }
+
+    void Bitmap::release()
+    {
+        if (mPool)
+            mPool->release(mPixels, (size_t)size());
+        else if (mIsAligned)
+            PixelPool::freeAligned(mPixels);
+        else
+            free(mPixels);
+        mPixels = nullptr;
     }
 
     void Bitmap::toPNG(const std::string &filename) const
@@ -77,14 +157,17 @@ namespace ray { namespace assets {
         stbi_write_png(filename.c_str(), mWidth, mHeight, mDepth, mPixels, stride());
     }
 
+    // NOTE(cme): neither writer takes a stride, padded rows are packed first.
     void Bitmap::toBMP(const std::string &filename) const
     {
-        stbi_write_bmp(filename.c_str(), mWidth, mHeight, mDepth, mPixels);
+        auto pixels = packed(*this);
+        stbi_write_bmp(filename.c_str(), mWidth, mHeight, mDepth, pixels.data());
     }
 
     void Bitmap::toJPG(const std::string &filename, int quality) const
     {
-        stbi_write_jpg(filename.c_str(), mWidth, mHeight, mDepth, mPixels, quality);
+        auto pixels = packed(*this);
+        stbi_write_jpg(filename.c_str(), mWidth, mHeight, mDepth, pixels.data(), quality);
     }
 
 }}
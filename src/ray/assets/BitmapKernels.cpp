@@ -0,0 +1,426 @@
+#include <ray/assets/BitmapKernels.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define RAY_KERNELS_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define RAY_KERNELS_SSE2 0
+#endif
+
+namespace ray { namespace assets { namespace kernels {
+
+    namespace
+    {
+        using u8 = uint8_t;
+
+        // NOTE(cme): about 64K pixels per job, below that the hand off costs more than it saves.
+        constexpr size_t PIXELS_PER_JOB = 1 << 16;
+
+        template<typename Function>
+        void forRows(platform::JobSystem *jobs, size_t rows, size_t pixelsPerRow, Function function)
+        {
+            auto grain = std::max<size_t>(1, PIXELS_PER_JOB / std::max<size_t>(1, pixelsPerRow));
+            if (jobs)
+                jobs->parallelFor(0, rows, grain, function);
+            else
+                function(0, rows);
+        }
+
+        // Channels besides alpha, see the header for what each depth holds.
+        int colorCount(int depth) { return depth >= 3 ? 3 : depth - 1; }
+
+        // round(value * alpha / 255), exact for every 8 bits pair.
+        inline u8 scale(int value, int alpha)
+        {
+            auto t = value * alpha + 128;
+            return (u8)((t + (t >> 8)) >> 8);
+        }
+
+        template<int From>
+        inline void expand(const u8 *pixel, u8 *rgba)
+        {
+            switch (From)
+            {
+                case 1: rgba[0] = rgba[1] = rgba[2] = 255;       rgba[3] = pixel[0]; break;
+                case 2: rgba[0] = rgba[1] = rgba[2] = pixel[0];  rgba[3] = pixel[1]; break;
+                case 3: rgba[0] = pixel[0]; rgba[1] = pixel[1]; rgba[2] = pixel[2]; rgba[3] = 255; break;
+                case 4: rgba[0] = pixel[0]; rgba[1] = pixel[1]; rgba[2] = pixel[2]; rgba[3] = pixel[3]; break;
+            }
+        }
+
+        template<int To>
+        inline void contract(const u8 *rgba, u8 *pixel)
+        {
+            switch (To)
+            {
+                case 1: pixel[0] = rgba[3]; break;
+                case 2: pixel[0] = (u8)((77 * rgba[0] + 150 * rgba[1] + 29 * rgba[2] + 128) >> 8); pixel[1] = rgba[3]; break;
+                case 3: pixel[0] = rgba[0]; pixel[1] = rgba[1]; pixel[2] = rgba[2]; break;
+                case 4: pixel[0] = rgba[0]; pixel[1] = rgba[1]; pixel[2] = rgba[2]; pixel[3] = rgba[3]; break;
+            }
+        }
+
+        // NOTE(cme): instantiated for each pair of depths, the compiler vectorizes
+        //            the fixed size loads and stores better than any runtime switch.
+        template<int From, int To>
+        void convertRow(const u8 *source, u8 *target, int width)
+        {
+            u8 rgba[4];
+            for (int x = 0; x < width; ++x, source += From, target += To)
+            {
+                expand<From>(source, rgba);
+                contract<To>(rgba, target);
+            }
+        }
+
+        using ConvertRow = void (*)(const u8 *, u8 *, int);
+        const ConvertRow CONVERT_ROWS[4][4] = {
+            { convertRow<1, 1>, convertRow<1, 2>, convertRow<1, 3>, convertRow<1, 4> },
+            { convertRow<2, 1>, convertRow<2, 2>, convertRow<2, 3>, convertRow<2, 4> },
+            { convertRow<3, 1>, convertRow<3, 2>, convertRow<3, 3>, convertRow<3, 4> },
+            { convertRow<4, 1>, convertRow<4, 2>, convertRow<4, 3>, convertRow<4, 4> },
+        };
+
+        void premultiplyRow(u8 *pixels, int width, int depth)
+        {
+            auto size = width * depth, i = 0;
+#if RAY_KERNELS_SSE2
+            // NOTE(cme): alpha is the last 16 bits lane of each pixel once widened,
+            //            broadcast to the others by the shuffles.
+            const auto zero = _mm_setzero_si128();
+            const auto rounding = _mm_set1_epi16(128);
+            const auto alphaMask = depth == 4 ? _mm_set1_epi32((int)0xFF000000) : _mm_set1_epi16((short)0xFF00);
+            for (; i + 16 <= size; i += 16)
+            {
+                auto pixel = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+                __m128i halves[2] = { _mm_unpacklo_epi8(pixel, zero), _mm_unpackhi_epi8(pixel, zero) };
+                for (auto &half : halves)
+                {
+                    auto alpha = depth == 4
+                        ? _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3))
+                        : _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+                    auto t = _mm_add_epi16(_mm_mullo_epi16(half, alpha), rounding);
+                    half = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+                }
+                auto scaled = _mm_packus_epi16(halves[0], halves[1]);
+                pixel = _mm_or_si128(_mm_and_si128(alphaMask, pixel), _mm_andnot_si128(alphaMask, scaled));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), pixel);
+            }
+#endif
+            for (; i < size; i += depth)
+                for (int channel = 0; channel < depth - 1; ++channel)
+                    pixels[i + channel] = scale(pixels[i + channel], pixels[i + depth - 1]);
+        }
+
+        const float *linearTable()
+        {
+            static const auto table = []() {
+                std::vector<float> result(256);
+                for (int i = 0; i < 256; ++i)
+                {
+                    auto value = i / 255.0;
+                    result[i] = (float)(value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4));
+                }
+                return result;
+            }();
+            return table.data();
+        }
+
+        constexpr int SRGB_TABLE_SIZE = 4096;
+
+        const u8 *srgbTable()
+        {
+            static const auto table = []() {
+                std::vector<u8> result(SRGB_TABLE_SIZE);
+                for (int i = 0; i < SRGB_TABLE_SIZE; ++i)
+                {
+                    auto value = (double)i / (SRGB_TABLE_SIZE - 1);
+                    auto srgb = value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+                    result[i] = (u8)std::lround(255.0 * srgb);
+                }
+                return result;
+            }();
+            return table.data();
+        }
+
+        // The source pixels each target pixel of an axis is made of, and their weights.
+        struct Contributions
+        {
+            int taps = 0;
+            std::vector<int> first;
+            std::vector<float> weights;     // taps per target pixel
+        };
+
+        float lanczos3(float x)
+        {
+            x = std::fabs(x);
+            if (x < 1e-6f)
+                return 1.0f;
+            if (x >= 3.0f)
+                return 0.0f;
+            const auto pi = 3.14159265358979f;
+            return 3.0f * std::sin(pi * x) * std::sin(pi * x / 3.0f) / (pi * pi * x * x);
+        }
+
+        Contributions contributions(int sourceSize, int targetSize, Filter filter)
+        {
+            auto scale = (float)sourceSize / targetSize;
+            auto filterScale = std::max(1.0f, scale);
+            auto radius = (filter == Filter::Box ? 0.5f : 3.0f) * filterScale;
+
+            Contributions result;
+            result.taps = (int)std::ceil(2.0f * radius) + 1;
+            result.first.resize(targetSize);
+            result.weights.assign((size_t)targetSize * result.taps, 0.0f);
+            for (int i = 0; i < targetSize; ++i)
+            {
+                auto center = (i + 0.5f) * scale;
+                auto first = std::max(0, (int)std::floor(center - radius));
+                auto last = std::min(sourceSize - 1, (int)std::ceil(center + radius));
+                last = std::min(last, first + result.taps - 1);
+                auto weights = &result.weights[(size_t)i * result.taps];
+
+                auto total = 0.0f;
+                for (int j = first; j <= last; ++j)
+                {
+                    auto x = (j + 0.5f - center) / filterScale;
+                    auto weight = filter == Filter::Box ? (std::fabs(x) < 0.5f ? 1.0f : std::fabs(x) == 0.5f ? 0.5f : 0.0f) : lanczos3(x);
+                    weights[j - first] = weight;
+                    total += weight;
+                }
+                // NOTE(cme): upscaling with a box can miss every center, use the nearest pixel then.
+                if (total == 0.0f)
+                {
+                    first = std::min(sourceSize - 1, (int)center);
+                    weights[0] = total = 1.0f;
+                }
+                for (int k = 0; k < result.taps; ++k)
+                    weights[k] /= total;
+                result.first[i] = first;
+            }
+            return result;
+        }
+
+        // target[x] += weight * source[x]
+        void accumulate(float *target, const float *source, float weight, size_t count)
+        {
+            size_t i = 0;
+#if RAY_KERNELS_SSE2
+            auto w = _mm_set1_ps(weight);
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(target + i, _mm_add_ps(_mm_loadu_ps(target + i), _mm_mul_ps(w, _mm_loadu_ps(source + i))));
+#endif
+            for (; i < count; ++i)
+                target[i] += weight * source[i];
+        }
+    }
+
+    Bitmap convert(const BitmapView &bitmap, int depth, platform::JobSystem *jobs)
+    {
+        panicif(depth < 1 || depth > 4 || bitmap.depth() < 1 || bitmap.depth() > 4, "can't convert from %d to %d channels", bitmap.depth(), depth);
+        auto result = Bitmap(bitmap.width(), bitmap.height(), depth, Bitmap::Stride::Tight);
+        auto row = CONVERT_ROWS[bitmap.depth() - 1][depth - 1];
+        forRows(jobs, (size_t)bitmap.height(), (size_t)bitmap.width(), [&](size_t first, size_t last) {
+            for (auto y = first; y < last; ++y)
+                row(bitmap.row((int)y), result.row((int)y), bitmap.width());
+        });
+        return result;
+    }
+
+    void premultiply(Bitmap &bitmap, platform::JobSystem *jobs)
+    {
+        panicif(bitmap.depth() != 2 && bitmap.depth() != 4, "can't premultiply a bitmap of %d channels", bitmap.depth());
+        forRows(jobs, (size_t)bitmap.height(), (size_t)bitmap.width(), [&](size_t first, size_t last) {
+            for (auto y = first; y < last; ++y)
+                premultiplyRow(bitmap.row((int)y), bitmap.width(), bitmap.depth());
+        });
+    }
+
+    void flipVertically(Bitmap &bitmap)
+    {
+        std::vector<u8> row((size_t)bitmap.width() * bitmap.depth());
+        for (int y = 0; y < bitmap.height() / 2; ++y)
+        {
+            auto top = bitmap.row(y);
+            auto bottom = bitmap.row(bitmap.height() - 1 - y);
+            std::memcpy(row.data(), top, row.size());
+            std::memcpy(top, bottom, row.size());
+            std::memcpy(bottom, row.data(), row.size());
+        }
+    }
+
+    void blit(const BitmapView &source, Bitmap &target, int x, int y)
+    {
+        panicif(source.depth() != target.depth(), "can't blit %d channels onto %d", source.depth(), target.depth());
+        panicif(x < 0 || y < 0 || x + source.width() > target.width() || y + source.height() > target.height(),
+            "blit of %dx%d at (%d,%d) out of a %dx%d bitmap", source.width(), source.height(), x, y, target.width(), target.height());
+
+        auto bytes = (size_t)source.width() * source.depth();
+        for (int row = 0; row < source.height(); ++row)
+        {
+            auto from = source.row(row);
+            auto to = target.row(y + row) + (size_t)x * target.depth();
+#if RAY_KERNELS_SSE2
+            // NOTE(cme): glyph rows are a few dozen bytes, inline copies beat a memcpy call
+            //            for each of them. The last 16 bytes overlap the ones before.
+            if (bytes >= 16)
+            {
+                for (size_t i = 0; i + 16 < bytes; i += 16)
+                    _mm_storeu_si128((__m128i *)(to + i), _mm_loadu_si128((const __m128i *)(from + i)));
+                _mm_storeu_si128((__m128i *)(to + bytes - 16), _mm_loadu_si128((const __m128i *)(from + bytes - 16)));
+                continue;
+            }
+#endif
+            std::memcpy(to, from, bytes);
+        }
+    }
+
+    float toLinear(uint8_t srgb)
+    {
+        return linearTable()[srgb];
+    }
+
+    uint8_t toSrgb(float linear)
+    {
+        auto index = (int)(std::min(1.0f, std::max(0.0f, linear)) * (SRGB_TABLE_SIZE - 1) + 0.5f);
+        return srgbTable()[index];
+    }
+
+    void srgbToLinear(Bitmap &bitmap, platform::JobSystem *jobs)
+    {
+        auto colors = colorCount(bitmap.depth()), depth = bitmap.depth();
+        auto table = linearTable();
+        forRows(jobs, (size_t)bitmap.height(), (size_t)bitmap.width(), [&](size_t first, size_t last) {
+            for (auto y = first; y < last; ++y)
+            {
+                auto pixel = bitmap.row((int)y);
+                for (int x = 0; x < bitmap.width(); ++x, pixel += depth)
+                    for (int channel = 0; channel < colors; ++channel)
+                        pixel[channel] = (u8)(table[pixel[channel]] * 255.0f + 0.5f);
+            }
+        });
+    }
+
+    void linearToSrgb(Bitmap &bitmap, platform::JobSystem *jobs)
+    {
+        auto colors = colorCount(bitmap.depth()), depth = bitmap.depth();
+        auto table = srgbTable();
+        forRows(jobs, (size_t)bitmap.height(), (size_t)bitmap.width(), [&](size_t first, size_t last) {
+            for (auto y = first; y < last; ++y)
+            {
+                auto pixel = bitmap.row((int)y);
+                for (int x = 0; x < bitmap.width(); ++x, pixel += depth)
+                    for (int channel = 0; channel < colors; ++channel)
+                        pixel[channel] = table[(pixel[channel] * (SRGB_TABLE_SIZE - 1) + 127) / 255];
+            }
+        });
+    }
+
+    Bitmap halve(const BitmapView &bitmap, platform::JobSystem *jobs)
+    {
+        auto width = std::max(1, bitmap.width() / 2), height = std::max(1, bitmap.height() / 2), depth = bitmap.depth();
+        auto result = Bitmap(width, height, depth, Bitmap::Stride::Tight);
+        forRows(jobs, (size_t)height, (size_t)width * 4, [&](size_t first, size_t last) {
+            // NOTE(cme): the two rows are summed first, 16 bytes at a time, then the columns.
+            auto rowSize = bitmap.width() * depth;
+            std::vector<uint16_t> sums((size_t)rowSize);
+            for (auto y = first; y < last; ++y)
+            {
+                auto row0 = bitmap.row(std::min(2 * (int)y, bitmap.height() - 1));
+                auto row1 = bitmap.row(std::min(2 * (int)y + 1, bitmap.height() - 1));
+                int i = 0;
+#if RAY_KERNELS_SSE2
+                const auto zero = _mm_setzero_si128();
+                for (; i + 16 <= rowSize; i += 16)
+                {
+                    auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + i));
+                    auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&sums[i]), _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&sums[i + 8]), _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+                }
+#endif
+                for (; i < rowSize; ++i)
+                    sums[i] = (uint16_t)(row0[i] + row1[i]);
+
+                auto target = result.row((int)y);
+                for (int x = 0; x < width; ++x)
+                {
+                    auto x0 = std::min(2*x, bitmap.width() - 1) * depth, x1 = std::min(2*x + 1, bitmap.width() - 1) * depth;
+                    for (int channel = 0; channel < depth; ++channel)
+                        *target++ = (u8)((sums[x0 + channel] + sums[x1 + channel] + 2) >> 2);
+                }
+            }
+        });
+        return result;
+    }
+
+    Bitmap resample(const BitmapView &bitmap, int width, int height, const ResampleOptions &options)
+    {
+        panicif(width <= 0 || height <= 0, "can't resample to %dx%d", width, height);
+        auto depth = bitmap.depth();
+        auto colors = options.srgb ? colorCount(depth) : 0;
+        auto horizontal = contributions(bitmap.width(), width, options.filter);
+        auto vertical = contributions(bitmap.height(), height, options.filter);
+        auto linear = linearTable();
+
+        // NOTE(cme): the rows are filtered horizontally to floats, then combined
+        //            vertically, a whole row of floats at a time.
+        auto rowSize = (size_t)width * depth;
+        std::vector<float> filtered(rowSize * bitmap.height());
+        forRows(options.jobs, (size_t)bitmap.height(), (size_t)width * horizontal.taps, [&](size_t first, size_t last) {
+            std::vector<float> source((size_t)bitmap.width() * depth);
+            for (auto y = first; y < last; ++y)
+            {
+                auto pixels = bitmap.row((int)y);
+                for (int x = 0; x < bitmap.width(); ++x)
+                    for (int channel = 0; channel < depth; ++channel)
+                        source[x * depth + channel] = channel < colors ? linear[pixels[x * depth + channel]] : pixels[x * depth + channel] / 255.0f;
+
+                auto target = &filtered[y * rowSize];
+                for (int x = 0; x < width; ++x)
+                {
+                    auto weights = &horizontal.weights[(size_t)x * horizontal.taps];
+                    auto pixel = &source[(size_t)horizontal.first[x] * depth];
+                    auto taps = std::min(horizontal.taps, bitmap.width() - horizontal.first[x]);
+                    for (int channel = 0; channel < depth; ++channel)
+                    {
+                        auto sum = 0.0f;
+                        for (int k = 0; k < taps; ++k)
+                            sum += weights[k] * pixel[k * depth + channel];
+                        target[x * depth + channel] = sum;
+                    }
+                }
+            }
+        });
+
+        auto result = Bitmap(width, height, depth, Bitmap::Stride::Tight);
+        forRows(options.jobs, (size_t)height, (size_t)width * vertical.taps, [&](size_t first, size_t last) {
+            std::vector<float> sum(rowSize);
+            for (auto y = first; y < last; ++y)
+            {
+                std::fill(sum.begin(), sum.end(), 0.0f);
+                auto weights = &vertical.weights[y * vertical.taps];
+                auto taps = std::min(vertical.taps, bitmap.height() - vertical.first[y]);
+                for (int k = 0; k < taps; ++k)
+                    if (weights[k] != 0.0f)
+                        accumulate(sum.data(), &filtered[(size_t)(vertical.first[y] + k) * rowSize], weights[k], rowSize);
+
+                auto target = result.row((int)y);
+                for (size_t i = 0; i < rowSize; ++i)
+                {
+                    auto channel = (int)(i % depth);
+                    target[i] = channel < colors ? toSrgb(sum[i]) : (u8)(std::min(1.0f, std::max(0.0f, sum[i])) * 255.0f + 0.5f);
+                }
+            }
+        });
+        return result;
+    }
+
+}}}
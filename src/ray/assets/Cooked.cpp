@@ -0,0 +1,516 @@
+#include <ray/assets/Cooked.hpp>
+#include <ray/assets/BitmapKernels.hpp>
+#include <ray/assets/Font.hpp>
+#include <ray/assets/PixelPool.hpp>
+#include <ray/assets/Wavefront.hpp>
+#include <ray/platform/FileSystem.hpp>
+#include <ray/platform/Hash.hpp>
+#include <ray/platform/Pack.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+namespace fs = ray::platform::fs;
+
+// NOTE(cme): where 'make cook' writes, set by CMake.
+#ifndef RAY_COOKED_DIRECTORY
+#   define RAY_COOKED_DIRECTORY "cooked"
+#endif
+
+namespace ray { namespace assets {
+
+    namespace
+    {
+        const char TEXTURE_MAGIC[8] = { 'R', 'A', 'Y', 'T', 'E', 'X', 0, 0 };
+        const char MESH_MAGIC[8] = { 'R', 'A', 'Y', 'M', 'E', 'S', 'H', 0 };
+        const char FONT_MAGIC[8] = { 'R', 'A', 'Y', 'F', 'O', 'N', 'T', 0 };
+
+        size_t alignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+        template<typename T>
+        void append(std::vector<uint8_t> &bytes, const T *data, size_t count)
+        {
+            auto begin = reinterpret_cast<const uint8_t *>(data);
+            bytes.insert(bytes.end(), begin, begin + count * sizeof(T));
+        }
+
+        template<typename Header>
+        const Header *checkHeader(const fs::FileData &data, const char (&magic)[8], const std::string &name)
+        {
+            panicif(!data.isValid(), "could not load '%s': %s", name, data.error());
+            panicif(data.size() < sizeof(Header), "'%s' is too small to be cooked", name);
+            auto header = reinterpret_cast<const Header *>(data.data());
+            panicif(std::memcmp(header->magic, magic, sizeof(magic)) != 0, "'%s' is not cooked", name);
+            panicif(header->version != cooked::VERSION, "'%s' was cooked by another version, cook it again", name);
+            return header;
+        }
+
+        struct CookedRoot
+        {
+            std::string source = "res/";
+            std::string cooked = RAY_COOKED_DIRECTORY;
+        };
+
+        CookedRoot &cookedRoot()
+        {
+            static CookedRoot instance;
+            return instance;
+        }
+
+        using Vertex = std::array<float, cooked::FLOATS_PER_VERTEX>;
+
+        struct VertexHash
+        {
+            size_t operator()(const Vertex &vertex) const
+            {
+                return (size_t)platform::fnv1a64(reinterpret_cast<const char *>(vertex.data()), sizeof(Vertex));
+            }
+        };
+
+        // NOTE(cme): the constants of the original article, tuned for caches of
+        //            16 to 64 entries.
+        constexpr int CACHE_SIZE = 32;
+        constexpr float CACHE_DECAY_POWER = 1.5f;
+        constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+        constexpr float VALENCE_BOOST_SCALE = 2.0f;
+        constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+        float vertexScore(int cachePosition, size_t remainingTriangles)
+        {
+            if (remainingTriangles == 0)
+                return -1.0f;
+
+            auto score = 0.0f;
+            if (cachePosition >= 3)
+                score = std::pow(1.0f - (float)(cachePosition - 3) / (CACHE_SIZE - 3), CACHE_DECAY_POWER);
+            else if (cachePosition >= 0)
+                score = LAST_TRIANGLE_SCORE;
+            return score + VALENCE_BOOST_SCALE * std::pow((float)remainingTriangles, -VALENCE_BOOST_POWER);
+        }
+    }
+
+    namespace cooked
+    {
+        std::string texturePath(const std::string &source) { return source + ".rtex"; }
+        std::string meshPath(const std::string &source) { return source + ".rmesh"; }
+        std::string fontPath(const std::string &source, int lineHeight) { return source + "." + std::to_string(lineHeight) + ".rfnt"; }
+
+        void setRoot(const std::string &sourceDirectory, const std::string &cookedDirectory)
+        {
+            auto &root = cookedRoot();
+            root.source = sourceDirectory.empty() || sourceDirectory.back() == '/' ? sourceDirectory : sourceDirectory + "/";
+            root.cooked = cookedDirectory;
+        }
+
+        std::string find(const std::string &cookedPath)
+        {
+            if (fs::isPacked(cookedPath) || fs::exists(cookedPath))
+                return cookedPath;
+            auto &root = cookedRoot();
+            if (cookedPath.compare(0, root.source.size(), root.source) == 0)
+            {
+                auto cooked = fs::join(root.cooked, cookedPath.substr(root.source.size()));
+                if (fs::exists(cooked))
+                    return cooked;
+            }
+            return std::string();
+        }
+
+        bool exists(const std::string &cookedPath)
+        {
+            return !find(cookedPath).empty();
+        }
+
+        std::vector<uint8_t> cookTexture(const BitmapView &bitmap, const TextureOptions &options)
+        {
+            std::vector<Bitmap> mips;
+            auto level = bitmap;
+            while (options.mipmaps && (level.width() > 1 || level.height() > 1))
+            {
+                mips.push_back(kernels::halve(level, options.jobs));
+                level = mips.back();
+            }
+
+            // NOTE(cme): the mips move while the vector grows, take their views after.
+            std::vector<BitmapView> levels = { bitmap };
+            for (auto &mip : mips)
+                levels.push_back(mip);
+
+            TextureHeader header;
+            std::memcpy(header.magic, TEXTURE_MAGIC, sizeof(TEXTURE_MAGIC));
+            header.version = VERSION;
+            header.width = (uint32_t)bitmap.width();
+            header.height = (uint32_t)bitmap.height();
+            header.depth = (uint32_t)bitmap.depth();
+            header.format = options.compress ? bc::formatFor(bitmap) : TextureFormat::Uncompressed;
+            header.levelCount = (uint32_t)levels.size();
+
+            std::vector<std::vector<uint8_t>> blocks;
+            if (options.compress)
+            {
+                for (auto &view : levels)
+                    blocks.push_back(bc::encode(view, header.format, options.jobs));
+            }
+
+            std::vector<TextureLevel> table(levels.size());
+            auto offset = alignUp(sizeof(header) + table.size() * sizeof(TextureLevel), DATA_ALIGNMENT);
+            for (size_t i = 0; i < levels.size(); ++i)
+            {
+                auto size = options.compress ? blocks[i].size() : (size_t)levels[i].width() * levels[i].height() * levels[i].depth();
+                table[i] = TextureLevel{ (uint32_t)levels[i].width(), (uint32_t)levels[i].height(), offset, (uint64_t)size };
+                offset = alignUp(offset + size, DATA_ALIGNMENT);
+            }
+
+            std::vector<uint8_t> result;
+            result.reserve(offset);
+            append(result, &header, 1);
+            append(result, table.data(), table.size());
+            for (size_t i = 0; i < levels.size(); ++i)
+            {
+                result.resize((size_t)table[i].offset, 0);
+                if (options.compress)
+                    append(result, blocks[i].data(), blocks[i].size());
+                else
+                {
+                    for (int y = 0; y < levels[i].height(); ++y)
+                        append(result, levels[i].row(y), (size_t)levels[i].width() * levels[i].depth());
+                }
+            }
+            return result;
+        }
+
+        std::vector<uint8_t> cookMesh(const Wavefront &object)
+        {
+            std::vector<float> vertices;
+            std::vector<uint32_t> indices;
+            std::unordered_map<Vertex, uint32_t, VertexHash> known;
+            indices.reserve(object.totalVertexCount());
+            known.reserve(object.totalVertexCount());
+            for (auto shape = 0u; shape < object.shapeCount(); ++shape)
+            {
+                for (auto triangle = 0u; triangle < object.triangleCount(shape); ++triangle)
+                {
+                    for (auto corner = 0; corner < 3; ++corner)
+                    {
+                        auto position = object.getPosition(shape, triangle, corner);
+                        auto texcoord = object.getTexCoord(shape, triangle, corner);
+                        auto normal = object.getNormal(shape, triangle, corner);
+                        auto vertex = Vertex{{ position.x, position.y, position.z, texcoord.u, texcoord.v, normal.x, normal.y, normal.z }};
+                        auto hit = known.emplace(vertex, (uint32_t)known.size());
+                        if (hit.second)
+                            vertices.insert(vertices.end(), vertex.begin(), vertex.end());
+                        indices.push_back(hit.first->second);
+                    }
+                }
+            }
+            optimizeVertexCache(indices, vertices.size() / FLOATS_PER_VERTEX);
+            optimizeVertexFetch(vertices, indices);
+
+            std::vector<uint8_t> names;
+            for (size_t material = 0; material < object.materialCount(); ++material)
+            {
+                auto name = object.getDiffuseTextureName((int)material);
+                auto size = (uint32_t)name.size();
+                append(names, &size, 1);
+                append(names, name.data(), name.size());
+            }
+
+            MeshHeader header;
+            std::memcpy(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC));
+            header.version = VERSION;
+            header.vertexCount = (uint32_t)(vertices.size() / FLOATS_PER_VERTEX);
+            header.indexCount = (uint32_t)indices.size();
+            header.materialCount = (uint32_t)object.materialCount();
+            header.namesSize = names.size();
+
+            std::vector<uint8_t> result;
+            append(result, &header, 1);
+            append(result, vertices.data(), vertices.size());
+            append(result, indices.data(), indices.size());
+            append(result, names.data(), names.size());
+            return result;
+        }
+
+        std::vector<uint8_t> cookFont(const Font &font, int firstCodepoint, int lastCodepoint)
+        {
+            struct Baked { FontGlyph glyph; Bitmap bitmap; };
+            std::vector<Baked> glyphs;
+            for (int codepoint = firstCodepoint; codepoint <= lastCodepoint; ++codepoint)
+            {
+                auto index = font.getGlyphIndex(codepoint);
+                if (std::any_of(glyphs.begin(), glyphs.end(), [&](const Baked &baked) { return baked.glyph.glyphIndex == index; }))
+                    continue;
+                auto bitmap = font.rasterizeGlyph(index);
+                glyphs.push_back(Baked{ FontGlyph{ index, 0, 0, (uint16_t)bitmap.width(), (uint16_t)bitmap.height() }, std::move(bitmap) });
+            }
+            std::sort(glyphs.begin(), glyphs.end(), [](const Baked &a, const Baked &b) { return a.glyph.glyphIndex < b.glyph.glyphIndex; });
+
+            // NOTE(cme): shelves, tallest glyphs first, with a pixel between glyphs so
+            //            that bilinear filtering doesn't bleed.
+            std::vector<Baked *> order;
+            int area = 0, widest = 0;
+            for (auto &baked : glyphs)
+            {
+                order.push_back(&baked);
+                area += (baked.glyph.width + 1) * (baked.glyph.height + 1);
+                widest = std::max(widest, baked.glyph.width + 2);
+            }
+            std::stable_sort(order.begin(), order.end(), [](const Baked *a, const Baked *b) { return a->glyph.height > b->glyph.height; });
+
+            int width = 64;
+            while (width < widest || width * width < area)
+                width *= 2;
+            int x = 1, y = 1, shelf = 0;
+            for (auto baked : order)
+            {
+                if (x + baked->glyph.width + 1 > width)
+                {
+                    x = 1;
+                    y += shelf + 1;
+                    shelf = 0;
+                }
+                baked->glyph.x = (uint16_t)x;
+                baked->glyph.y = (uint16_t)y;
+                x += baked->glyph.width + 1;
+                shelf = std::max(shelf, (int)baked->glyph.height);
+            }
+            int height = y + shelf + 1;
+
+            FontHeader header;
+            std::memcpy(header.magic, FONT_MAGIC, sizeof(FONT_MAGIC));
+            header.version = VERSION;
+            header.lineHeight = (uint32_t)font.lineHeight();
+            header.glyphCount = (uint32_t)glyphs.size();
+            header.atlasWidth = (uint32_t)width;
+            header.atlasHeight = (uint32_t)height;
+            header.reserved = 0;
+
+            std::vector<uint8_t> result;
+            append(result, &header, 1);
+            for (auto &baked : glyphs)
+                append(result, &baked.glyph, 1);
+            auto atlasOffset = alignUp(result.size(), DATA_ALIGNMENT);
+            result.resize(atlasOffset + (size_t)width * height, 0);
+            for (auto &baked : glyphs)
+            {
+                for (int row = 0; row < baked.glyph.height; ++row)
+                    std::memcpy(&result[atlasOffset + (size_t)(baked.glyph.y + row) * width + baked.glyph.x], baked.bitmap.pixels() + row * baked.bitmap.stride(), baked.glyph.width);
+            }
+            return result;
+        }
+
+        void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+        {
+            auto triangleCount = indices.size() / 3;
+            if (triangleCount == 0)
+                return;
+
+            // Triangles adjacent to each vertex, as ranges of one flat array.
+            std::vector<uint32_t> firstAdjacent(vertexCount + 1, 0), adjacent(indices.size());
+            for (auto index : indices)
+                ++firstAdjacent[index + 1];
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+                firstAdjacent[vertex + 1] += firstAdjacent[vertex];
+            std::vector<uint32_t> remaining(vertexCount, 0);
+            for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    auto vertex = indices[3*triangle + corner];
+                    adjacent[firstAdjacent[vertex] + remaining[vertex]++] = (uint32_t)triangle;
+                }
+            }
+
+            std::vector<int> cachePosition(vertexCount, -1);
+            std::vector<float> score(vertexCount), triangleScore(triangleCount, 0.0f);
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+                score[vertex] = vertexScore(-1, remaining[vertex]);
+            for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+                triangleScore[triangle] = score[indices[3*triangle]] + score[indices[3*triangle + 1]] + score[indices[3*triangle + 2]];
+
+            std::vector<bool> isEmitted(triangleCount, false);
+            std::vector<uint32_t> cache, nextCache, result;
+            result.reserve(indices.size());
+            size_t cursor = 0;
+            auto best = -1;
+            while (result.size() < indices.size())
+            {
+                // NOTE(cme): only when no triangle touches the cache, which is rare,
+                //            so the scan stays linear over the whole run.
+                if (best < 0)
+                {
+                    while (isEmitted[cursor])
+                        ++cursor;
+                    best = (int)cursor;
+                    for (auto triangle = cursor; triangle < triangleCount && triangle < cursor + 64; ++triangle)
+                        if (!isEmitted[triangle] && triangleScore[triangle] > triangleScore[best])
+                            best = (int)triangle;
+                }
+
+                isEmitted[best] = true;
+                nextCache.clear();
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    auto vertex = indices[3*best + corner];
+                    result.push_back(vertex);
+                    nextCache.push_back(vertex);
+
+                    auto first = adjacent.begin() + firstAdjacent[vertex];
+                    auto last = first + remaining[vertex];
+                    std::iter_swap(std::find(first, last, (uint32_t)best), last - 1);
+                    --remaining[vertex];
+                }
+                for (auto vertex : cache)
+                    if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end())
+                        nextCache.push_back(vertex);
+
+                for (size_t position = 0; position < nextCache.size(); ++position)
+                {
+                    auto vertex = nextCache[position];
+                    cachePosition[vertex] = position < (size_t)CACHE_SIZE ? (int)position : -1;
+                    score[vertex] = vertexScore(cachePosition[vertex], remaining[vertex]);
+                }
+                if (nextCache.size() > (size_t)CACHE_SIZE)
+                    nextCache.resize(CACHE_SIZE);
+                std::swap(cache, nextCache);
+
+                best = -1;
+                auto bestScore = -1.0f;
+                for (auto vertex : cache)
+                {
+                    for (auto a = firstAdjacent[vertex]; a < firstAdjacent[vertex] + remaining[vertex]; ++a)
+                    {
+                        auto triangle = adjacent[a];
+                        auto triangleScoreNow = score[indices[3*triangle]] + score[indices[3*triangle + 1]] + score[indices[3*triangle + 2]];
+                        triangleScore[triangle] = triangleScoreNow;
+                        if (triangleScoreNow > bestScore)
+                        {
+                            bestScore = triangleScoreNow;
+                            best = (int)triangle;
+                        }
+                    }
+                }
+            }
+            indices = std::move(result);
+        }
+
+        void optimizeVertexFetch(std::vector<float> &vertices, std::vector<uint32_t> &indices)
+        {
+            auto vertexCount = vertices.size() / FLOATS_PER_VERTEX;
+            std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+            std::vector<float> result;
+            result.reserve(vertices.size());
+            for (auto &index : indices)
+            {
+                if (remap[index] == UINT32_MAX)
+                {
+                    remap[index] = (uint32_t)(result.size() / FLOATS_PER_VERTEX);
+                    result.insert(result.end(), vertices.begin() + index * FLOATS_PER_VERTEX, vertices.begin() + (index + 1) * FLOATS_PER_VERTEX);
+                }
+                index = remap[index];
+            }
+            vertices = std::move(result);
+        }
+    }
+
+    CookedTexture::CookedTexture(const std::string &filename) : CookedTexture(fs::load(filename, fs::Access::Sequential), filename)
+    {
+    }
+
+    CookedTexture::CookedTexture(fs::FileData data, const std::string &name) : mData(std::move(data))
+    {
+        mHeader = checkHeader<cooked::TextureHeader>(mData, TEXTURE_MAGIC, name);
+        mLevels = reinterpret_cast<const cooked::TextureLevel *>(mData.data() + sizeof(cooked::TextureHeader));
+        panicif(sizeof(cooked::TextureHeader) + mHeader->levelCount * sizeof(cooked::TextureLevel) > mData.size(), "'%s' has its levels out of bounds", name);
+        for (size_t level = 0; level < mHeader->levelCount; ++level)
+            panicif(mLevels[level].offset > mData.size() || mLevels[level].size > mData.size() - mLevels[level].offset, "'%s' has a level out of bounds", name);
+    }
+
+    CookedTexture::Level CookedTexture::level(int index) const
+    {
+        auto &level = mLevels[index];
+        return Level{ (int)level.width, (int)level.height, mData.data() + level.offset, (size_t)level.size };
+    }
+
+    CookedMesh::CookedMesh(const std::string &filename, const std::string &baseDirectory)
+        : CookedMesh(fs::load(filename, fs::Access::Sequential), baseDirectory, filename)
+    {
+    }
+
+    CookedMesh::CookedMesh(fs::FileData data, const std::string &baseDirectory, const std::string &name) : mData(std::move(data)), mBaseDirectory(baseDirectory)
+    {
+        mHeader = checkHeader<cooked::MeshHeader>(mData, MESH_MAGIC, name);
+        auto verticesSize = (uint64_t)mHeader->vertexCount * cooked::FLOATS_PER_VERTEX * sizeof(float);
+        auto indicesSize = (uint64_t)mHeader->indexCount * sizeof(uint32_t);
+        panicif(sizeof(cooked::MeshHeader) + verticesSize + indicesSize + mHeader->namesSize != mData.size(), "'%s' has an unexpected size", name);
+        mVertices = reinterpret_cast<const float *>(mData.data() + sizeof(cooked::MeshHeader));
+        mIndices = reinterpret_cast<const uint32_t *>(mData.data() + sizeof(cooked::MeshHeader) + verticesSize);
+        for (size_t index = 0; index < mHeader->indexCount; ++index)
+            panicif(mIndices[index] >= mHeader->vertexCount, "'%s' has an index out of bounds", name);
+
+        auto names = mData.data() + sizeof(cooked::MeshHeader) + verticesSize + indicesSize;
+        auto end = names + mHeader->namesSize;
+        for (size_t material = 0; material < mHeader->materialCount; ++material)
+        {
+            uint32_t size;
+            panicif(end - names < (ptrdiff_t)sizeof(size), "'%s' has its material names out of bounds", name);
+            std::memcpy(&size, names, sizeof(size));
+            names += sizeof(size);
+            panicif(end - names < (ptrdiff_t)size, "'%s' has its material names out of bounds", name);
+            mDiffuseTextures.emplace_back(reinterpret_cast<const char *>(names), size);
+            names += size;
+        }
+    }
+
+    std::string CookedMesh::getDiffuseTextureFilename(int material) const
+    {
+        return fs::join(mBaseDirectory, mDiffuseTextures[material]);
+    }
+
+    CookedFont::CookedFont(const std::string &filename) : CookedFont(fs::load(filename, fs::Access::Random), filename)
+    {
+    }
+
+    CookedFont::CookedFont(fs::FileData data, const std::string &name) : mData(std::move(data))
+    {
+        mHeader = checkHeader<cooked::FontHeader>(mData, FONT_MAGIC, name);
+        auto atlasOffset = alignUp(sizeof(cooked::FontHeader) + mHeader->glyphCount * sizeof(cooked::FontGlyph), cooked::DATA_ALIGNMENT);
+        panicif(atlasOffset + (uint64_t)mHeader->atlasWidth * mHeader->atlasHeight > mData.size(), "'%s' has its atlas out of bounds", name);
+        mGlyphs = reinterpret_cast<const cooked::FontGlyph *>(mData.data() + sizeof(cooked::FontHeader));
+        mAtlas = mData.data() + atlasOffset;
+        for (size_t glyph = 0; glyph < mHeader->glyphCount; ++glyph)
+        {
+            auto &g = mGlyphs[glyph];
+            panicif((uint32_t)g.x + g.width > mHeader->atlasWidth || (uint32_t)g.y + g.height > mHeader->atlasHeight, "'%s' has a glyph out of its atlas", name);
+        }
+    }
+
+    const cooked::FontGlyph *CookedFont::find(int glyphIndex) const
+    {
+        auto end = mGlyphs + mHeader->glyphCount;
+        auto glyph = std::lower_bound(mGlyphs, end, glyphIndex, [](const cooked::FontGlyph &glyph, int index) { return glyph.glyphIndex < index; });
+        return (glyph != end && glyph->glyphIndex == glyphIndex) ? glyph : nullptr;
+    }
+
+    BitmapView CookedFont::view(const cooked::FontGlyph &glyph) const
+    {
+        return BitmapView(mAtlas, atlasWidth(), atlasHeight(), 1).region(glyph.x, glyph.y, glyph.width, glyph.height);
+    }
+
+    Bitmap CookedFont::extract(const cooked::FontGlyph &glyph) const
+    {
+        if (glyph.width == 0 || glyph.height == 0)
+            return Bitmap(1, 1, 1, Color(0));
+
+        auto source = view(glyph);
+        auto result = Bitmap(glyph.width, glyph.height, 1, Bitmap::Stride::Tight, &PixelPool::shared());
+        for (int row = 0; row < glyph.height; ++row)
+            std::memcpy(result.row(row), source.row(row), glyph.width);
+        return result;
+    }
+
+}}
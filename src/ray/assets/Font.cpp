@@ -1,7 +1,7 @@
 #include <ray/assets/Font.hpp>
+#include <ray/assets/Cooked.hpp>
 #include <ray/platform/Panic.hpp>
-#include <fstream>
-#include <ray/platform/FileSystem.hpp>
+#include <ray/platform/Pack.hpp>
 
 // NOTE(cme): silence two unused parameters
 #if defined(__clang__)
@@ -28,18 +28,20 @@ using namespace ray::math;
 
 namespace ray { namespace assets {
 
-    Font::Font(const std::string &filename, int lineHeight) : mInfo(sizeof(stbtt_fontinfo)), mLineHeight(lineHeight)
+    Font::Font(const std::string &filename, int lineHeight) : Font(fs::load(filename, fs::Access::Random), lineHeight) 
+    {
+        auto baked = cooked::find(cooked::fontPath(filename, lineHeight));
+        if (!baked.empty())
+            mBaked = std::make_shared<CookedFont>(baked);
+    }
+
+    Font::Font(fs::FileData data, int lineHeight) : mInfo(sizeof(stbtt_fontinfo)), mData(std::move(data)), mLineHeight(lineHeight)
     {
         using namespace ray::platform;
-        panicif(!fs::exists(filename), "attempting to open '"+filename+"' which does not exist");
-        std::ifstream file(filename, std::ios::binary | std::ios::ate);
-        std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
+        panicif(!mData.isValid(), "could not load font: %s", mData.error());
         
         auto fontInfo = reinterpret_cast<stbtt_fontinfo*>(mInfo.data());
 
-        mData.resize(size);
-        panicif(!file.read((char*)mData.data(), size), "could not read font file");
         panicif(!stbtt_InitFont(fontInfo, mData.data(), 0), "could not initialize font info");
         mScale = stbtt_ScaleForPixelHeight(fontInfo, mLineHeight);
         stbtt_GetFontVMetrics(fontInfo, &mAscent, &mDescent, nullptr);    
@@ -71,8 +73,24 @@ namespace ray { namespace assets {
         return stbtt_FindGlyphIndex(fontInfo, codepoint);
     }
     
+    BitmapView Font::bakedGlyph(int glyphIndex) const
+    {
+        if (mBaked)
+        {
+            if (auto glyph = mBaked->find(glyphIndex))
+                return mBaked->view(*glyph);
+        }
+        return BitmapView();
+    }
+
     Bitmap Font::rasterizeGlyph(int glyphIndex) const
     {
+        if (mBaked)
+        {
+            if (auto glyph = mBaked->find(glyphIndex))
+                return mBaked->extract(*glyph);
+        }
+
         auto fontInfo = reinterpret_cast<const stbtt_fontinfo*>(mInfo.data());                        
         static const int depth = 1;
         int width, height;
@@ -0,0 +1,124 @@
+#include <ray/assets/PixelPool.hpp>
+#include <ray/platform/Panic.hpp>
+#include <cstdlib>
+
+namespace ray { namespace assets {
+
+    constexpr size_t PixelPool::ALIGNMENT;
+    constexpr size_t PixelPool::MIN_CLASS_SIZE;
+    constexpr int PixelPool::CLASS_COUNT;
+
+    PixelPool::PixelPool(size_t maxCachedBytes) : mMaxCachedBytes(maxCachedBytes)
+    {
+    }
+
+    PixelPool::~PixelPool()
+    {
+        trim();
+    }
+
+    uint8_t *PixelPool::acquire(size_t size)
+    {
+        auto index = sizeClass(size);
+        if (index < 0)
+            return allocateAligned(size);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto &free = mFree[index];
+            if (!free.empty())
+            {
+                auto pixels = free.back();
+                free.pop_back();
+                mCachedBytes -= MIN_CLASS_SIZE << index;
+                ++mHits;
+                return pixels;
+            }
+            ++mMisses;
+        }
+        return allocateAligned(MIN_CLASS_SIZE << index);
+    }
+
+    void PixelPool::release(uint8_t *pixels, size_t size)
+    {
+        if (pixels == nullptr)
+            return;
+        auto index = sizeClass(size);
+        if (index >= 0)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mCachedBytes + (MIN_CLASS_SIZE << index) <= mMaxCachedBytes)
+            {
+                mFree[index].push_back(pixels);
+                mCachedBytes += MIN_CLASS_SIZE << index;
+                return;
+            }
+        }
+        freeAligned(pixels);
+    }
+
+    void PixelPool::trim()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto &free : mFree)
+        {
+            for (auto pixels : free)
+                freeAligned(pixels);
+            free.clear();
+        }
+        mCachedBytes = 0;
+    }
+
+    size_t PixelPool::cachedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCachedBytes;
+    }
+
+    size_t PixelPool::hitCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mHits;
+    }
+
+    size_t PixelPool::missCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMisses;
+    }
+
+    int PixelPool::sizeClass(size_t size)
+    {
+        auto index = 0;
+        while ((MIN_CLASS_SIZE << index) < size)
+        {
+            if (++index == CLASS_COUNT)
+                return -1;
+        }
+        return index;
+    }
+
+    PixelPool &PixelPool::shared()
+    {
+        static auto instance = new PixelPool();
+        return *instance;
+    }
+
+    // NOTE(cme): the pointer malloc returned is kept right before the aligned one.
+    uint8_t *PixelPool::allocateAligned(size_t size)
+    {
+        auto block = reinterpret_cast<uint8_t *>(malloc(size + ALIGNMENT + sizeof(void *)));
+        panicif(block == nullptr, "could not allocate %d bytes of pixels", size);
+        auto address = reinterpret_cast<uintptr_t>(block + sizeof(void *));
+        auto pixels = reinterpret_cast<uint8_t *>((address + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1));
+        reinterpret_cast<void **>(pixels)[-1] = block;
+        return pixels;
+    }
+
+    void PixelPool::freeAligned(uint8_t *pixels)
+    {
+        if (pixels)
+            free(reinterpret_cast<void **>(pixels)[-1]);
+    }
+
+}}
@@ -1,37 +1,85 @@
 #include <ray/components/TextureAtlas.hpp>
+#include <ray/assets/BitmapKernels.hpp>
+#include <ray/gl/UploadRing.hpp>
 
 using namespace ray::math;
 
 #undef max
+#undef min
 
 namespace ray { namespace components {
 
-    TextureAtlas::TextureAtlas(int depth) : mCursor{1,1}, mNextY(1)
+    constexpr int TextureAtlas::DEFAULT_SIZE;
+
+    namespace
+    {
+        int defaultSize()
+        {
+            int maxTextureSize;
+            glGetIntegerv(GL_MAX_RECTANGLE_TEXTURE_SIZE, &maxTextureSize);
+            return std::min(maxTextureSize, TextureAtlas::DEFAULT_SIZE);
+        }
+    }
+
+    TextureAtlas::TextureAtlas(int depth) : TextureAtlas(defaultSize(), defaultSize(), depth)
     {
-        int maxTextureSize;
-        glGetIntegerv(GL_MAX_RECTANGLE_TEXTURE_SIZE, &maxTextureSize);
-        resize(maxTextureSize, maxTextureSize, depth);
+    }
+
+    TextureAtlas::TextureAtlas(int width, int height, int depth) 
+        : mPixels(width, height, depth, Bitmap::Stride::Aligned), mCursor{1,1}, mNextY(1)
+    {
+        markClean();
+        mPixels.fill(Color(0));
+        load(mPixels);
     }
     
-    rect2 TextureAtlas::add(int width, int height, int depth, const u8 *pixels)
+    rect2 TextureAtlas::add(const BitmapView &bitmap)
     {
-        panicif(depth != this->depth(), "not the same depth");
+        auto width = bitmap.width(), height = bitmap.height();
+        panicif(bitmap.depth() != mPixels.depth(), "not the same depth");
 
-        if (mCursor.x + width > this->width())   mCursor = ivec2{1, mNextY};
-        if (mCursor.y + height > this->height()) panic("atlas (%d,%d) too small for bitmap (%d,%d), current cursor (%d,%d)", this->width(), this->height(), width, height, mCursor.x, mCursor.y);
+        if (mCursor.x + width > mPixels.width())   mCursor = ivec2{1, mNextY};
+        if (mCursor.y + height > mPixels.height()) panic("atlas (%d,%d) too small for bitmap (%d,%d), current cursor (%d,%d)", mPixels.width(), mPixels.height(), width, height, mCursor.x, mCursor.y);
         
-        loadAt(mCursor.x, mCursor.y, width, height, depth, pixels);
+        assets::kernels::blit(bitmap, mPixels, mCursor.x, mCursor.y);
         
         auto min = mCursor;
         auto max = min + ivec2{width, height};
+        mDirtyMin = ivec2{std::min(mDirtyMin.x, min.x), std::min(mDirtyMin.y, min.y)};
+        mDirtyMax = ivec2{std::max(mDirtyMax.x, max.x), std::max(mDirtyMax.y, max.y)};
         
         mNextY = std::max(mNextY, mCursor.y + height);
         mCursor.x += width + 1;
         
         return rect2 { 
-            { (float)min.x / (float)this->width(), (float)min.y / (float)this->height() },
-            { (float)max.x / (float)this->width(), (float)max.y / (float)this->height() }
+            { (float)min.x / (float)mPixels.width(), (float)min.y / (float)mPixels.height() },
+            { (float)max.x / (float)mPixels.width(), (float)max.y / (float)mPixels.height() }
         };
     }
 
-}}
\ No newline at end of file
+    void TextureAtlas::flush()
+    {
+        if (!isDirty())
+            return;
+        auto size = mDirtyMax - mDirtyMin;
+        loadAt(mDirtyMin.x, mDirtyMin.y, BitmapView(mPixels).region(mDirtyMin.x, mDirtyMin.y, size.x, size.y));
+        markClean();
+    }
+
+    void TextureAtlas::flush(gl::UploadRing &ring)
+    {
+        if (!isDirty())
+            return;
+        auto size = mDirtyMax - mDirtyMin;
+        if (!ring.upload(*this, mDirtyMin.x, mDirtyMin.y, BitmapView(mPixels).region(mDirtyMin.x, mDirtyMin.y, size.x, size.y)))
+            return flush();
+        markClean();
+    }
+
+    void TextureAtlas::markClean()
+    {
+        mDirtyMin = ivec2{mPixels.width(), mPixels.height()};
+        mDirtyMax = ivec2{0, 0};
+    }
+
+}}
@@ -0,0 +1,165 @@
+#include <ray/gl/ProgramBinaryCache.hpp>
+#include <ray/platform/FileSystem.hpp>
+#include <ray/platform/Hash.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace ray { namespace gl {
+
+    namespace
+    {
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t format;
+            uint32_t length;
+            uint64_t key;
+        };
+
+        constexpr uint32_t BinaryMagic   = 0x4E425952; // "RYBN"
+        constexpr uint32_t BinaryVersion = 2;
+
+        // NOTE(cme): length first, so that the strings hashed one after the other
+        //            can't be split differently into the same bytes.
+        uint64_t hashString(const char *text, uint64_t hash)
+        {
+            uint64_t length = text ? std::strlen(text) : UINT64_MAX;
+            hash = platform::fnv1a64(reinterpret_cast<const char *>(&length), sizeof(length), hash);
+            return text ? platform::fnv1a64(text, (size_t)length, hash) : hash;
+        }
+
+        const char *getString(GLenum name)
+        {
+            return reinterpret_cast<const char *>(glGetString(name));
+        }
+    }
+
+    ProgramBinaryCache::ProgramBinaryCache(const std::string &directory) : mDirectory(directory)
+    {
+        platform::fs::createDirectories(mDirectory);
+
+        mDriverHash = platform::fnv1a64("", 0);
+        mDriverHash = hashString(getString(GL_VENDOR), mDriverHash);
+        mDriverHash = hashString(getString(GL_RENDERER), mDriverHash);
+        mDriverHash = hashString(getString(GL_VERSION), mDriverHash);
+
+        mSupported = platform::hasOpenGLVersion(4, 1) || platform::hasOpenGLExtension("GL_ARB_get_program_binary");
+        if (mSupported)
+        {
+            GLint formatCount = 0;
+            gl(GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+            mSupported = (formatCount > 0);
+            if (mSupported)
+            {
+                mFormats.resize((size_t)formatCount);
+                gl(GetIntegerv(GL_PROGRAM_BINARY_FORMATS, mFormats.data()));
+            }
+        }
+    }
+
+    uint64_t ProgramBinaryCache::key(const char *vertexShader, const char *fragmentShader) const
+    {
+        auto result = hashString(vertexShader, mDriverHash);
+        return hashString(fragmentShader, result);
+    }
+
+    bool ProgramBinaryCache::load(GLuint program, uint64_t key)
+    {
+        if (!mSupported) 
+            return false;
+
+        std::ifstream file(path(key), std::ios::binary);
+        if (!file) 
+            return false;
+
+        Header header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+        if (header.magic != BinaryMagic || header.version != BinaryVersion || header.key != key)
+            return false;
+
+        std::vector<char> binary(header.length);
+        if (!file.read(binary.data(), (std::streamsize)binary.size()))
+            return false;
+
+        // NOTE(cme): a format the driver dropped is an error rather than a failed link,
+        //            hence the check first and the call without gl(), which would abort.
+        GLint success = GL_FALSE;
+        if (std::find(mFormats.begin(), mFormats.end(), (GLint)header.format) != mFormats.end())
+        {
+            glProgramBinary(program, (GLenum)header.format, binary.data(), (GLsizei)binary.size());
+            if (glGetError() == GL_NO_ERROR)
+                gl(GetProgramiv(program, GL_LINK_STATUS, &success));
+        }
+        if (!success)
+        {
+            file.close();
+            std::remove(path(key).c_str());
+            ++mStatistics.rejected;
+            return false;
+        }
+        return true;
+    }
+
+    void ProgramBinaryCache::store(GLuint program, uint64_t key) const
+    {
+        if (!mSupported) 
+            return;
+
+        GLint length = 0;
+        gl(GetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+        if (length <= 0) 
+            return;
+
+        std::vector<char> binary((size_t)length);
+        GLenum format = 0;
+        gl(GetProgramBinary(program, length, nullptr, &format, binary.data()));
+
+        Header header{BinaryMagic, BinaryVersion, (uint32_t)format, (uint32_t)length, key};
+        
+        // NOTE(cme): written next to the final file and renamed, so that a crash
+        //            or a concurrent run never leaves a truncated binary behind.
+        auto finalPath = path(key);
+        auto temporaryPath = finalPath + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file) 
+                return;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), (std::streamsize)binary.size());
+            if (!file) 
+            {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return;
+            }
+        }
+        std::rename(temporaryPath.c_str(), finalPath.c_str());
+    }
+
+    void ProgramBinaryCache::record(bool hit, platform::sec elapsed)
+    {
+        if (hit)
+        {
+            ++mStatistics.hits;
+            mStatistics.warmTime += elapsed;
+        }
+        else
+        {
+            ++mStatistics.misses;
+            mStatistics.coldTime += elapsed;
+        }
+    }
+
+    std::string ProgramBinaryCache::path(uint64_t key) const
+    {
+        char filename[32];
+        std::snprintf(filename, sizeof(filename), "%016llx.bin", (unsigned long long)key);
+        return platform::fs::join(mDirectory, filename);
+    }
+
+}}
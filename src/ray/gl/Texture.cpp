@@ -2,12 +2,13 @@
   
 namespace ray { namespace gl {
 
-    void Texture::loadAt(int x, int y, int width, int height, int depth, const GLubyte *pixels) const
+    void Texture::loadAt(int x, int y, const BitmapView &bitmap) const
     {
         bind();
-        gl(PixelStorei(GL_UNPACK_ROW_LENGTH, width*depth));
-        gl(PixelStorei(GL_UNPACK_ALIGNMENT, 1));
-        switch(depth)
+        details::UnpackRows rows(bitmap);
+        auto width = bitmap.width(), height = bitmap.height();
+        auto pixels = bitmap.pixels();
+        switch(bitmap.depth())
         {
         case 1:
             gl(TexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE, pixels));
@@ -22,10 +23,8 @@ namespace ray { namespace gl {
             gl(TexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
             break;
         default:
-            panic("unexpected number of channels '%d'", depth);
+            panic("unexpected number of channels '%d'", bitmap.depth());
         }
-        gl(PixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-        gl(PixelStorei(GL_UNPACK_ALIGNMENT, 4));
         gl(GenerateMipmap(GL_TEXTURE_2D));
     }
 
@@ -1,5 +1,6 @@
 #include <ray/platform/FileSystem.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 
 namespace boostfs = boost::filesystem;
 
@@ -10,6 +11,13 @@ namespace ray { namespace platform { namespace fs {
         auto status = boostfs::status(path);
         return (status.type() != boostfs::file_not_found);
     }
+
+    bool createDirectories(const std::string &path)
+    {
+        boost::system::error_code error;
+        boostfs::create_directories(path, error);
+        return !error;
+    }
   
     std::string extension(const std::string &path)
     {
@@ -36,4 +44,23 @@ namespace ray { namespace platform { namespace fs {
         return boostfs::path(path).is_absolute();
     }
 
-}}}
\ No newline at end of file
+    std::vector<std::string> listFiles(const std::string &directory)
+    {
+        std::vector<std::string> result;
+        boost::system::error_code error;
+        auto root = boostfs::path(directory);
+        for (auto entry = boostfs::recursive_directory_iterator(root, error); !error && entry != boostfs::recursive_directory_iterator(); entry.increment(error))
+        {
+            if (!boostfs::is_regular_file(entry->status()))
+                continue;
+            auto relative = entry->path().string().substr(root.string().size());
+            while (!relative.empty() && (relative[0] == '/' || relative[0] == '\\'))
+                relative.erase(0, 1);
+            std::replace(relative.begin(), relative.end(), '\\', '/');
+            result.push_back(relative);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+}}}
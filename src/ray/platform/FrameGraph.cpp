@@ -0,0 +1,121 @@
+#include <ray/platform/FrameGraph.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+
+namespace ray { namespace platform {
+
+    namespace
+    {
+        using TaskId = FrameGraph::TaskId;
+
+        void addUnique(std::vector<TaskId> &tasks, TaskId task)
+        {
+            if (std::find(tasks.begin(), tasks.end(), task) == tasks.end())
+                tasks.push_back(task);
+        }
+    }
+
+    FrameGraph::Resource FrameGraph::resource(const std::string &name)
+    {
+        auto existing = mResources.find(name);
+        if (existing != mResources.end())
+            return existing->second;
+        auto result = (Resource)mResources.size();
+        mResources[name] = result;
+        return result;
+    }
+
+    FrameGraph::TaskBuilder FrameGraph::addTask(const std::string &name, std::function<void()> function)
+    {
+        panicif(!mFrame.isDone(), "cannot add task '%s' while a frame is running", name);
+        Task task;
+        task.name = name;
+        task.function = std::move(function);
+        mTasks.push_back(std::move(task));
+        mIsCompiled = false;
+        return TaskBuilder(*this, (TaskId)(mTasks.size() - 1));
+    }
+
+    void FrameGraph::start(JobSystem &jobs)
+    {
+        panicif(!mFrame.isDone(), "the previous frame is still running");
+        compile();
+
+        for (TaskId task = 0; task < mTasks.size(); ++task)
+            mRemaining[task] = (uint32_t)mTasks[task].dependencies.size();
+        for (TaskId task = 0; task < mTasks.size(); ++task)
+            if (mTasks[task].dependencies.empty())
+                launch(jobs, task);
+    }
+
+    void FrameGraph::publish()
+    {
+        panicif(!mFrame.isDone(), "cannot publish snapshots while a frame is running");
+        for (auto snapshot : mSnapshots)
+            snapshot->publish();
+    }
+
+    const std::vector<TaskId> &FrameGraph::dependencies(TaskId task)
+    {
+        compile();
+        return mTasks[task].dependencies;
+    }
+
+    void FrameGraph::compile()
+    {
+        if (mIsCompiled)
+            return;
+
+        std::vector<TaskId> lastWriter(mResources.size(), UINT32_MAX);
+        std::vector<std::vector<TaskId>> readers(mResources.size());
+        for (auto &task : mTasks)
+        {
+            task.dependencies.clear();
+            task.successors.clear();
+        }
+
+        for (TaskId id = 0; id < mTasks.size(); ++id)
+        {
+            auto &task = mTasks[id];
+            for (auto resource : task.reads)
+            {
+                if (lastWriter[resource] != UINT32_MAX && lastWriter[resource] != id)
+                    addUnique(task.dependencies, lastWriter[resource]);
+                addUnique(readers[resource], id);
+            }
+            for (auto resource : task.writes)
+            {
+                if (lastWriter[resource] != UINT32_MAX && lastWriter[resource] != id)
+                    addUnique(task.dependencies, lastWriter[resource]);
+                for (auto reader : readers[resource])
+                    if (reader != id)
+                        addUnique(task.dependencies, reader);
+                lastWriter[resource] = id;
+                readers[resource].clear();
+            }
+            for (auto dependency : task.dependencies)
+                mTasks[dependency].successors.push_back(id);
+        }
+
+        mRemaining.reset(new std::atomic<uint32_t>[mTasks.size()]);
+        mIsCompiled = true;
+    }
+
+    void FrameGraph::launch(JobSystem &jobs, TaskId id)
+    {
+        // NOTE(cme): successors are submitted before the task counts as done, so the
+        //            frame counter can't reach zero while some are still to come.
+        auto job = [this, &jobs, id]() {
+            mTasks[id].function();
+            for (auto successor : mTasks[id].successors)
+                if (mRemaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    launch(jobs, successor);
+        };
+
+        if (mTasks[id].isOnMainThread)
+            jobs.submitToMainThread(job, &mFrame);
+        else
+            jobs.submit(job, &mFrame);
+    }
+
+}}
@@ -0,0 +1,191 @@
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/Panic.hpp>
+
+namespace ray { namespace platform {
+
+    namespace
+    {
+        constexpr size_t NO_WORKER = SIZE_MAX;
+
+        // NOTE(cme): several job systems can coexist, e.g. in tests, so the worker
+        //            index only means something for the system that set it.
+        thread_local const JobSystem *tSystem = nullptr;
+        thread_local size_t tWorker = NO_WORKER;
+    }
+
+    JobSystem::JobSystem(size_t workerCount)
+        : mNextWorker(0), mQueued(0), mIsRunning(true), mMainThread(std::this_thread::get_id())
+    {
+        panicif(workerCount == 0, "a job system needs at least one worker");
+        for (size_t worker = 0; worker < workerCount; ++worker)
+            mWorkers.emplace_back(new Worker());
+        for (size_t worker = 0; worker < workerCount; ++worker)
+            mWorkers[worker]->thread = std::thread([this, worker]() { work(worker); });
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mIsRunning = false;
+        }
+        mWakeUp.notify_all();
+        for (auto &worker : mWorkers)
+            worker->thread.join();
+    }
+
+    void JobSystem::submit(Job job, Counter *counter)
+    {
+        if (counter)
+            counter->mValue.fetch_add(1, std::memory_order_relaxed);
+        push(Task{ std::move(job), counter });
+    }
+
+    void JobSystem::submitAfter(const Counter &dependency, Job job, Counter *counter)
+    {
+        if (counter)
+            counter->mValue.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mDeferredMutex);
+            if (!dependency.isDone())
+            {
+                mDeferred.push_back(Deferred{ &dependency, Task{ std::move(job), counter } });
+                return;
+            }
+        }
+        push(Task{ std::move(job), counter });
+    }
+
+    void JobSystem::wait(const Counter &counter)
+    {
+        auto worker = tSystem == this ? tWorker : NO_WORKER;
+        while (!counter.isDone())
+        {
+            if (runOne(worker))
+                continue;
+            if (isMainThread() && runMainThreadJobs() > 0)
+                continue;
+            std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::submitToMainThread(Job job, Counter *counter)
+    {
+        if (counter)
+            counter->mValue.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mMainThreadMutex);
+        mMainThreadTasks.push_back(Task{ std::move(job), counter });
+    }
+
+    size_t JobSystem::runMainThreadJobs()
+    {
+        panicif(!isMainThread(), "main thread jobs can only run on the main thread");
+        std::deque<Task> tasks;
+        {
+            std::lock_guard<std::mutex> lock(mMainThreadMutex);
+            tasks.swap(mMainThreadTasks);
+        }
+        for (auto &task : tasks)
+            run(task);
+        return tasks.size();
+    }
+
+    void JobSystem::push(Task task)
+    {
+        // NOTE(cme): counted before it is visible so that the count never goes below zero.
+        auto worker = tSystem == this ? tWorker : mNextWorker++ % mWorkers.size();
+        ++mQueued;
+        {
+            std::lock_guard<std::mutex> lock(mWorkers[worker]->mutex);
+            mWorkers[worker]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+        }
+        mWakeUp.notify_one();
+    }
+
+    bool JobSystem::pop(size_t worker, Task &task)
+    {
+        auto &self = *mWorkers[worker];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (self.tasks.empty())
+            return false;
+        task = std::move(self.tasks.back());
+        self.tasks.pop_back();
+        --mQueued;
+        return true;
+    }
+
+    bool JobSystem::steal(size_t thief, Task &task)
+    {
+        auto start = thief == NO_WORKER ? 0 : thief + 1;
+        for (size_t i = 0; i < mWorkers.size(); ++i)
+        {
+            auto &victim = *mWorkers[(start + i) % mWorkers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty())
+                continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --mQueued;
+            return true;
+        }
+        return false;
+    }
+
+    bool JobSystem::runOne(size_t worker)
+    {
+        Task task;
+        if ((worker != NO_WORKER && pop(worker, task)) || steal(worker, task))
+        {
+            run(task);
+            return true;
+        }
+        return false;
+    }
+
+    void JobSystem::run(Task &task)
+    {
+        task.job();
+        if (task.counter && task.counter->mValue.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            releaseDeferred();
+    }
+
+    void JobSystem::releaseDeferred()
+    {
+        std::vector<Task> ready;
+        {
+            std::lock_guard<std::mutex> lock(mDeferredMutex);
+            for (auto deferred = mDeferred.begin(); deferred != mDeferred.end();)
+            {
+                if (!deferred->dependency->isDone())
+                {
+                    ++deferred;
+                    continue;
+                }
+                ready.push_back(std::move(deferred->task));
+                deferred = mDeferred.erase(deferred);
+            }
+        }
+        for (auto &task : ready)
+            push(std::move(task));
+    }
+
+    void JobSystem::work(size_t worker)
+    {
+        tSystem = this;
+        tWorker = worker;
+        while (true)
+        {
+            if (runOne(worker))
+                continue;
+
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mWakeUp.wait(lock, [this]() { return mQueued > 0 || !mIsRunning; });
+            if (!mIsRunning && mQueued == 0)
+                return;
+        }
+    }
+
+}}
@@ -0,0 +1,167 @@
+#include <ray/platform/Lz4.hpp>
+#include <cstring>
+
+namespace ray { namespace platform { namespace lz4 {
+
+    namespace
+    {
+        constexpr size_t MIN_MATCH = 4;
+        constexpr size_t LAST_LITERALS = 5;     // the last bytes are always literals
+        constexpr size_t MATCH_FIND_LIMIT = 12; // no match starts closer to the end
+        constexpr size_t MAX_OFFSET = 65535;
+        constexpr int HASH_BITS = 12;
+
+        uint32_t read32(const uint8_t *bytes)
+        {
+            uint32_t result;
+            std::memcpy(&result, bytes, sizeof(result));
+            return result;
+        }
+
+        uint32_t hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+        // Writes 'length' the way LZ4 does past a 4 bits field: runs of 255 and a remainder.
+        uint8_t *writeLength(uint8_t *out, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+                *out++ = 255;
+            *out++ = (uint8_t)length;
+            return out;
+        }
+
+        size_t lengthBytes(size_t length) { return length >= 15 ? (length - 15) / 255 + 1 : 0; }
+    }
+
+    size_t compress(const uint8_t *source, size_t size, uint8_t *destination, size_t capacity)
+    {
+        auto out = destination, outEnd = destination + capacity;
+        size_t anchor = 0;
+
+        auto emit = [&](size_t literalEnd, size_t offset, size_t matchLength) {
+            auto literals = literalEnd - anchor;
+            auto needed = 1 + lengthBytes(literals) + literals + (offset ? 2 + lengthBytes(matchLength - MIN_MATCH) : 0);
+            if ((size_t)(outEnd - out) < needed)
+                return false;
+
+            auto token = out++;
+            *token = (uint8_t)((literals >= 15 ? 15 : literals) << 4);
+            if (literals >= 15)
+                out = writeLength(out, literals - 15);
+            if (literals > 0)
+                std::memcpy(out, source + anchor, literals);
+            out += literals;
+            if (offset == 0)
+                return true;
+
+            *out++ = (uint8_t)(offset & 0xFF);
+            *out++ = (uint8_t)(offset >> 8);
+            auto length = matchLength - MIN_MATCH;
+            *token |= (uint8_t)(length >= 15 ? 15 : length);
+            if (length >= 15)
+                out = writeLength(out, length - 15);
+            return true;
+        };
+
+        if (size > MATCH_FIND_LIMIT)
+        {
+            // NOTE(cme): positions of the last sequences seen, a stale or colliding
+            //            entry is caught by comparing the bytes.
+            uint32_t table[1 << HASH_BITS] = {};
+            auto findLimit = size - MATCH_FIND_LIMIT, matchLimit = size - LAST_LITERALS;
+            size_t position = 1;
+            while (position < findLimit)
+            {
+                auto sequence = read32(source + position);
+                auto &slot = table[hash(sequence)];
+                size_t candidate = slot;
+                slot = (uint32_t)position;
+
+                if (position - candidate > MAX_OFFSET || read32(source + candidate) != sequence)
+                {
+                    // NOTE(cme): skips faster through data that doesn't compress.
+                    position += 1 + ((position - anchor) >> 6);
+                    continue;
+                }
+
+                while (position > anchor && candidate > 0 && source[position - 1] == source[candidate - 1])
+                {
+                    --position;
+                    --candidate;
+                }
+                auto length = MIN_MATCH;
+                while (position + length < matchLimit && source[position + length] == source[candidate + length])
+                    ++length;
+
+                if (!emit(position, position - candidate, length))
+                    return 0;
+                position += length;
+                anchor = position;
+                if (position - 2 < findLimit)
+                    table[hash(read32(source + position - 2))] = (uint32_t)(position - 2);
+            }
+        }
+
+        if (!emit(size, 0, 0))
+            return 0;
+        return (size_t)(out - destination);
+    }
+
+    bool decompress(const uint8_t *source, size_t sourceSize, uint8_t *destination, size_t size)
+    {
+        auto in = source, inEnd = source + sourceSize;
+        auto out = destination, outEnd = destination + size;
+
+        auto readLength = [&](size_t &length) {
+            uint8_t byte;
+            do
+            {
+                if (in == inEnd)
+                    return false;
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        };
+
+        while (in < inEnd)
+        {
+            auto token = *in++;
+            size_t literals = token >> 4;
+            if (literals == 15 && !readLength(literals))
+                return false;
+            if ((size_t)(inEnd - in) < literals || (size_t)(outEnd - out) < literals)
+                return false;
+            if (literals > 0)
+                std::memcpy(out, in, literals);
+            in += literals;
+            out += literals;
+            if (in == inEnd)
+                break;
+
+            if (inEnd - in < 2)
+                return false;
+            size_t offset = in[0] | (in[1] << 8);
+            in += 2;
+            if (offset == 0 || offset > (size_t)(out - destination))
+                return false;
+
+            size_t length = token & 15;
+            if (length == 15 && !readLength(length))
+                return false;
+            length += MIN_MATCH;
+            if ((size_t)(outEnd - out) < length)
+                return false;
+
+            // NOTE(cme): matches may overlap what they produce, e.g. runs of one byte.
+            auto match = out - offset;
+            if (offset >= length)
+                std::memcpy(out, match, length);
+            else
+                for (size_t i = 0; i < length; ++i)
+                    out[i] = match[i];
+            out += length;
+        }
+        return out == outEnd;
+    }
+
+}}}
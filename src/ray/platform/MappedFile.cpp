@@ -0,0 +1,192 @@
+#include <ray/platform/MappedFile.hpp>
+#include <ray/platform/Panic.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace ray { namespace platform { namespace fs {
+
+    MappedFile::MappedFile(const std::string &filename, Access access)
+    {
+        std::string error;
+        panicif(!open(filename, access, &error), "could not map '%s': %s", filename, error);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other)
+    {
+        if (this == &other)
+            return *this;
+        close();
+        mData = other.mData;
+        mSize = other.mSize;
+        mIsOpen = other.mIsOpen;
+#ifdef _WIN32
+        mFile = other.mFile;
+        mMapping = other.mMapping;
+        other.mFile = other.mMapping = nullptr;
+#endif
+        other.mData = nullptr;
+        other.mSize = 0;
+        other.mIsOpen = false;
+        return *this;
+    }
+
+#ifdef _WIN32
+
+    bool MappedFile::open(const std::string &filename, Access access, std::string *error)
+    {
+        close();
+        auto flags = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : access == Access::Random ? FILE_FLAG_RANDOM_ACCESS : FILE_ATTRIBUTE_NORMAL;
+        mFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE)
+        {
+            mFile = nullptr;
+            if (error) *error = fmt("error %d", GetLastError());
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        GetFileSizeEx(mFile, &size);
+        mSize = (size_t)size.QuadPart;
+        mIsOpen = true;
+        if (mSize == 0)
+            return true;
+
+        mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        mData = mMapping ? static_cast<const uint8_t *>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        if (mData == nullptr)
+        {
+            if (error) *error = fmt("error %d", GetLastError());
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMapping)
+            CloseHandle(mMapping);
+        if (mFile)
+            CloseHandle(mFile);
+        mData = nullptr;
+        mMapping = mFile = nullptr;
+        mSize = 0;
+        mIsOpen = false;
+    }
+
+    // NOTE(cme): the access pattern is given to CreateFile, there is nothing to
+    //            change once the file is mapped.
+    void MappedFile::advise(Access access, size_t offset, size_t size)
+    {
+        (void)access; (void)offset; (void)size;
+    }
+
+#else
+
+    bool MappedFile::open(const std::string &filename, Access access, std::string *error)
+    {
+        close();
+        auto file = ::open(filename.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            if (error) *error = std::strerror(errno);
+            return false;
+        }
+
+        struct stat status;
+        if (fstat(file, &status) != 0)
+        {
+            if (error) *error = std::strerror(errno);
+            ::close(file);
+            return false;
+        }
+
+        // NOTE(cme): mmap refuses empty mappings, an empty file is still a valid one.
+        mSize = (size_t)status.st_size;
+        mIsOpen = true;
+        if (mSize > 0)
+        {
+            auto mapping = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+            if (mapping == MAP_FAILED)
+            {
+                if (error) *error = std::strerror(errno);
+                ::close(file);
+                mSize = 0;
+                mIsOpen = false;
+                return false;
+            }
+            mData = static_cast<const uint8_t *>(mapping);
+        }
+        ::close(file);
+        advise(access);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (mData)
+            munmap(const_cast<uint8_t *>(mData), mSize);
+        mData = nullptr;
+        mSize = 0;
+        mIsOpen = false;
+    }
+
+    void MappedFile::advise(Access access, size_t offset, size_t size)
+    {
+        if (mData == nullptr || offset >= mSize)
+            return;
+
+        // NOTE(cme): madvise wants a page aligned address.
+        auto pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        auto first = offset - offset % pageSize;
+        auto last = size < mSize - offset ? offset + size : mSize;
+
+        auto advice = MADV_NORMAL;
+        switch (access)
+        {
+            case Access::Normal:     advice = MADV_NORMAL; break;
+            case Access::Sequential: advice = MADV_SEQUENTIAL; break;
+            case Access::Random:     advice = MADV_RANDOM; break;
+            case Access::WillNeed:   advice = MADV_WILLNEED; break;
+        }
+        madvise(const_cast<uint8_t *>(mData) + first, last - first, advice);
+    }
+
+#endif
+
+    FileData mapFile(const std::string &filename, Access access)
+    {
+        MappedFile file;
+        std::string error;
+        if (!file.open(filename, access, &error))
+            return FileData::failed(fmt("could not map '%s': %s", filename, error));
+        return FileData(std::move(file));
+    }
+
+    FileData readFile(const std::string &filename)
+    {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file)
+            return FileData::failed(fmt("could not open '%s'", filename));
+
+        std::vector<uint8_t> bytes((size_t)file.tellg());
+        file.seekg(0, std::ios::beg);
+        if (!file.read(reinterpret_cast<char *>(bytes.data()), (std::streamsize)bytes.size()))
+            return FileData::failed(fmt("could not read '%s'", filename));
+        return FileData(std::move(bytes));
+    }
+
+}}}
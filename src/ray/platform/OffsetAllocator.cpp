@@ -0,0 +1,283 @@
+#include <ray/platform/OffsetAllocator.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ray { namespace platform {
+
+    namespace
+    {
+        using u32 = OffsetAllocator::u32;
+
+        constexpr u32 SECOND_LEVEL_BITS = 3;
+
+        u32 highestBit(u32 value)
+        {
+#if defined(_MSC_VER)
+            unsigned long result;
+            _BitScanReverse(&result, value);
+            return (u32)result;
+#else
+            return 31 - (u32)__builtin_clz(value);
+#endif
+        }
+
+        u32 lowestBit(u32 value)
+        {
+#if defined(_MSC_VER)
+            unsigned long result;
+            _BitScanForward(&result, value);
+            return (u32)result;
+#else
+            return (u32)__builtin_ctz(value);
+#endif
+        }
+
+        // NOTE(cme): sizes below 2^SECOND_LEVEL_BITS get one bin each in the first
+        //            row, larger sizes are split in 2^SECOND_LEVEL_BITS bins per power of two.
+        void mapping(u32 size, u32 &firstLevel, u32 &secondLevel)
+        {
+            if (size < (1u << SECOND_LEVEL_BITS))
+            {
+                firstLevel = 0;
+                secondLevel = size;
+            }
+            else
+            {
+                auto bit = highestBit(size);
+                firstLevel = bit - SECOND_LEVEL_BITS + 1;
+                secondLevel = (size >> (bit - SECOND_LEVEL_BITS)) ^ (1u << SECOND_LEVEL_BITS);
+            }
+        }
+
+        // Rounds the size up to the next bin boundary, so that any region found in
+        // the resulting bin is large enough.
+        u32 roundUpToBin(u32 size)
+        {
+            if (size < (1u << SECOND_LEVEL_BITS))
+                return size;
+            auto granularity = (1u << (highestBit(size) - SECOND_LEVEL_BITS)) - 1;
+            return (size > 0xFFFFFFFFu - granularity) ? size : (size + granularity) & ~granularity;
+        }
+    }
+
+    constexpr OffsetAllocator::u32 OffsetAllocator::NO_SPACE;
+
+    OffsetAllocator::OffsetAllocator(u32 capacity) : mCapacity(capacity)
+    {
+        panicif(capacity == 0 || capacity == NO_SPACE, "invalid allocator capacity %d", capacity);
+        reset();
+    }
+
+    void OffsetAllocator::reset()
+    {
+        mUsedSpace = 0;
+        mAllocationCount = 0;
+        mNodes.clear();
+        mUnusedNodes.clear();
+        mFirstLevelBitmap = 0;
+        mSecondLevelBitmaps.fill(0);
+        for (auto &lists : mFreeLists)
+            lists.fill(NO_SPACE);
+        insertFree(createNode(0, mCapacity, NO_SPACE, NO_SPACE));
+    }
+
+    OffsetAllocator::Allocation OffsetAllocator::allocate(u32 size)
+    {
+        size = std::max(size, 1u);
+        auto node = findFree(roundUpToBin(size));
+        
+        // NOTE(cme): regions in the bin of the size itself are skipped by the constant time
+        //            search, they are only looked at when nothing larger is left.
+        if (node == NO_SPACE)
+            node = findExactFit(size);
+        if (node == NO_SPACE) 
+            return Allocation{};
+
+        removeFree(node);
+        auto remainder = mNodes[node].size - size;
+        if (remainder > 0)
+        {
+            auto split = createNode(mNodes[node].offset + size, remainder, node, mNodes[node].nextPhysical);
+            if (mNodes[split].nextPhysical != NO_SPACE)
+                mNodes[mNodes[split].nextPhysical].previousPhysical = split;
+            mNodes[node].nextPhysical = split;
+            mNodes[node].size = size;
+            insertFree(split);
+        }
+
+        mNodes[node].used = true;
+        mUsedSpace += size;
+        mAllocationCount += 1;
+
+        Allocation allocation;
+        allocation.offset = mNodes[node].offset;
+        allocation.node = node;
+        return allocation;
+    }
+
+    void OffsetAllocator::free(const Allocation &allocation)
+    {
+        if (!allocation.isValid()) 
+            return;
+
+        auto node = allocation.node;
+        panicif(node >= mNodes.size() || !mNodes[node].used, "double free of offset %d", allocation.offset);
+        mNodes[node].used = false;
+        mUsedSpace -= mNodes[node].size;
+        mAllocationCount -= 1;
+
+        auto previous = mNodes[node].previousPhysical;
+        if (previous != NO_SPACE && !mNodes[previous].used)
+        {
+            removeFree(previous);
+            mNodes[previous].size += mNodes[node].size;
+            mNodes[previous].nextPhysical = mNodes[node].nextPhysical;
+            if (mNodes[node].nextPhysical != NO_SPACE)
+                mNodes[mNodes[node].nextPhysical].previousPhysical = previous;
+            releaseNode(node);
+            node = previous;
+        }
+
+        auto next = mNodes[node].nextPhysical;
+        if (next != NO_SPACE && !mNodes[next].used)
+        {
+            removeFree(next);
+            mNodes[node].size += mNodes[next].size;
+            mNodes[node].nextPhysical = mNodes[next].nextPhysical;
+            if (mNodes[next].nextPhysical != NO_SPACE)
+                mNodes[mNodes[next].nextPhysical].previousPhysical = node;
+            releaseNode(next);
+        }
+
+        insertFree(node);
+    }
+
+    OffsetAllocator::u32 OffsetAllocator::sizeOf(const Allocation &allocation) const
+    {
+        return allocation.isValid() ? mNodes[allocation.node].size : 0;
+    }
+
+    OffsetAllocator::Statistics OffsetAllocator::statistics() const
+    {
+        Statistics statistics;
+        statistics.capacity = mCapacity;
+        statistics.usedSpace = mUsedSpace;
+        statistics.freeSpace = mCapacity - mUsedSpace;
+        statistics.allocationCount = mAllocationCount;
+        for (u32 firstLevel = 0; firstLevel < FIRST_LEVEL_COUNT; ++firstLevel)
+        {
+            for (u32 secondLevel = 0; secondLevel < SECOND_LEVEL_COUNT; ++secondLevel)
+            {
+                for (auto node = mFreeLists[firstLevel][secondLevel]; node != NO_SPACE; node = mNodes[node].nextFree)
+                {
+                    statistics.freeRegionCount += 1;
+                    statistics.largestFreeRegion = std::max(statistics.largestFreeRegion, mNodes[node].size);
+                }
+            }
+        }
+        return statistics;
+    }
+
+    OffsetAllocator::u32 OffsetAllocator::createNode(u32 offset, u32 size, u32 previousPhysical, u32 nextPhysical)
+    {
+        u32 node;
+        if (mUnusedNodes.empty())
+        {
+            node = (u32)mNodes.size();
+            mNodes.emplace_back();
+        }
+        else
+        {
+            node = mUnusedNodes.back();
+            mUnusedNodes.pop_back();
+            mNodes[node] = Node();
+        }
+        mNodes[node].offset = offset;
+        mNodes[node].size = size;
+        mNodes[node].previousPhysical = previousPhysical;
+        mNodes[node].nextPhysical = nextPhysical;
+        return node;
+    }
+
+    void OffsetAllocator::releaseNode(u32 node)
+    {
+        mUnusedNodes.push_back(node);
+    }
+
+    void OffsetAllocator::insertFree(u32 node)
+    {
+        u32 firstLevel, secondLevel;
+        mapping(mNodes[node].size, firstLevel, secondLevel);
+
+        auto &head = mFreeLists[firstLevel][secondLevel];
+        mNodes[node].previousFree = NO_SPACE;
+        mNodes[node].nextFree = head;
+        if (head != NO_SPACE) 
+            mNodes[head].previousFree = node;
+        head = node;
+
+        mFirstLevelBitmap |= 1u << firstLevel;
+        mSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    }
+
+    void OffsetAllocator::removeFree(u32 node)
+    {
+        auto previous = mNodes[node].previousFree, next = mNodes[node].nextFree;
+        if (previous != NO_SPACE) 
+            mNodes[previous].nextFree = next;
+        if (next != NO_SPACE) 
+            mNodes[next].previousFree = previous;
+
+        u32 firstLevel, secondLevel;
+        mapping(mNodes[node].size, firstLevel, secondLevel);
+        auto &head = mFreeLists[firstLevel][secondLevel];
+        if (head == node)
+        {
+            head = next;
+            if (head == NO_SPACE)
+            {
+                mSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+                if (mSecondLevelBitmaps[firstLevel] == 0)
+                    mFirstLevelBitmap &= ~(1u << firstLevel);
+            }
+        }
+        mNodes[node].previousFree = mNodes[node].nextFree = NO_SPACE;
+    }
+
+    OffsetAllocator::u32 OffsetAllocator::findFree(u32 size) const
+    {
+        u32 firstLevel, secondLevel;
+        mapping(size, firstLevel, secondLevel);
+
+        auto secondLevelMap = mSecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0)
+        {
+            auto firstLevelMap = (firstLevel + 1 < FIRST_LEVEL_COUNT) ? mFirstLevelBitmap & (~0u << (firstLevel + 1)) : 0;
+            if (firstLevelMap == 0) 
+                return NO_SPACE;
+            firstLevel = lowestBit(firstLevelMap);
+            secondLevelMap = mSecondLevelBitmaps[firstLevel];
+        }
+        secondLevel = lowestBit(secondLevelMap);
+
+        // NOTE(cme): the size was rounded up to a bin boundary, but when it could not
+        //            be rounded (close to 4GB) the head of its own bin may still be too small.
+        auto node = mFreeLists[firstLevel][secondLevel];
+        return (mNodes[node].size >= size) ? node : NO_SPACE;
+    }
+
+    OffsetAllocator::u32 OffsetAllocator::findExactFit(u32 size) const
+    {
+        u32 firstLevel, secondLevel;
+        mapping(size, firstLevel, secondLevel);
+        for (auto node = mFreeLists[firstLevel][secondLevel]; node != NO_SPACE; node = mNodes[node].nextFree)
+            if (mNodes[node].size >= size) 
+                return node;
+        return NO_SPACE;
+    }
+
+}}
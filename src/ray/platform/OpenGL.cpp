@@ -0,0 +1,86 @@
+#include <ray/platform/OpenGL.hpp>
+#include <cstring>
+
+#ifdef RAY_LOADS_GL_VERSION_3_3
+PFNGLVERTEXATTRIBDIVISORPROC glad_glVertexAttribDivisor = nullptr;
+PFNGLQUERYCOUNTERPROC glad_glQueryCounter = nullptr;
+PFNGLGETQUERYOBJECTUI64VPROC glad_glGetQueryObjectui64v = nullptr;
+#endif
+
+#ifdef RAY_LOADS_GL_VERSION_4_1
+PFNGLGETPROGRAMBINARYPROC glad_glGetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC glad_glProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri = nullptr;
+#endif
+
+#ifdef RAY_LOADS_GL_VERSION_4_2
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glad_glDrawElementsInstancedBaseVertexBaseInstance = nullptr;
+#endif
+
+#ifdef RAY_LOADS_GL_VERSION_4_3
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect = nullptr;
+#endif
+
+#ifdef RAY_LOADS_GL_VERSION_4_4
+PFNGLBUFFERSTORAGEPROC glad_glBufferStorage = nullptr;
+#endif
+
+#ifdef RAY_LOADS_GL_KHR_parallel_shader_compile
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR = nullptr;
+#endif
+
+namespace ray { namespace platform {
+
+    void loadOpenGLEntryPoints(GLADloadproc load)
+    {
+        (void)load;
+#ifdef RAY_LOADS_GL_VERSION_3_3
+        glad_glVertexAttribDivisor = reinterpret_cast<PFNGLVERTEXATTRIBDIVISORPROC>(load("glVertexAttribDivisor"));
+        glad_glQueryCounter = reinterpret_cast<PFNGLQUERYCOUNTERPROC>(load("glQueryCounter"));
+        glad_glGetQueryObjectui64v = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VPROC>(load("glGetQueryObjectui64v"));
+#endif
+#ifdef RAY_LOADS_GL_VERSION_4_1
+        glad_glGetProgramBinary = reinterpret_cast<PFNGLGETPROGRAMBINARYPROC>(load("glGetProgramBinary"));
+        glad_glProgramBinary = reinterpret_cast<PFNGLPROGRAMBINARYPROC>(load("glProgramBinary"));
+        glad_glProgramParameteri = reinterpret_cast<PFNGLPROGRAMPARAMETERIPROC>(load("glProgramParameteri"));
+#endif
+#ifdef RAY_LOADS_GL_VERSION_4_2
+        glad_glDrawElementsInstancedBaseVertexBaseInstance = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC>(load("glDrawElementsInstancedBaseVertexBaseInstance"));
+#endif
+#ifdef RAY_LOADS_GL_VERSION_4_3
+        glad_glMultiDrawElementsIndirect = reinterpret_cast<PFNGLMULTIDRAWELEMENTSINDIRECTPROC>(load("glMultiDrawElementsIndirect"));
+#endif
+#ifdef RAY_LOADS_GL_VERSION_4_4
+        // NOTE(cme): GL_ARB_buffer_storage names it the same.
+        glad_glBufferStorage = reinterpret_cast<PFNGLBUFFERSTORAGEPROC>(load("glBufferStorage"));
+#endif
+#ifdef RAY_LOADS_GL_KHR_parallel_shader_compile
+        // NOTE(cme): the ARB flavour of the extension has the same tokens and signature.
+        glad_glMaxShaderCompilerThreadsKHR = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(load("glMaxShaderCompilerThreadsKHR"));
+        if (glad_glMaxShaderCompilerThreadsKHR == nullptr)
+            glad_glMaxShaderCompilerThreadsKHR = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(load("glMaxShaderCompilerThreadsARB"));
+#endif
+    }
+
+    bool hasOpenGLVersion(int major, int minor)
+    {
+        GLint actualMajor = 0, actualMinor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &actualMajor);
+        glGetIntegerv(GL_MINOR_VERSION, &actualMinor);
+        return (actualMajor > major) || (actualMajor == major && actualMinor >= minor);
+    }
+
+    bool hasOpenGLExtension(const char *name)
+    {
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint extension = 0; extension < extensionCount; ++extension)
+        {
+            auto extensionName = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, (GLuint)extension));
+            if (extensionName && std::strcmp(extensionName, name) == 0) 
+                return true;
+        }
+        return false;
+    }
+
+}}
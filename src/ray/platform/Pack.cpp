@@ -0,0 +1,341 @@
+#include <ray/platform/Pack.hpp>
+#include <ray/platform/Hash.hpp>
+#include <ray/platform/Lz4.hpp>
+#include <ray/platform/Print.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace ray { namespace platform { namespace fs {
+
+    namespace
+    {
+        const char MAGIC[8] = { 'R', 'A', 'Y', 'P', 'A', 'C', 'K', 0 };
+
+        uint64_t alignUp(uint64_t value, uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+        uint64_t indexSizeFor(size_t entryCount)
+        {
+            uint64_t result = 16;
+            while (result < 2 * entryCount)
+                result *= 2;
+            return result;
+        }
+
+        struct Mount
+        {
+            std::string prefix;
+            // NOTE(cme): shared so that a load can read from it after releasing the mounts.
+            std::shared_ptr<PackFile> pack;
+        };
+
+        std::mutex gMountsMutex;
+        std::vector<Mount> gMounts;
+
+        bool startsWith(const std::string &text, const std::string &prefix) { return text.compare(0, prefix.size(), prefix) == 0; }
+    }
+
+    namespace pack
+    {
+        std::string normalize(const std::string &path)
+        {
+            auto result = path;
+            std::replace(result.begin(), result.end(), '\\', '/');
+            while (startsWith(result, "./"))
+                result.erase(0, 2);
+            return result;
+        }
+
+        uint64_t hashPath(const std::string &normalizedPath) { return fnv1a64(normalizedPath.data(), normalizedPath.size()); }
+        uint64_t hashContent(const uint8_t *data, size_t size) { return fnv1a64(reinterpret_cast<const char *>(data), size); }
+    }
+
+    void PackWriter::add(const std::string &path, const uint8_t *data, size_t size, Compression compression)
+    {
+        Pending entry;
+        entry.path = pack::normalize(path);
+        entry.size = size;
+        entry.contentHash = pack::hashContent(data, size);
+        entry.compression = Compression::None;
+
+        if (compression == Compression::Lz4)
+        {
+            entry.stored = lz4::compress(data, size);
+            if (!entry.stored.empty() && entry.stored.size() <= size - size / 8)
+                entry.compression = Compression::Lz4;
+        }
+        if (entry.compression == Compression::None)
+            entry.stored.assign(data, data + size);
+
+        auto existing = std::find_if(mEntries.begin(), mEntries.end(), [&](const Pending &other) { return other.path == entry.path; });
+        if (existing != mEntries.end())
+            *existing = std::move(entry);
+        else
+            mEntries.push_back(std::move(entry));
+    }
+
+    bool PackWriter::addFile(const std::string &path, const std::string &filename, Compression compression)
+    {
+        auto data = readFile(filename);
+        if (!data.isValid())
+            return false;
+        add(path, data.data(), data.size(), compression);
+        return true;
+    }
+
+    uint64_t PackWriter::size() const
+    {
+        uint64_t result = 0;
+        for (auto &entry : mEntries)
+            result += entry.size;
+        return result;
+    }
+
+    uint64_t PackWriter::storedSize() const
+    {
+        uint64_t result = 0;
+        for (auto &entry : mEntries)
+            result += entry.stored.size();
+        return result;
+    }
+
+    bool PackWriter::write(const std::string &filename, std::string *error) const
+    {
+        std::vector<pack::Entry> toc(mEntries.size());
+        std::string names;
+        uint64_t offset = sizeof(pack::Header);
+        for (size_t i = 0; i < mEntries.size(); ++i)
+        {
+            auto &pending = mEntries[i];
+            auto &entry = toc[i];
+            std::memset(&entry, 0, sizeof(entry));
+            offset = alignUp(offset, pack::DATA_ALIGNMENT);
+            entry.pathHash = pack::hashPath(pending.path);
+            entry.contentHash = pending.contentHash;
+            entry.offset = offset;
+            entry.storedSize = pending.stored.size();
+            entry.size = pending.size;
+            entry.nameOffset = (uint32_t)names.size();
+            entry.nameSize = (uint32_t)pending.path.size();
+            entry.compression = pending.compression;
+            names += pending.path;
+            offset += entry.storedSize;
+        }
+
+        std::vector<uint32_t> index(indexSizeFor(toc.size()), 0);
+        for (size_t i = 0; i < toc.size(); ++i)
+        {
+            auto slot = toc[i].pathHash & (index.size() - 1);
+            while (index[slot] != 0)
+                slot = (slot + 1) & (index.size() - 1);
+            index[slot] = (uint32_t)(i + 1);
+        }
+
+        pack::Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = pack::VERSION;
+        header.entryCount = (uint32_t)toc.size();
+        header.tocOffset = alignUp(offset, 64);
+        header.indexOffset = header.tocOffset + toc.size() * sizeof(pack::Entry);
+        header.indexSize = index.size();
+        header.namesOffset = header.indexOffset + index.size() * sizeof(uint32_t);
+        header.namesSize = names.size();
+
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        auto pad = [&](uint64_t position) {
+            static const char ZEROS[64] = {};
+            auto current = (uint64_t)out.tellp();
+            if (position > current)
+                out.write(ZEROS, (std::streamsize)(position - current));
+        };
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (size_t i = 0; i < mEntries.size(); ++i)
+        {
+            pad(toc[i].offset);
+            out.write(reinterpret_cast<const char *>(mEntries[i].stored.data()), (std::streamsize)mEntries[i].stored.size());
+        }
+        pad(header.tocOffset);
+        out.write(reinterpret_cast<const char *>(toc.data()), (std::streamsize)(toc.size() * sizeof(pack::Entry)));
+        out.write(reinterpret_cast<const char *>(index.data()), (std::streamsize)(index.size() * sizeof(uint32_t)));
+        out.write(names.data(), (std::streamsize)names.size());
+        out.flush();
+
+        if (!out)
+        {
+            if (error) *error = fmt("could not write '%s'", filename);
+            return false;
+        }
+        return true;
+    }
+
+    bool PackFile::open(const std::string &filename, std::string *error)
+    {
+        auto fail = [&](const char *reason) {
+            if (error) *error = fmt("'%s' %s", filename, reason);
+            mFile.close();
+            mHeader = nullptr;
+            return false;
+        };
+
+        if (!mFile.open(filename, Access::Random, error))
+            return false;
+        mFilename = filename;
+
+        auto size = mFile.size();
+        if (size < sizeof(pack::Header))
+            return fail("is too small to be a pack");
+        mHeader = reinterpret_cast<const pack::Header *>(mFile.data());
+        if (std::memcmp(mHeader->magic, MAGIC, sizeof(MAGIC)) != 0)
+            return fail("is not a pack");
+        if (mHeader->version != pack::VERSION)
+            return fail("has an unsupported version");
+
+        if (mHeader->tocOffset > size || mHeader->indexOffset > size || mHeader->indexSize > size / sizeof(uint32_t))
+            return fail("has its table of contents out of bounds");
+        auto tocEnd = mHeader->tocOffset + (uint64_t)mHeader->entryCount * sizeof(pack::Entry);
+        auto indexEnd = mHeader->indexOffset + mHeader->indexSize * sizeof(uint32_t);
+        if (mHeader->tocOffset % 8 != 0 || tocEnd > size || mHeader->indexOffset < tocEnd || indexEnd > size)
+            return fail("has its table of contents out of bounds");
+        if (mHeader->indexOffset % sizeof(uint32_t) != 0)
+            return fail("has a misaligned index");
+        if (mHeader->indexSize == 0 || (mHeader->indexSize & (mHeader->indexSize - 1)) != 0 || mHeader->indexSize < mHeader->entryCount)
+            return fail("has an invalid index");
+        if (mHeader->namesOffset < indexEnd || mHeader->namesOffset + mHeader->namesSize > size)
+            return fail("has its names out of bounds");
+
+        mEntries = reinterpret_cast<const pack::Entry *>(mFile.data() + mHeader->tocOffset);
+        mIndex = reinterpret_cast<const uint32_t *>(mFile.data() + mHeader->indexOffset);
+        mNames = reinterpret_cast<const char *>(mFile.data() + mHeader->namesOffset);
+        for (size_t i = 0; i < mHeader->entryCount; ++i)
+        {
+            auto &entry = mEntries[i];
+            if (entry.offset > size || entry.storedSize > size - entry.offset)
+                return fail("has an entry out of bounds");
+            if ((uint64_t)entry.nameOffset + entry.nameSize > mHeader->namesSize)
+                return fail("has an entry name out of bounds");
+            // NOTE(cme): the size is allocated before decompressing, it has to be plausible.
+            if ((entry.compression == Compression::None && entry.size != entry.storedSize) ||
+                (entry.compression == Compression::Lz4 && entry.size > lz4::decompressBound(entry.storedSize)))
+                return fail("has an entry of an implausible size");
+        }
+        for (size_t slot = 0; slot < mHeader->indexSize; ++slot)
+            if (mIndex[slot] > mHeader->entryCount)
+                return fail("has an invalid index");
+        return true;
+    }
+
+    const pack::Entry *PackFile::find(const std::string &path) const
+    {
+        if (mHeader == nullptr)
+            return nullptr;
+
+        auto normalized = pack::normalize(path);
+        auto hash = pack::hashPath(normalized);
+        auto mask = mHeader->indexSize - 1;
+        for (auto slot = hash & mask, probes = (uint64_t)0; probes < mHeader->indexSize; slot = (slot + 1) & mask, ++probes)
+        {
+            auto index = mIndex[slot];
+            if (index == 0)
+                return nullptr;
+            auto &entry = mEntries[index - 1];
+            if (entry.pathHash == hash && entry.nameSize == normalized.size() && std::memcmp(mNames + entry.nameOffset, normalized.data(), normalized.size()) == 0)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    FileData PackFile::read(const pack::Entry &entry) const
+    {
+        auto stored = mFile.data() + entry.offset;
+        switch (entry.compression)
+        {
+            case Compression::None:
+                return FileData::borrow(stored, (size_t)entry.storedSize);
+
+            case Compression::Lz4:
+            {
+                std::vector<uint8_t> bytes((size_t)entry.size);
+                if (!lz4::decompress(stored, (size_t)entry.storedSize, bytes.data(), bytes.size()))
+                    return FileData::failed(fmt("'%s' in '%s' is corrupted", name(entry), mFilename));
+                return FileData(std::move(bytes));
+            }
+        }
+        return FileData::failed(fmt("'%s' in '%s' has an unknown compression", name(entry), mFilename));
+    }
+
+    bool PackFile::verify(const pack::Entry &entry) const
+    {
+        auto data = read(entry);
+        return data.isValid() && pack::hashContent(data.data(), data.size()) == entry.contentHash;
+    }
+
+    bool mount(const std::string &packFilename, const std::string &prefix, std::string *error)
+    {
+        std::unique_ptr<PackFile> file(new PackFile());
+        if (!file->open(packFilename, error))
+            return false;
+
+        std::lock_guard<std::mutex> lock(gMountsMutex);
+        gMounts.push_back(Mount{ pack::normalize(prefix), std::move(file) });
+        return true;
+    }
+
+    void unmount(const std::string &packFilename)
+    {
+        std::lock_guard<std::mutex> lock(gMountsMutex);
+        gMounts.erase(std::remove_if(gMounts.begin(), gMounts.end(), [&](const Mount &mount) { return mount.pack->filename() == packFilename; }), gMounts.end());
+    }
+
+    void unmountAll()
+    {
+        std::lock_guard<std::mutex> lock(gMountsMutex);
+        gMounts.clear();
+    }
+
+    namespace
+    {
+        // NOTE(cme): expects the mounts to be locked.
+        std::shared_ptr<PackFile> findMounted(const std::string &path, const pack::Entry *&entry)
+        {
+            auto normalized = pack::normalize(path);
+            for (auto mount = gMounts.rbegin(); mount != gMounts.rend(); ++mount)
+            {
+                if (!startsWith(normalized, mount->prefix))
+                    continue;
+                entry = mount->pack->find(normalized.substr(mount->prefix.size()));
+                if (entry)
+                    return mount->pack;
+            }
+            return nullptr;
+        }
+    }
+
+    bool isPacked(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(gMountsMutex);
+        const pack::Entry *entry = nullptr;
+        return findMounted(path, entry) != nullptr;
+    }
+
+    FileData load(const std::string &path, Access access)
+    {
+        std::shared_ptr<PackFile> pack;
+        pack::Entry entry = {};
+        {
+            std::lock_guard<std::mutex> lock(gMountsMutex);
+            const pack::Entry *found = nullptr;
+            pack = findMounted(path, found);
+            if (pack)
+                entry = *found;
+        }
+        // NOTE(cme): decompresses without holding the mounts, other loads go on meanwhile.
+        if (pack)
+            return pack->read(entry);
+        return mapFile(path, access);
+    }
+
+}}}
@@ -0,0 +1,145 @@
+#include <ray/platform/Profiler.hpp>
+#include <ray/platform/Panic.hpp>
+#include <algorithm>
+#include <fstream>
+
+namespace ray { namespace platform {
+
+    namespace
+    {
+        void writeJsonString(std::ostream &out, const char *text)
+        {
+            static const char HEX[] = "0123456789abcdef";
+            out << '"';
+            for (auto c = text; *c; ++c)
+            {
+                auto byte = (unsigned char)*c;
+                if (byte == '"' || byte == '\\')
+                    out << '\\' << *c;
+                else if (byte < 0x20)
+                    out << "\\u00" << HEX[byte >> 4] << HEX[byte & 0xf];
+                else
+                    out << *c;
+            }
+            out << '"';
+        }
+    }
+
+    Profiler &Profiler::instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler::ThreadBuffer &Profiler::registerThread()
+    {
+        std::lock_guard<std::mutex> lock(mThreadsMutex);
+        mThreads.emplace_back(new ThreadBuffer(mNextTrack++));
+        return *mThreads.back();
+    }
+
+    uint32_t Profiler::addTrack(const char *name)
+    {
+        std::lock_guard<std::mutex> lock(mThreadsMutex);
+        mTracks.emplace_back(mNextTrack++, name);
+        return mTracks.back().first;
+    }
+
+    void Profiler::endFrame()
+    {
+        std::unordered_map<const char *, size_t> indices;
+        mLastFrame.clear();
+        {
+            std::lock_guard<std::mutex> lock(mThreadsMutex);
+            for (auto &buffer : mThreads)
+                drain(*buffer, indices);
+        }
+        while (mTrace.size() > mTraceCapacity)
+            mTrace.pop_front();
+        mFrameCount += 1;
+    }
+
+    void Profiler::drain(ThreadBuffer &buffer, std::unordered_map<const char *, size_t> &indices)
+    {
+        auto tail = buffer.mTail.load(std::memory_order_relaxed);
+        auto head = buffer.mHead.load(std::memory_order_acquire);
+
+        // NOTE(cme): zones end before their parent, so by the time a zone is drained
+        //            the time spent in its children has been summed one level below.
+        auto &childTime = buffer.mChildTime;
+        for (; tail != head; ++tail)
+        {
+            auto &event = buffer.mEvents[tail % ThreadBuffer::CAPACITY];
+            auto duration = event.end - event.begin;
+            if (childTime.size() < event.depth + 2)
+                childTime.resize(event.depth + 2, 0);
+            auto exclusive = duration > childTime[event.depth + 1] ? duration - childTime[event.depth + 1] : 0;
+            childTime[event.depth + 1] = 0;
+            childTime[event.depth] += duration;
+
+            auto index = indices.find(event.name);
+            if (index == indices.end())
+            {
+                index = indices.emplace(event.name, mLastFrame.size()).first;
+                mLastFrame.push_back(ZoneStatistics{ event.name, 0, 0, 0, 0 });
+            }
+            auto &statistics = mLastFrame[index->second];
+            statistics.calls += 1;
+            statistics.inclusive += duration;
+            statistics.exclusive += exclusive;
+            statistics.maximum = std::max(statistics.maximum, duration);
+
+            if (mTraceCapacity > 0)
+                mTrace.push_back(TraceEvent{ event, buffer.mThreadIndex });
+        }
+        buffer.mTail.store(tail, std::memory_order_release);
+    }
+
+    uint64_t Profiler::droppedEvents() const
+    {
+        std::lock_guard<std::mutex> lock(mThreadsMutex);
+        uint64_t result = 0;
+        for (auto &buffer : mThreads)
+            result += buffer->mDropped.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void Profiler::writeChromeTrace(std::ostream &out) const
+    {
+        // NOTE(cme): complete events ("ph":"X") in microseconds, see the Trace Event Format.
+        auto origin = UINT64_MAX;
+        for (auto &trace : mTrace)
+            origin = std::min(origin, trace.event.begin);
+
+        out << "{\"traceEvents\":[";
+        auto separator = "\n";
+        {
+            std::lock_guard<std::mutex> lock(mThreadsMutex);
+            for (auto &track : mTracks)
+            {
+                out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << track.first << ",\"args\":{\"name\":";
+                writeJsonString(out, track.second);
+                out << "}}";
+                separator = ",\n";
+            }
+        }
+        for (auto &trace : mTrace)
+        {
+            out << separator << "{\"name\":";
+            writeJsonString(out, trace.event.name);
+            out << ",\"ph\":\"X\",\"ts\":" << (trace.event.begin - origin) / 1000.0
+                << ",\"dur\":" << (trace.event.end - trace.event.begin) / 1000.0
+                << ",\"pid\":0,\"tid\":" << trace.thread << "}";
+            separator = ",\n";
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    void Profiler::writeChromeTrace(const std::string &filename) const
+    {
+        std::ofstream out(filename);
+        panicif(!out, "cannot write the trace to '%s'", filename);
+        writeChromeTrace(out);
+    }
+
+}}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <ray/assets/BitmapKernels.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <cstdlib>
+#include <cstring>
+
+using namespace ray;
+using namespace assets;
+
+namespace
+{
+    Bitmap pattern(int width, int height, int depth)
+    {
+        auto pixels = (uint8_t *)malloc(width * height * depth);
+        for (int i = 0; i < width * height * depth; ++i)
+            pixels[i] = (uint8_t)(i * 37 + i / 7);
+        return Bitmap(width, height, depth, pixels);
+    }
+
+    Bitmap fromBytes(int width, int height, int depth, std::initializer_list<int> bytes)
+    {
+        auto pixels = (uint8_t *)malloc(width * height * depth);
+        auto pixel = pixels;
+        for (auto byte : bytes)
+            *pixel++ = (uint8_t)byte;
+        return Bitmap(width, height, depth, pixels);
+    }
+}
+
+TEST(BitmapKernels, convertExpandsLikeTheSwizzles)
+{
+    auto rgba = kernels::convert(fromBytes(2, 1, 2, { 10, 20, 30, 40 }), 4);
+    ASSERT_EQ(4, rgba.depth());
+    uint8_t expected[] = { 10, 10, 10, 20, 30, 30, 30, 40 };
+    EXPECT_EQ(0, std::memcmp(expected, rgba.pixels(), sizeof(expected)));
+
+    auto opaque = kernels::convert(fromBytes(1, 1, 3, { 1, 2, 3 }), 4);
+    EXPECT_EQ(255, opaque.pixels()[3]);
+
+    auto mask = kernels::convert(fromBytes(1, 1, 1, { 77 }), 4);
+    EXPECT_EQ(255, mask.pixels()[0]);
+    EXPECT_EQ(77, mask.pixels()[3]);
+}
+
+TEST(BitmapKernels, convertRoundTripsThroughMoreChannels)
+{
+    for (int depth = 1; depth <= 4; ++depth)
+    {
+        auto bitmap = pattern(13, 5, depth);
+        auto back = kernels::convert(kernels::convert(bitmap, 4), depth);
+        EXPECT_EQ(0, std::memcmp(bitmap.pixels(), back.pixels(), bitmap.size())) << "with " << depth << " channels";
+    }
+}
+
+TEST(BitmapKernels, premultiplyScalesByAlpha)
+{
+    for (int depth : { 2, 4 })
+    {
+        // NOTE(cme): wide enough for the vectorized loop and its tail.
+        auto bitmap = pattern(37, 3, depth);
+        auto original = pattern(37, 3, depth);
+        kernels::premultiply(bitmap);
+        for (int i = 0; i < bitmap.size(); i += depth)
+        {
+            auto alpha = original.pixels()[i + depth - 1];
+            EXPECT_EQ(alpha, bitmap.pixels()[i + depth - 1]);
+            for (int channel = 0; channel < depth - 1; ++channel)
+                EXPECT_EQ((original.pixels()[i + channel] * alpha + 127) / 255, bitmap.pixels()[i + channel]);
+        }
+    }
+}
+
+TEST(BitmapKernels, flipVerticallySwapsRows)
+{
+    auto bitmap = fromBytes(2, 3, 1, { 1, 2, 3, 4, 5, 6 });
+    kernels::flipVertically(bitmap);
+    uint8_t expected[] = { 5, 6, 3, 4, 1, 2 };
+    EXPECT_EQ(0, std::memcmp(expected, bitmap.pixels(), sizeof(expected)));
+}
+
+TEST(BitmapKernels, blitCopiesRowsInPlace)
+{
+    for (auto width : { 3, 16, 21 })
+    {
+        auto source = pattern(width, 5, 2);
+        auto target = Bitmap(40, 10, 2, Bitmap::Stride::Aligned);
+        target.fill(Color(0xEE, 0xEE, 0xEE, 0xEE));
+        kernels::blit(source, target, 7, 4);
+        for (auto y = 0; y < target.height(); ++y)
+        {
+            for (auto x = 0; x < target.width(); ++x)
+            {
+                auto inside = x >= 7 && x < 7 + width && y >= 4 && y < 9;
+                auto expected = inside ? source.row(y - 4) + (x - 7) * 2 : nullptr;
+                EXPECT_EQ(inside ? expected[0] : 0xEE, target.row(y)[x * 2]);
+                EXPECT_EQ(inside ? expected[1] : 0xEE, target.row(y)[x * 2 + 1]);
+            }
+        }
+    }
+}
+
+TEST(BitmapKernels, srgbRoundTrips)
+{
+    EXPECT_EQ(0.0f, kernels::toLinear(0));
+    EXPECT_EQ(1.0f, kernels::toLinear(255));
+    EXPECT_NEAR(0.2159f, kernels::toLinear(128), 1e-4f);
+    for (int value = 0; value < 256; ++value)
+        EXPECT_EQ(value, kernels::toSrgb(kernels::toLinear((uint8_t)value)));
+}
+
+TEST(BitmapKernels, halveAveragesBlocks)
+{
+    auto half = kernels::halve(fromBytes(4, 2, 2, { 0, 10, 2, 30, 100, 0, 100, 0, 4, 50, 6, 70, 100, 255, 100, 255 }));
+    ASSERT_EQ(2, half.width());
+    ASSERT_EQ(1, half.height());
+    uint8_t expected[] = { 3, 40, 100, 128 };
+    EXPECT_EQ(0, std::memcmp(expected, half.pixels(), sizeof(expected)));
+}
+
+TEST(BitmapKernels, kernelsReadRegionsInPlace)
+{
+    auto bitmap = pattern(37, 21, 4);
+    auto region = BitmapView(bitmap).region(5, 3, 20, 12);
+    auto copy = Bitmap(20, 12, 4);
+    for (auto y = 0; y < 12; ++y)
+        std::memcpy(copy.row(y), region.row(y), 20 * 4);
+
+    auto fromRegion = kernels::halve(region), fromCopy = kernels::halve(copy);
+    ASSERT_EQ(fromCopy.size(), fromRegion.size());
+    EXPECT_EQ(0, std::memcmp(fromCopy.pixels(), fromRegion.pixels(), fromCopy.size()));
+
+    auto converted = kernels::convert(region, 2);
+    auto expected = kernels::convert(copy, 2);
+    EXPECT_EQ(0, std::memcmp(expected.pixels(), converted.pixels(), expected.size()));
+}
+
+TEST(BitmapKernels, resampleKeepsFlatColors)
+{
+    for (auto filter : { kernels::Filter::Box, kernels::Filter::Lanczos3 })
+    {
+        kernels::ResampleOptions options;
+        options.filter = filter;
+        options.srgb = true;
+        auto small = kernels::resample(Bitmap(31, 17, 4, Color(200, 100, 50, 128)), 7, 40, options);
+        ASSERT_EQ(7, small.width());
+        ASSERT_EQ(40, small.height());
+        for (int i = 0; i < small.size(); i += 4)
+        {
+            EXPECT_EQ(200, small.pixels()[i]);
+            EXPECT_EQ(100, small.pixels()[i + 1]);
+            EXPECT_EQ(50, small.pixels()[i + 2]);
+            EXPECT_EQ(128, small.pixels()[i + 3]);
+        }
+    }
+}
+
+TEST(BitmapKernels, boxResampleByTwoMatchesHalve)
+{
+    auto bitmap = pattern(16, 8, 3);
+    kernels::ResampleOptions options;
+    options.filter = kernels::Filter::Box;
+    auto resampled = kernels::resample(bitmap, 8, 4, options);
+    auto halved = kernels::halve(bitmap);
+    for (int i = 0; i < halved.size(); ++i)
+        EXPECT_NEAR(halved.pixels()[i], resampled.pixels()[i], 1) << "at " << i;
+}
+
+TEST(BitmapKernels, srgbResamplingAveragesLight)
+{
+    // NOTE(cme): black and white stripes average to middle gray in linear space, 188 in sRGB.
+    auto stripes = fromBytes(2, 1, 3, { 0, 0, 0, 255, 255, 255 });
+    kernels::ResampleOptions options;
+    options.filter = kernels::Filter::Box;
+    options.srgb = true;
+    EXPECT_NEAR(188, kernels::resample(stripes, 1, 1, options).pixels()[0], 1);
+    options.srgb = false;
+    EXPECT_NEAR(128, kernels::resample(stripes, 1, 1, options).pixels()[0], 1);
+}
+
+TEST(BitmapKernels, parallelKernelsMatchSerial)
+{
+    platform::JobSystem jobs(3);
+    auto bitmap = pattern(300, 700, 4);
+
+    auto serial = kernels::resample(bitmap, 123, 257);
+    kernels::ResampleOptions options;
+    options.jobs = &jobs;
+    auto parallel = kernels::resample(bitmap, 123, 257, options);
+    EXPECT_EQ(0, std::memcmp(serial.pixels(), parallel.pixels(), serial.size()));
+
+    auto halved = kernels::halve(bitmap, &jobs);
+    EXPECT_EQ(0, std::memcmp(kernels::halve(bitmap).pixels(), halved.pixels(), halved.size()));
+}
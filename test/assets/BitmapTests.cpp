@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
-#include <ray/assets/Bitmap.hpp>
+#include <ray/assets/BitmapView.hpp>
+#include <ray/assets/PixelPool.hpp>
+#include <cstring>
 
 using namespace ray;
 using namespace assets;
@@ -134,4 +136,83 @@ TEST(Bitmap, canBeConstructedUsingSizeAndColor__depth4)
         EXPECT_EQ(ptr[2], color.b);
         EXPECT_EQ(ptr[3], color.a);
     }
-}
\ No newline at end of file
+}
+TEST(Bitmap, alignedRowsStartOnCacheLines)
+{
+    auto bitmap = Bitmap(13,5,4, Bitmap::Stride::Aligned);
+    EXPECT_EQ(bitmap.stride(), 64);
+    EXPECT_EQ(bitmap.size(), 64*5);
+    EXPECT_FALSE(bitmap.isTight());
+    for (auto y = 0; y < bitmap.height(); ++y)
+        EXPECT_EQ((uintptr_t)bitmap.row(y) % 64, 0u);
+
+    EXPECT_EQ(Bitmap::alignedStride(13, 3), 64*3);
+    EXPECT_EQ(Bitmap::alignedStride(16, 4), 64);
+    EXPECT_EQ(Bitmap::alignedStride(17, 4), 128);
+}
+
+TEST(Bitmap, fillLeavesThePaddingAlone)
+{
+    auto bitmap = Bitmap(3,4,2, Bitmap::Stride::Aligned);
+    memset(bitmap.pixels(), 0xEE, bitmap.size());
+    bitmap.fill(Color(0x12, 0x34, 0x56, 0x78));
+    for (auto y = 0; y < bitmap.height(); ++y)
+    {
+        auto row = bitmap.row(y);
+        for (auto x = 0; x < bitmap.width(); ++x)
+        {
+            EXPECT_EQ(row[x*2+0], 0x12);
+            EXPECT_EQ(row[x*2+1], 0x34);
+        }
+        EXPECT_EQ(row[bitmap.width()*2], 0xEE);
+    }
+}
+
+TEST(Bitmap, resizeKeepsTheStrideKind)
+{
+    auto bitmap = Bitmap(8,8,1, Bitmap::Stride::Aligned);
+    bitmap.resize(100,2,3);
+    EXPECT_EQ(bitmap.stride(), Bitmap::alignedStride(100, 3));
+    EXPECT_EQ(bitmap.row(1)[299], 0);
+}
+
+TEST(Bitmap, givesPooledPixelsBack)
+{
+    PixelPool pool;
+    {
+        auto bitmap = Bitmap(32,32,4, Bitmap::Stride::Tight, &pool);
+        EXPECT_EQ(pool.missCount(), 1u);
+        auto moved = std::move(bitmap);
+        EXPECT_EQ(bitmap.pixels(), nullptr);
+    }
+    EXPECT_EQ(pool.cachedBytes(), 4096u);
+
+    auto bitmap = Bitmap(30,30,4, Bitmap::Stride::Tight, &pool);
+    EXPECT_EQ(pool.hitCount(), 1u);
+    EXPECT_EQ(pool.cachedBytes(), 0u);
+}
+
+TEST(BitmapView, viewsABitmap)
+{
+    auto bitmap = Bitmap(5,3,4, Bitmap::Stride::Aligned);
+    auto view = BitmapView(bitmap);
+    EXPECT_EQ(view.width(), 5);
+    EXPECT_EQ(view.height(), 3);
+    EXPECT_EQ(view.depth(), 4);
+    EXPECT_EQ(view.stride(), 64);
+    EXPECT_EQ(view.pixels(), bitmap.pixels());
+    EXPECT_EQ(view.row(2), bitmap.row(2));
+    EXPECT_TRUE(BitmapView().isEmpty());
+    EXPECT_TRUE(BitmapView(bitmap.pixels(), 5, 3, 4).isTight());
+}
+
+TEST(BitmapView, regionsKeepTheStride)
+{
+    auto bitmap = Bitmap(10,10,2);
+    auto region = BitmapView(bitmap).region(3,4,5,2);
+    EXPECT_EQ(region.width(), 5);
+    EXPECT_EQ(region.height(), 2);
+    EXPECT_EQ(region.stride(), 20);
+    EXPECT_FALSE(region.isTight());
+    EXPECT_EQ(region.row(1), bitmap.row(5) + 3*2);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <ray/assets/BlockCompression.hpp>
+#include <ray/assets/Cooked.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace ray;
+using namespace assets;
+
+namespace
+{
+    // Smooth gradients with a little noise, like most photos are.
+    Bitmap photo(int width, int height, int depth)
+    {
+        auto pixels = (uint8_t *)malloc(width * height * depth);
+        uint32_t noise = 1;
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                for (int channel = 0; channel < depth; ++channel)
+                {
+                    noise = noise * 1664525u + 1013904223u;
+                    auto value = 128 + 100 * std::sin(0.05 * x * (channel + 1) + 0.03 * y) + (int)(noise >> 29) - 4;
+                    pixels[(y * width + x) * depth + channel] = (uint8_t)std::min(255.0, std::max(0.0, value));
+                }
+            }
+        }
+        return Bitmap(width, height, depth, pixels);
+    }
+}
+
+TEST(BlockCompression, sizesRoundUpToBlocks)
+{
+    EXPECT_EQ(8u, bc::compressedSize(TextureFormat::BC1, 4, 4));
+    EXPECT_EQ(8u, bc::compressedSize(TextureFormat::BC4, 1, 1));
+    EXPECT_EQ(2u * 2u * 16u, bc::compressedSize(TextureFormat::BC3, 5, 8));
+    EXPECT_EQ(3u * 1u * 16u, bc::compressedSize(TextureFormat::BC5, 12, 2));
+}
+
+TEST(BlockCompression, formatFollowsTheChannels)
+{
+    EXPECT_EQ(TextureFormat::BC4, bc::formatFor(Bitmap(4, 4, 1, Color{ 0, 0, 0, 0 })));
+    EXPECT_EQ(TextureFormat::BC5, bc::formatFor(Bitmap(4, 4, 2, Color{ 0, 0, 0, 0 })));
+    EXPECT_EQ(TextureFormat::BC1, bc::formatFor(Bitmap(4, 4, 3, Color{ 0, 0, 0, 0 })));
+    EXPECT_EQ(TextureFormat::BC1, bc::formatFor(Bitmap(4, 4, 4, Color{ 10, 20, 30, 255 })));
+    EXPECT_EQ(TextureFormat::BC3, bc::formatFor(Bitmap(4, 4, 4, Color{ 10, 20, 30, 128 })));
+}
+
+TEST(BlockCompression, solidBlocksAreExact565)
+{
+    uint8_t rgba[64], block[8], decoded[64];
+    for (int pixel = 0; pixel < 16; ++pixel)
+        std::memcpy(rgba + 4 * pixel, "\xFF\x00\x84\xFF", 4);
+    bc::encodeBC1(rgba, block);
+    bc::decodeBC1(block, decoded);
+
+    for (int pixel = 0; pixel < 16; ++pixel)
+    {
+        EXPECT_EQ(255, decoded[4*pixel]);
+        EXPECT_EQ(0, decoded[4*pixel + 1]);
+        EXPECT_NEAR(0x84, decoded[4*pixel + 2], 4);
+        EXPECT_EQ(255, decoded[4*pixel + 3]);
+    }
+}
+
+TEST(BlockCompression, twoColorsBlocksAreLossless)
+{
+    uint8_t rgba[64], block[8], decoded[64];
+    for (int pixel = 0; pixel < 16; ++pixel)
+        std::memcpy(rgba + 4 * pixel, pixel % 3 ? "\x00\x00\x00\xFF" : "\xFF\xFF\xFF\xFF", 4);
+    bc::encodeBC1(rgba, block);
+    bc::decodeBC1(block, decoded);
+    EXPECT_EQ(0, std::memcmp(rgba, decoded, sizeof(rgba)));
+}
+
+TEST(BlockCompression, bc4GradientsStayWithinAStep)
+{
+    uint8_t values[16], block[8], decoded[16];
+    for (int i = 0; i < 16; ++i)
+        values[i] = (uint8_t)(40 + 11 * i);
+    bc::encodeBC4(values, block);
+    bc::decodeBC4(block, decoded);
+
+    EXPECT_EQ(40, decoded[0]);
+    EXPECT_EQ(40 + 11 * 15, decoded[15]);
+    for (int i = 0; i < 16; ++i)
+        EXPECT_LE(std::abs(values[i] - decoded[i]), (11 * 15) / 14 + 1) << "at " << i;
+}
+
+TEST(BlockCompression, imagesKeepTheirQuality)
+{
+    auto rgb = photo(67, 45, 3), rgba = photo(67, 45, 4), r = photo(67, 45, 1), rg = photo(67, 45, 2);
+    auto roundTrip = [](const Bitmap &bitmap, TextureFormat format) {
+        auto blocks = bc::encode(bitmap, format);
+        EXPECT_EQ(bc::compressedSize(format, bitmap.width(), bitmap.height()), blocks.size());
+        return bc::psnr(bitmap, bc::decode(blocks.data(), format, bitmap.width(), bitmap.height()));
+    };
+
+    EXPECT_GT(roundTrip(rgb, TextureFormat::BC1), 32.0);
+    EXPECT_GT(roundTrip(rgba, TextureFormat::BC3), 32.0);
+    EXPECT_GT(roundTrip(r, TextureFormat::BC4), 40.0);
+    EXPECT_GT(roundTrip(rg, TextureFormat::BC5), 40.0);
+    EXPECT_TRUE(std::isinf(bc::psnr(rgb, rgb)));
+}
+
+TEST(BlockCompression, parallelEncodingMatchesSerial)
+{
+    auto bitmap = photo(256, 128, 4);
+    platform::JobSystem jobs(3);
+    EXPECT_EQ(bc::encode(bitmap, TextureFormat::BC3), bc::encode(bitmap, TextureFormat::BC3, &jobs));
+}
+
+TEST(BlockCompression, cookedTexturesStoreBlocks)
+{
+    cooked::TextureOptions options;
+    options.compress = true;
+    auto texture = CookedTexture(platform::fs::FileData(cooked::cookTexture(photo(16, 8, 3), options)));
+
+    EXPECT_EQ(TextureFormat::BC1, texture.format());
+    ASSERT_EQ(5, texture.levelCount());
+    EXPECT_EQ(bc::compressedSize(TextureFormat::BC1, 16, 8), texture.level(0).size);
+    EXPECT_EQ(8u, texture.level(4).size);
+    EXPECT_EQ(1, texture.level(4).width);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <ray/assets/BitmapKernels.hpp>
+#include <ray/assets/Cooked.hpp>
+#include <ray/platform/FileSystem.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <random>
+
+using namespace ray;
+using namespace assets;
+using namespace platform;
+
+namespace
+{
+    Bitmap gradient(int width, int height, int depth)
+    {
+        auto pixels = (uint8_t *)malloc(width * height * depth);
+        for (int i = 0; i < width * height * depth; ++i)
+            pixels[i] = (uint8_t)(i * 7);
+        return Bitmap(width, height, depth, pixels);
+    }
+
+    // Triangles of a n x n grid of quads, in a random order.
+    std::vector<uint32_t> shuffledGrid(uint32_t n)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t y = 0; y < n; ++y)
+        {
+            for (uint32_t x = 0; x < n; ++x)
+            {
+                auto corner = y * (n + 1) + x;
+                triangles.push_back({{ corner, corner + 1, corner + n + 1 }});
+                triangles.push_back({{ corner + 1, corner + n + 2, corner + n + 1 }});
+            }
+        }
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+
+        std::vector<uint32_t> result;
+        for (auto &triangle : triangles)
+            result.insert(result.end(), triangle.begin(), triangle.end());
+        return result;
+    }
+
+    // Vertices transformed per triangle with a FIFO cache of 16 entries.
+    float averageCacheMissRatio(const std::vector<uint32_t> &indices)
+    {
+        std::deque<uint32_t> cache;
+        size_t misses = 0;
+        for (auto index : indices)
+        {
+            if (std::find(cache.begin(), cache.end(), index) != cache.end())
+                continue;
+            ++misses;
+            cache.push_back(index);
+            if (cache.size() > 16)
+                cache.pop_front();
+        }
+        return (float)misses / (indices.size() / 3);
+    }
+
+    std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t> &indices)
+    {
+        std::vector<std::array<uint32_t, 3>> result;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            std::array<uint32_t, 3> triangle = {{ indices[i], indices[i + 1], indices[i + 2] }};
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            result.push_back(triangle);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST(Cooked, mipsAverageBlocks)
+{
+    auto pixels = (uint8_t *)malloc(3 * 2);
+    uint8_t values[] = { 0, 100, 50, 200, 255, 50 };
+    std::memcpy(pixels, values, sizeof(values));
+    auto half = kernels::halve(Bitmap(3, 2, 1, pixels));
+
+    ASSERT_EQ(1, half.width());
+    ASSERT_EQ(1, half.height());
+    EXPECT_EQ((0 + 100 + 200 + 255 + 2) / 4, half.pixels()[0]);
+}
+
+TEST(Cooked, texturesKeepTheirMipChain)
+{
+    auto bitmap = gradient(5, 3, 3);
+    auto cookedTexture = CookedTexture(fs::FileData(cooked::cookTexture(bitmap)));
+
+    EXPECT_EQ(5, cookedTexture.width());
+    EXPECT_EQ(3, cookedTexture.height());
+    EXPECT_EQ(3, cookedTexture.depth());
+    EXPECT_EQ(cooked::TextureFormat::Uncompressed, cookedTexture.format());
+    ASSERT_EQ(3, cookedTexture.levelCount());
+
+    auto base = cookedTexture.level(0);
+    EXPECT_EQ(0, std::memcmp(base.pixels, bitmap.pixels(), bitmap.size()));
+
+    auto expected = kernels::halve(bitmap);
+    auto mip = cookedTexture.level(1);
+    EXPECT_EQ(2, mip.width);
+    EXPECT_EQ(1, mip.height);
+    ASSERT_EQ((size_t)expected.size(), mip.size);
+    EXPECT_EQ(0, std::memcmp(mip.pixels, expected.pixels(), mip.size));
+    EXPECT_EQ(1, cookedTexture.level(2).width);
+    EXPECT_EQ(1, cookedTexture.level(2).height);
+}
+
+TEST(Cooked, mipsCanBeLeftOut)
+{
+    cooked::TextureOptions options;
+    options.mipmaps = false;
+    auto cookedTexture = CookedTexture(fs::FileData(cooked::cookTexture(gradient(64, 64, 4), options)));
+    EXPECT_EQ(1, cookedTexture.levelCount());
+}
+
+TEST(Cooked, vertexCacheOptimizationKeepsTheTriangles)
+{
+    auto indices = shuffledGrid(32);
+    auto optimized = indices;
+    cooked::optimizeVertexCache(optimized, 33 * 33);
+
+    EXPECT_EQ(sortedTriangles(indices), sortedTriangles(optimized));
+    EXPECT_LT(averageCacheMissRatio(optimized), 0.8f);
+    EXPECT_LT(averageCacheMissRatio(optimized), 0.5f * averageCacheMissRatio(indices));
+}
+
+TEST(Cooked, vertexFetchOptimizationFollowsTheIndices)
+{
+    std::vector<float> vertices;
+    for (int vertex = 0; vertex < 4; ++vertex)
+        vertices.insert(vertices.end(), cooked::FLOATS_PER_VERTEX, (float)vertex);
+    std::vector<uint32_t> indices = { 3, 1, 2, 2, 1, 0 };
+
+    cooked::optimizeVertexFetch(vertices, indices);
+
+    EXPECT_EQ((std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3 }), indices);
+    EXPECT_EQ(3.0f, vertices[0 * cooked::FLOATS_PER_VERTEX]);
+    EXPECT_EQ(1.0f, vertices[1 * cooked::FLOATS_PER_VERTEX]);
+    EXPECT_EQ(2.0f, vertices[2 * cooked::FLOATS_PER_VERTEX]);
+    EXPECT_EQ(0.0f, vertices[3 * cooked::FLOATS_PER_VERTEX]);
+}
+
+TEST(Cooked, findsArtifactsUnderTheCookedRoot)
+{
+    auto cookedDirectory = ::testing::TempDir() + "cooked";
+    fs::createDirectories(cookedDirectory + "/images");
+    std::ofstream(cookedDirectory + "/images/marble.jpg.rtex") << "cooked";
+
+    cooked::setRoot("res", cookedDirectory);
+    EXPECT_EQ(cookedDirectory + "/images/marble.jpg.rtex", cooked::find(cooked::texturePath("res/images/marble.jpg")));
+    EXPECT_TRUE(cooked::exists(cooked::texturePath("res/images/marble.jpg")));
+    EXPECT_EQ("", cooked::find(cooked::texturePath("res/images/granite.jpg")));
+    EXPECT_EQ("", cooked::find(cooked::texturePath("other/images/marble.jpg")));
+
+    std::remove((cookedDirectory + "/images/marble.jpg.rtex").c_str());
+}
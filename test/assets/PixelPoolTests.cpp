@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <ray/assets/PixelPool.hpp>
+
+using namespace ray;
+using namespace assets;
+
+TEST(PixelPool, roundsSizesUpToPowersOfTwo)
+{
+    EXPECT_EQ(PixelPool::sizeClass(1), 0);
+    EXPECT_EQ(PixelPool::sizeClass(4096), 0);
+    EXPECT_EQ(PixelPool::sizeClass(4097), 1);
+    EXPECT_EQ(PixelPool::sizeClass(1 << 20), 8);
+    EXPECT_EQ(PixelPool::sizeClass(PixelPool::MIN_CLASS_SIZE << (PixelPool::CLASS_COUNT - 1)), PixelPool::CLASS_COUNT - 1);
+    EXPECT_EQ(PixelPool::sizeClass((PixelPool::MIN_CLASS_SIZE << (PixelPool::CLASS_COUNT - 1)) + 1), -1);
+}
+
+TEST(PixelPool, buffersAreAligned)
+{
+    for (auto size : { 1, 100, 5000, 1 << 20 })
+    {
+        auto pixels = PixelPool::allocateAligned(size);
+        EXPECT_EQ((uintptr_t)pixels % PixelPool::ALIGNMENT, 0u);
+        pixels[size - 1] = 1;
+        PixelPool::freeAligned(pixels);
+    }
+}
+
+TEST(PixelPool, reusesReleasedBuffers)
+{
+    PixelPool pool;
+    auto first = pool.acquire(5000);
+    EXPECT_EQ(pool.missCount(), 1u);
+    pool.release(first, 5000);
+    EXPECT_EQ(pool.cachedBytes(), 8192u);
+
+    auto second = pool.acquire(8000);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(pool.hitCount(), 1u);
+    EXPECT_EQ(pool.cachedBytes(), 0u);
+
+    auto third = pool.acquire(100);
+    EXPECT_NE(third, first);
+    EXPECT_EQ(pool.missCount(), 2u);
+    pool.release(second, 8000);
+    pool.release(third, 100);
+}
+
+TEST(PixelPool, keepsNoMoreThanItsLimit)
+{
+    PixelPool pool(10000);
+    auto a = pool.acquire(4096), b = pool.acquire(4096), c = pool.acquire(4096);
+    pool.release(a, 4096);
+    pool.release(b, 4096);
+    pool.release(c, 4096);
+    EXPECT_EQ(pool.cachedBytes(), 8192u);
+
+    pool.trim();
+    EXPECT_EQ(pool.cachedBytes(), 0u);
+}
+
+TEST(PixelPool, doesNotKeepHugeBuffers)
+{
+    PixelPool pool(~size_t(0));
+    auto size = (PixelPool::MIN_CLASS_SIZE << (PixelPool::CLASS_COUNT - 1)) + 1;
+    auto pixels = pool.acquire(size);
+    EXPECT_NE(pixels, nullptr);
+    pool.release(pixels, size);
+    EXPECT_EQ(pool.cachedBytes(), 0u);
+}
@@ -0,0 +1,40 @@
+#include <ray/entities/MeshBatch.hpp>
+#include <gtest/gtest.h>
+
+using namespace ray;
+using namespace entities;
+
+TEST(MeshBatch, sharedVerticesAreIndexedOnce)
+{
+    auto a = details::BatchVertex{{ 0, 0, 0, 0, 0, 0, 0, 1 }};
+    auto b = details::BatchVertex{{ 1, 0, 0, 1, 0, 0, 0, 1 }};
+    auto c = details::BatchVertex{{ 1, 1, 0, 1, 1, 0, 0, 1 }};
+    auto d = details::BatchVertex{{ 0, 1, 0, 0, 1, 0, 0, 1 }};
+    std::vector<details::BatchVertex> quad = { a, b, c, c, d, a };
+
+    std::vector<details::BatchVertex> vertices;
+    std::vector<math::u32> indices;
+    details::indexVertices(quad, vertices, indices);
+
+    EXPECT_EQ(vertices.size(), 4u);
+    EXPECT_EQ(indices, (std::vector<math::u32>{ 0, 1, 2, 2, 3, 0 }));
+}
+
+TEST(MeshBatch, indicesAreRelativeToTheMeshFirstVertex)
+{
+    auto a = details::BatchVertex{{ 0, 0, 0, 0, 0, 0, 0, 1 }};
+    auto b = details::BatchVertex{{ 1, 0, 0, 1, 0, 0, 0, 1 }};
+    std::vector<details::BatchVertex> vertices = { a, b };
+    std::vector<math::u32> indices = { 0, 1 };
+
+    details::indexVertices({ b, b, a }, vertices, indices);
+
+    EXPECT_EQ(vertices.size(), 4u);
+    EXPECT_EQ(indices, (std::vector<math::u32>{ 0, 1, 0, 0, 1 }));
+}
+
+TEST(MeshBatch, drawCommandMatchesTheIndirectLayout)
+{
+    EXPECT_EQ(sizeof(MeshBatch::DrawCommand), 5*sizeof(GLuint));
+    EXPECT_EQ(sizeof(MeshBatch::DrawData) % sizeof(math::f32), 0u);
+}
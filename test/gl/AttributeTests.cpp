@@ -0,0 +1,43 @@
+#include <ray/gl/InstanceBuffer.hpp>
+#include <gtest/gtest.h>
+
+using namespace ray;
+using namespace gl;
+using namespace math;
+
+TEST(Attribute, vectorsTakeOneLocation)
+{
+    auto attribute = Attribute<vec3>(2);
+    EXPECT_EQ(attribute.locationCount(), 1u);
+    EXPECT_EQ(attribute.componentCount(), 3u);
+}
+
+TEST(Attribute, matricesTakeOneLocationPerColumn)
+{
+    auto mat3Attribute = Attribute<mat3>(0);
+    EXPECT_EQ(mat3Attribute.locationCount(), 3u);
+    EXPECT_EQ(mat3Attribute.componentCount(), 3u);
+
+    auto mat4Attribute = Attribute<mat4>(0);
+    EXPECT_EQ(mat4Attribute.locationCount(), 4u);
+    EXPECT_EQ(mat4Attribute.componentCount(), 4u);
+}
+
+TEST(InstanceBuffer, columnMajorStoresColumnsContiguously)
+{
+    auto matrix = mat4{
+         1.0f,  2.0f,  3.0f,  4.0f,
+         5.0f,  6.0f,  7.0f,  8.0f,
+         9.0f, 10.0f, 11.0f, 12.0f,
+        13.0f, 14.0f, 15.0f, 16.0f
+    };
+    auto columns = columnMajor(matrix);
+    auto data = reinterpret_cast<const f32 *>(&columns);
+    EXPECT_EQ(data[0], 1);
+    EXPECT_EQ(data[1], 5);
+    EXPECT_EQ(data[2], 9);
+    EXPECT_EQ(data[3], 13);
+    EXPECT_EQ(data[4], 2);
+    EXPECT_EQ(data[12], 4);
+    EXPECT_EQ(data[15], 16);
+}
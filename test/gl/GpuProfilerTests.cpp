@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <ray/gl/GpuProfiler.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ray::gl;
+
+namespace {
+
+    // Stands in for the GL: each timestamp takes 'step' nanoseconds, and only the
+    // queries issued before 'completed' have a result.
+    struct FakeGpu
+    {
+        std::vector<uint64_t> results;
+        uint64_t clock = 1000000, step = 10;
+        size_t completed = 0, destroyed = 0;
+    };
+
+    struct FakeQueries
+    {
+        FakeGpu *gpu;
+        GLuint create() { gpu->results.push_back(0); return (GLuint)gpu->results.size(); }
+        void destroy(GLuint) { ++gpu->destroyed; }
+        void timestamp(GLuint query) { gpu->results[query - 1] = gpu->clock; gpu->clock += gpu->step; }
+        bool isAvailable(GLuint query) { return query <= gpu->completed; }
+        uint64_t result(GLuint query) { return gpu->results[query - 1]; }
+        uint64_t now() { return gpu->clock; }
+    };
+
+    using Profiler = BasicGpuProfiler<FakeQueries>;
+
+    const Profiler::ZoneStatistics *find(const Profiler &profiler, const std::string &name)
+    {
+        for (auto &zone : profiler.lastFrame())
+            if (name == zone.name)
+                return &zone;
+        return nullptr;
+    }
+}
+
+TEST(GpuProfiler, readsFramesBackOnceTheGpuIsDone)
+{
+    FakeGpu gpu;
+    Profiler profiler(4, FakeQueries{ &gpu });
+
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        for (int draw = 0; draw <= frame; ++draw)
+            GpuZone<Profiler> zone(profiler, "draw");
+        profiler.endFrame();
+    }
+    EXPECT_TRUE(profiler.lastFrame().empty());
+
+    gpu.completed = gpu.results.size();
+    profiler.endFrame();
+    ASSERT_NE(nullptr, find(profiler, "draw"));
+    EXPECT_EQ(2u, find(profiler, "draw")->calls);
+    EXPECT_EQ(20u, find(profiler, "draw")->inclusive);
+    EXPECT_EQ(2u, profiler.latency());
+    EXPECT_EQ(0u, profiler.droppedFrames());
+}
+
+TEST(GpuProfiler, subtractsNestedZonesFromSelfTime)
+{
+    FakeGpu gpu;
+    Profiler profiler(2, FakeQueries{ &gpu });
+    {
+        GpuZone<Profiler> outer(profiler, "outer");
+        GpuZone<Profiler> first(profiler, "inner");
+        gpu.clock += 100;
+    }
+    profiler.endFrame();
+    gpu.completed = gpu.results.size();
+    profiler.endFrame();
+
+    auto outer = find(profiler, "outer"), inner = find(profiler, "inner");
+    ASSERT_NE(nullptr, outer);
+    ASSERT_NE(nullptr, inner);
+    EXPECT_EQ(110u, inner->inclusive);
+    EXPECT_EQ(130u, outer->inclusive);
+    EXPECT_EQ(20u, outer->exclusive);
+    EXPECT_DOUBLE_EQ(130e-9, profiler.lastFrameTime().count());
+}
+
+TEST(GpuProfiler, dropsFramesRatherThanWaiting)
+{
+    FakeGpu gpu;
+    {
+        Profiler profiler(2, FakeQueries{ &gpu });
+        for (int frame = 0; frame < 6; ++frame)
+        {
+            {
+                GpuZone<Profiler> zone(profiler, "frame");
+            }
+            profiler.endFrame();
+        }
+        EXPECT_EQ(4u, profiler.droppedFrames());
+        EXPECT_EQ(6u, gpu.results.size());
+    }
+    EXPECT_EQ(6u, gpu.destroyed);
+}
+
+TEST(GpuProfiler, addsItsZonesToTheTrace)
+{
+    FakeGpu gpu;
+    Profiler profiler(2, FakeQueries{ &gpu });
+    {
+        GpuZone<Profiler> zone(profiler, "gpu zone");
+    }
+    profiler.endFrame();
+    gpu.completed = gpu.results.size();
+    profiler.endFrame();
+
+    std::ostringstream out;
+    ray::platform::Profiler::instance().writeChromeTrace(out);
+    EXPECT_NE(std::string::npos, out.str().find("\"args\":{\"name\":\"GPU\"}"));
+    EXPECT_NE(std::string::npos, out.str().find("\"name\":\"gpu zone\""));
+}
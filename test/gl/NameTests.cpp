@@ -0,0 +1,77 @@
+#include <ray/gl/Name.hpp>
+#include <gtest/gtest.h>
+
+using namespace ray;
+using namespace gl;
+
+TEST(Name, isHashedAtCompileTime)
+{
+    constexpr auto name = "modelMatrix"_u;
+    static_assert(name.hash == platform::fnv1a("modelMatrix"), "");
+    EXPECT_STREQ(name.text, "modelMatrix");
+}
+
+TEST(Name, hashesTheSameWayFromAllSources)
+{
+    auto fromLiteral = "vertPosition"_a;
+    auto fromPointer = AttributeName("vertPosition");
+    auto fromString  = AttributeName(std::string("vertPosition"));
+    EXPECT_EQ(fromLiteral.hash, fromPointer.hash);
+    EXPECT_EQ(fromLiteral.hash, fromString.hash);
+}
+
+TEST(Name, matchesReferenceFNV1a)
+{
+    EXPECT_EQ(platform::fnv1a(""), 0x811C9DC5u);
+    EXPECT_EQ(platform::fnv1a("a"), 0xE40C292Cu);
+    EXPECT_EQ(platform::fnv1a("foobar"), 0xBF9CF968u);
+    EXPECT_EQ(platform::fnv1a64("", 0), 0xCBF29CE484222325ull);
+    EXPECT_EQ(platform::fnv1a64("a", 1), 0xAF63DC4C8601EC8Cull);
+    EXPECT_EQ(platform::fnv1a64("foobar", 6), 0x85944171F73967E8ull);
+}
+
+TEST(NameTable, findsWhatWasAdded)
+{
+    auto table = NameTable<int>();
+    table.add("projectionMatrix", 1);
+    table.add("modelMatrix", 2);
+    table.add("viewMatrix", 3);
+    table.add("diffuseTexture", 4);
+    table.add("lightColor", 5);
+
+    EXPECT_EQ(table.size(), 5u);
+    EXPECT_EQ(*table.find("projectionMatrix"_u), 1);
+    EXPECT_EQ(*table.find("modelMatrix"_u), 2);
+    EXPECT_EQ(*table.find("viewMatrix"_u), 3);
+    EXPECT_EQ(*table.find("diffuseTexture"_u), 4);
+    EXPECT_EQ(*table.find("lightColor"_u), 5);
+}
+
+TEST(NameTable, returnsNullWhenNotFound)
+{
+    auto table = NameTable<int>();
+    EXPECT_EQ(table.find("modelMatrix"_u), nullptr);
+    table.add("modelMatrix", 2);
+    EXPECT_EQ(table.find("viewMatrix"_u), nullptr);
+    table.clear();
+    EXPECT_EQ(table.find("modelMatrix"_u), nullptr);
+}
+
+TEST(NameTable, checksTheNameOnAHashHit)
+{
+    auto table = NameTable<int>();
+    table.add("modelMatrix", 2);
+
+    // NOTE(cme): same hash as "modelMatrix", but another name.
+    auto impostor = UniformName("modelMatrix");
+    impostor.text = "modelMatrjx";
+    EXPECT_EQ(table.find(impostor), nullptr);
+
+    auto longer = std::string("modelMatrix[0]");
+    auto prefix = UniformName(longer);
+    prefix.hash = platform::fnv1a("modelMatrix");
+    EXPECT_EQ(table.find(prefix), nullptr);
+
+    auto fromString = std::string("modelMatrix");
+    EXPECT_EQ(*table.find(UniformName(fromString)), 2);
+}
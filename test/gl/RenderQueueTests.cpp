@@ -0,0 +1,159 @@
+#include <ray/gl/RenderQueue.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+using namespace ray;
+using namespace gl;
+
+TEST(SortKey, fieldsRoundTrip)
+{
+    auto key = SortKey::encode(3, 1234, 54321, 4000, 1.0f);
+    EXPECT_EQ(SortKey::pass(key), 3u);
+    EXPECT_EQ(SortKey::program(key), 1234u);
+    EXPECT_EQ(SortKey::material(key), 54321u);
+    EXPECT_EQ(SortKey::texture(key), 4000u);
+    EXPECT_EQ(SortKey::depth(key), (1u << 20) - 1);
+}
+
+TEST(SortKey, passDominatesEverythingElse)
+{
+    EXPECT_LT(SortKey::encode(0, 4095, 65535, 4095, 1.0f), SortKey::encode(1, 0, 0, 0, 0.0f));
+    EXPECT_LT(SortKey::encode(1, 0, 65535, 4095, 1.0f), SortKey::encode(1, 1, 0, 0, 0.0f));
+}
+
+TEST(SortKey, closerDrawsComeFirst)
+{
+    EXPECT_LT(SortKey::encode(0, 1, 1, 1, 0.25f), SortKey::encode(0, 1, 1, 1, 0.75f));
+    EXPECT_EQ(SortKey::depth(SortKey::encode(0, 0, 0, 0, -1.0f)), 0u);
+}
+
+TEST(RadixSort, matchesStandardSort)
+{
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(10000), scratchKeys;
+    std::vector<uint32_t> indices(keys.size()), scratchIndices;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = SortKey::encode(random() % 4, random() % 8, random() % 32, random() % 16, float(random() % 1000) / 1000.0f);
+        indices[i] = (uint32_t)i;
+    }
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+    auto original = keys;
+
+    details::radixSort(keys, indices, scratchKeys, scratchIndices);
+
+    EXPECT_EQ(keys, expected);
+    for (size_t i = 0; i < keys.size(); ++i)
+        EXPECT_EQ(original[indices[i]], keys[i]);
+}
+
+TEST(RadixSort, isStable)
+{
+    std::vector<uint64_t> keys = { 2, 1, 2, 1 }, scratchKeys;
+    std::vector<uint32_t> indices = { 0, 1, 2, 3 }, scratchIndices;
+    details::radixSort(keys, indices, scratchKeys, scratchIndices);
+    EXPECT_EQ(indices, (std::vector<uint32_t>{ 1, 3, 0, 2 }));
+}
+
+TEST(RenderQueue, countsStateChangesInSubmissionOrder)
+{
+    // NOTE(cme): only the addresses of the programs matter to the queue.
+    const ShaderProgram *programs[] = { reinterpret_cast<const ShaderProgram *>(0x10), reinterpret_cast<const ShaderProgram *>(0x20) };
+    auto queue = RenderQueue();
+    for (int i = 0; i < 8; ++i)
+    {
+        RenderQueue::Item item;
+        item.program = programs[i % 2];
+        item.texture = (GLuint)(1 + i % 2);
+        item.vertexArray = 1;
+        queue.submit(item);
+    }
+
+    auto statistics = queue.countStateChanges();
+    EXPECT_EQ(statistics.draws, 8u);
+    EXPECT_EQ(statistics.programChanges, 8u);
+    EXPECT_EQ(statistics.materialChanges, 8u);
+    EXPECT_EQ(statistics.textureChanges, 8u);
+    EXPECT_EQ(statistics.vertexArrayChanges, 1u);
+}
+
+TEST(RenderQueue, sortingGroupsSharedState)
+{
+    const ShaderProgram *programs[] = { reinterpret_cast<const ShaderProgram *>(0x10), reinterpret_cast<const ShaderProgram *>(0x20) };
+    auto queue = RenderQueue();
+    for (int i = 0; i < 8; ++i)
+    {
+        RenderQueue::Item item;
+        item.program = programs[i % 2];
+        item.texture = (GLuint)(1 + i % 4);
+        item.vertexArray = 1;
+        item.depth = 1.0f - (float)i / 8;
+        queue.submit(item);
+    }
+
+    queue.sort();
+    auto statistics = queue.countStateChanges();
+    EXPECT_EQ(queue.unsortedStatistics().stateChanges(), 8u + 8u + 8u + 1u);
+    EXPECT_EQ(statistics.draws, 8u);
+    EXPECT_EQ(statistics.programChanges, 2u);
+    EXPECT_EQ(statistics.materialChanges, 2u);
+    EXPECT_EQ(statistics.textureChanges, 4u);
+    EXPECT_EQ(statistics.vertexArrayChanges, 1u);
+}
+
+TEST(RenderQueue, keepsTextureIdsWhenTheyRunOutMidFrame)
+{
+    auto program = reinterpret_cast<const ShaderProgram *>(0x10);
+    auto queue = RenderQueue();
+    auto submit = [&](GLuint texture) {
+        RenderQueue::Item item;
+        item.program = program;
+        item.texture = texture;
+        item.vertexArray = 1;
+        queue.submit(item);
+    };
+    submit(1);
+    for (GLuint texture = 2; texture < 6000; ++texture)
+        submit(texture);
+    submit(1);
+
+    queue.sort();
+    auto statistics = queue.countStateChanges();
+    EXPECT_EQ(statistics.draws, 6000u);
+    // the first 4095 textures keep their own id, the rest share the last one
+    EXPECT_EQ(statistics.textureChanges, 5999u);
+}
+
+TEST(RenderQueue, drawsIndexedItemsWithTheirIndices)
+{
+    auto program = reinterpret_cast<const ShaderProgram *>(0x10);
+    auto queue = RenderQueue();
+    for (int i = 0; i < 6; ++i)
+    {
+        RenderQueue::Item item;
+        item.program = program;
+        item.vertexArray = (GLuint)(1 + i % 2);
+        if (i % 2)
+        {
+            item.indexCount = 36;
+            item.indexOffset = 64;
+        }
+        else
+            item.vertexCount = 36;
+        queue.submit(item);
+    }
+
+    queue.sort();
+    auto statistics = queue.countStateChanges();
+    EXPECT_EQ(statistics.draws, 6u);
+    EXPECT_EQ(statistics.indexedDraws, 3u);
+
+    RenderQueue::Item arrays;
+    arrays.vertexCount = 36;
+    EXPECT_FALSE(arrays.isIndexed());
+    RenderQueue::Item elements;
+    elements.indexCount = 36;
+    EXPECT_TRUE(elements.isIndexed());
+}
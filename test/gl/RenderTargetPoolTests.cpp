@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <ray/gl/RenderTargetPool.hpp>
+
+using namespace ray::gl;
+
+namespace {
+
+    // Stands in for a RenderTarget, only counts how many are alive.
+    struct FakeTarget
+    {
+        static int alive;
+        FakeTarget(const RenderTargetDescription &description) : mDescription(description) { ++alive; }
+        ~FakeTarget() { --alive; }
+        const RenderTargetDescription &description() const { return mDescription; }
+        size_t byteSize() const { return mDescription.byteSize(); }
+        RenderTargetDescription mDescription;
+    };
+
+    int FakeTarget::alive = 0;
+
+    using Pool = BasicRenderTargetPool<FakeTarget>;
+}
+
+TEST(RenderTargetDescription, accountsForFormatAndSamples)
+{
+    RenderTargetDescription description;
+    description.width = 100;
+    description.height = 10;
+    EXPECT_EQ(4000u, description.byteSize());
+    description.format = GL_RGBA16F;
+    EXPECT_EQ(8000u, description.byteSize());
+    description.samples = 4;
+    EXPECT_EQ(32000u, description.byteSize());
+}
+
+TEST(RenderTargetPool, recyclesTargetsAcrossFrames)
+{
+    Pool pool;
+    pool.beginFrame();
+    auto *first = &pool.acquire(640, 480);
+    auto *second = &pool.acquire(640, 480);
+    EXPECT_NE(first, second);
+
+    pool.beginFrame();
+    EXPECT_EQ(first, &pool.acquire(640, 480));
+    EXPECT_EQ(second, &pool.acquire(640, 480));
+
+    auto statistics = pool.statistics();
+    EXPECT_EQ(2u, statistics.allocations);
+    EXPECT_EQ(2u, statistics.reuses);
+    EXPECT_EQ(2u, statistics.targetsInUse);
+    EXPECT_EQ(2u * 640 * 480 * 4, statistics.bytes);
+}
+
+TEST(RenderTargetPool, matchesTheWholeDescription)
+{
+    Pool pool;
+    pool.beginFrame();
+    auto *color = &pool.acquire(640, 480);
+    pool.release(*color);
+    EXPECT_NE(color, &pool.acquire(640, 480, GL_RGBA16F));
+    EXPECT_NE(color, &pool.acquire(640, 480, GL_RGBA8, 4));
+    EXPECT_NE(color, &pool.acquire(320, 240));
+    EXPECT_EQ(color, &pool.acquire(640, 480));
+    EXPECT_EQ(4u, pool.statistics().allocations);
+}
+
+TEST(RenderTargetPool, evictsIdleTargets)
+{
+    FakeTarget::alive = 0;
+    Pool pool(2);
+    pool.beginFrame();
+    pool.acquire(1920, 1080);
+    pool.acquire(1280, 720);
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        pool.beginFrame();
+        pool.acquire(1280, 720);
+    }
+
+    auto statistics = pool.statistics();
+    EXPECT_EQ(1, FakeTarget::alive);
+    EXPECT_EQ(1u, statistics.targets);
+    EXPECT_EQ(1u, statistics.evictions);
+    EXPECT_EQ(1280u * 720 * 4, statistics.bytes);
+    EXPECT_EQ((1920u * 1080 + 1280u * 720) * 4, statistics.peakBytes);
+}
@@ -0,0 +1,89 @@
+#include <ray/gl/Std140.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+
+using namespace ray;
+using namespace gl;
+using namespace math;
+
+TEST(std140, scalarsAreAlignedOnFourBytes)
+{
+    using Layout = std140::Layout<f32, i32, u32>;
+    EXPECT_EQ(Layout::count(), 3u);
+    EXPECT_EQ(Layout::offset(0), 0u);
+    EXPECT_EQ(Layout::offset(1), 4u);
+    EXPECT_EQ(Layout::offset(2), 8u);
+    EXPECT_EQ(Layout::size(), 12u);
+}
+
+TEST(std140, vec2IsAlignedOnEightBytes)
+{
+    using Layout = std140::Layout<f32, vec2, f32>;
+    EXPECT_EQ(Layout::offset(0), 0u);
+    EXPECT_EQ(Layout::offset(1), 8u);
+    EXPECT_EQ(Layout::offset(2), 16u);
+    EXPECT_EQ(Layout::size(), 20u);
+}
+
+TEST(std140, vec3IsAlignedOnSixteenBytesButOnlyTakesTwelve)
+{
+    using Layout = std140::Layout<f32, vec3, f32>;
+    EXPECT_EQ(Layout::offset(0), 0u);
+    EXPECT_EQ(Layout::offset(1), 16u);
+    EXPECT_EQ(Layout::offset(2), 28u);
+    EXPECT_EQ(Layout::size(), 32u);
+}
+
+TEST(std140, matricesAreFourVec4)
+{
+    using Layout = std140::Layout<f32, mat4, vec4>;
+    EXPECT_EQ(Layout::offset(1), 16u);
+    EXPECT_EQ(Layout::offset(2), 80u);
+    EXPECT_EQ(Layout::size(), 96u);
+}
+
+TEST(std140, arrayElementsArePaddedToSixteenBytes)
+{
+    using Layout = std140::Layout<f32, f32[3], f32>;
+    EXPECT_EQ(Layout::offset(1), 16u);
+    EXPECT_EQ(Layout::offset(2), 64u);
+    EXPECT_EQ(Layout::size(), 68u);
+}
+
+struct WellFormed
+{
+    mat4 projection;
+    vec4 color;
+    vec3 position;
+    float intensity;
+    using std140 = gl::std140::Layout<mat4, vec4, vec3, float>;
+    static constexpr auto offsets() { return gl::std140::offsets(offsetof(WellFormed, projection), offsetof(WellFormed, color), offsetof(WellFormed, position), offsetof(WellFormed, intensity)); }
+};
+
+struct Misaligned
+{
+    float intensity;
+    vec3 position;
+    using std140 = gl::std140::Layout<float, vec3>;
+    static constexpr auto offsets() { return gl::std140::offsets(offsetof(Misaligned, intensity), offsetof(Misaligned, position)); }
+};
+
+TEST(std140, canBeCheckedAtCompileTime)
+{
+    static_assert(WellFormed::std140::matches(offsetof(WellFormed, projection), offsetof(WellFormed, color), offsetof(WellFormed, position), offsetof(WellFormed, intensity)), "");
+    static_assert(!Misaligned::std140::matches(offsetof(Misaligned, intensity), offsetof(Misaligned, position)), "");
+    EXPECT_EQ(WellFormed::std140::size(), sizeof(WellFormed));
+}
+
+TEST(std140, detectsMissingMembers)
+{
+    EXPECT_FALSE(WellFormed::std140::matches(offsetof(WellFormed, projection), offsetof(WellFormed, color)));
+}
+
+TEST(std140, checksTheOffsetsBlocksList)
+{
+    static_assert(WellFormed::std140::matches(WellFormed::offsets()), "");
+    static_assert(!Misaligned::std140::matches(Misaligned::offsets()), "");
+    static_assert(!WellFormed::std140::matches(gl::std140::offsets(0, 64, 80)), "one member short");
+    EXPECT_EQ(80u, WellFormed::offsets().values[2]);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <ray/gl/TextureArray.hpp>
+
+using namespace ray::gl;
+using LayerAllocator = ray::gl::details::LayerAllocator;
+
+TEST(TextureArray, padsLayersWithTheEdgesOfTheirBitmap)
+{
+    const uint8_t pixels[] = { 1, 2, 9,
+                               3, 4, 9 };
+    auto padded = details::padToLayer(ray::assets::BitmapView(pixels, 2, 2, 1, 3), 4, 3);
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 2, 2, 2,
+                                     3, 4, 4, 4,
+                                     3, 4, 4, 4 }), padded);
+}
+
+TEST(LayerAllocator, roundsExtentsUpToPowersOfTwo)
+{
+    EXPECT_EQ(16, LayerAllocator::sizeClass(1, 16));
+    EXPECT_EQ(16, LayerAllocator::sizeClass(16, 16));
+    EXPECT_EQ(32, LayerAllocator::sizeClass(17, 16));
+    EXPECT_EQ(512, LayerAllocator::sizeClass(300, 16));
+}
+
+TEST(LayerAllocator, sharesArraysWithinASizeClass)
+{
+    LayerAllocator allocator(4);
+    bool isNewArray = false;
+
+    auto first = allocator.allocate(256, 256, isNewArray);
+    EXPECT_TRUE(isNewArray);
+    auto second = allocator.allocate(200, 250, isNewArray);
+    EXPECT_FALSE(isNewArray);
+    EXPECT_EQ(first.array, second.array);
+    EXPECT_NE(first.layer, second.layer);
+
+    auto other = allocator.allocate(512, 256, isNewArray);
+    EXPECT_TRUE(isNewArray);
+    EXPECT_NE(first.array, other.array);
+    EXPECT_EQ(512, allocator.array(other.array).width);
+    EXPECT_EQ(256, allocator.array(other.array).height);
+    EXPECT_EQ(3u, allocator.usedLayers());
+}
+
+TEST(LayerAllocator, opensANewArrayWhenFull)
+{
+    LayerAllocator allocator(2);
+    bool isNewArray = false;
+
+    auto a = allocator.allocate(64, 64, isNewArray);
+    auto b = allocator.allocate(64, 64, isNewArray);
+    EXPECT_FALSE(isNewArray);
+    auto c = allocator.allocate(64, 64, isNewArray);
+    EXPECT_TRUE(isNewArray);
+    EXPECT_EQ(a.array, b.array);
+    EXPECT_NE(a.array, c.array);
+    EXPECT_EQ(2u, allocator.arrayCount());
+}
+
+TEST(LayerAllocator, reusesFreedLayers)
+{
+    LayerAllocator allocator(2);
+    bool isNewArray = false;
+
+    auto a = allocator.allocate(64, 64, isNewArray);
+    allocator.allocate(64, 64, isNewArray);
+    allocator.free(a);
+    auto c = allocator.allocate(64, 64, isNewArray);
+    EXPECT_FALSE(isNewArray);
+    EXPECT_EQ(a.array, c.array);
+    EXPECT_EQ(a.layer, c.layer);
+    EXPECT_EQ(1u, allocator.arrayCount());
+}
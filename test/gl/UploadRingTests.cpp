@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <ray/gl/UploadRing.hpp>
+#include <thread>
+#include <vector>
+
+using namespace ray::gl;
+
+namespace {
+
+    // Stands in for the GL: uploads are recorded, with the pixels they read, and
+    // only the fences issued before 'completed' are signaled.
+    struct FakeGpu
+    {
+        std::vector<uint8_t> memory;
+        std::vector<StagedUpload> uploads;
+        std::vector<std::vector<uint8_t>> pixels;
+        std::vector<std::pair<GLenum, GLuint>> mipmaps;
+        size_t fences = 0, completed = 0, released = 0;
+        bool isDestroyed = false;
+    };
+
+    struct FakeBuffers
+    {
+        using Fence = size_t;
+
+        FakeGpu *gpu;
+        uint8_t *create(size_t capacity) { gpu->memory.resize(capacity); return gpu->memory.data(); }
+        void destroy() { gpu->isDestroyed = true; }
+        void begin() {}
+        void upload(const StagedUpload &upload)
+        {
+            auto first = gpu->memory.begin() + upload.offset;
+            gpu->uploads.push_back(upload);
+            gpu->pixels.emplace_back(first, first + upload.width * upload.height * upload.depth);
+        }
+        void generateMipmap(GLenum target, GLuint texture) { gpu->mipmaps.emplace_back(target, texture); }
+        void end() {}
+        Fence fence() { return ++gpu->fences; }
+        bool isSignaled(Fence fence) { return fence <= gpu->completed; }
+        void release(Fence) { ++gpu->released; }
+    };
+
+    using Ring = BasicUploadRing<FakeBuffers>;
+
+    Ring::Staging stage(Ring &ring, int width, int height, uint8_t value)
+    {
+        auto staging = ring.reserve(width, height, 1);
+        if (staging.isValid())
+            std::memset(staging.pixels(), value, staging.size());
+        return staging;
+    }
+}
+
+TEST(UploadRing, issuesSubmittedUploadsOnFlush)
+{
+    FakeGpu gpu;
+    Ring ring(4096, FakeBuffers{ &gpu });
+
+    auto staging = stage(ring, 10, 2, 7);
+    ASSERT_TRUE(staging.isValid());
+    ring.submit(staging, GL_TEXTURE_2D, 3, 0, 5, 6, true);
+    EXPECT_TRUE(gpu.uploads.empty());
+
+    ring.flush();
+    ASSERT_EQ(1u, gpu.uploads.size());
+    EXPECT_EQ(3u, gpu.uploads[0].texture);
+    EXPECT_EQ(5, gpu.uploads[0].x);
+    EXPECT_EQ(6, gpu.uploads[0].y);
+    EXPECT_EQ(10, gpu.uploads[0].width);
+    EXPECT_EQ(std::vector<uint8_t>(20, 7), gpu.pixels[0]);
+
+    ring.endFrame();
+    EXPECT_EQ(1u, ring.lastFrame().uploads);
+    EXPECT_EQ(20u, ring.lastFrame().bytes);
+    EXPECT_EQ(1u, gpu.fences);
+}
+
+TEST(UploadRing, keepsMemoryUntilTheGpuIsDone)
+{
+    FakeGpu gpu;
+    Ring ring(4 * Ring::ALIGNMENT, FakeBuffers{ &gpu });
+
+    for (int i = 0; i < 3; ++i)
+        ring.submit(stage(ring, (int)Ring::ALIGNMENT, 1, (uint8_t)i), GL_TEXTURE_2D, 1, 0, 0, 0, false);
+    ring.endFrame();
+    EXPECT_EQ(3 * Ring::ALIGNMENT, ring.usedBytes());
+
+    EXPECT_TRUE(stage(ring, (int)Ring::ALIGNMENT, 1, 3).isValid());
+    EXPECT_FALSE(stage(ring, 1, 1, 4).isValid());
+
+    gpu.completed = gpu.fences;
+    ring.endFrame();
+    EXPECT_EQ(1u, ring.lastFrame().rejected);
+    EXPECT_EQ(Ring::ALIGNMENT, ring.usedBytes());
+    EXPECT_EQ(1u, gpu.released);
+}
+
+TEST(UploadRing, wrapsAroundWithoutSplittingUploads)
+{
+    FakeGpu gpu;
+    Ring ring(4 * Ring::ALIGNMENT, FakeBuffers{ &gpu });
+
+    auto first = stage(ring, 2 * (int)Ring::ALIGNMENT, 1, 1);
+    ring.submit(first, GL_TEXTURE_2D, 1, 0, 0, 0, false);
+    ring.endFrame();
+    auto second = stage(ring, 1, 1, 2);
+    ring.submit(second, GL_TEXTURE_2D, 1, 0, 0, 0, false);
+    ring.endFrame();
+
+    gpu.completed = 1;
+    ring.endFrame();
+    EXPECT_EQ(Ring::ALIGNMENT, ring.usedBytes());
+
+    auto third = stage(ring, 2 * (int)Ring::ALIGNMENT, 1, 3);
+    ASSERT_TRUE(third.isValid());
+    EXPECT_EQ(gpu.memory.data(), third.pixels());
+    EXPECT_EQ(4 * Ring::ALIGNMENT, ring.usedBytes());
+
+    EXPECT_FALSE(ring.reserve(5 * (int)Ring::ALIGNMENT, 1, 1).isValid());
+    ring.submit(third, GL_TEXTURE_2D, 1, 0, 0, 0, false);
+}
+
+TEST(UploadRing, generatesMipmapsOncePerTexture)
+{
+    FakeGpu gpu;
+    Ring ring(4096, FakeBuffers{ &gpu });
+
+    for (int i = 0; i < 4; ++i)
+        ring.submit(stage(ring, 4, 4, 0), GL_TEXTURE_2D, i % 2 ? 1 : 2, 0, i * 4, 0, true);
+    ring.submit(stage(ring, 4, 4, 0), GL_TEXTURE_CUBE_MAP_POSITIVE_X, 3, 0, 0, 0, false);
+    ring.endFrame();
+
+    EXPECT_EQ(5u, gpu.uploads.size());
+    ASSERT_EQ(2u, gpu.mipmaps.size());
+    EXPECT_EQ(2u, gpu.mipmaps[0].second);
+    EXPECT_EQ(1u, gpu.mipmaps[1].second);
+}
+
+TEST(UploadRing, takesUploadsFromAnyThread)
+{
+    FakeGpu gpu;
+    Ring ring(1 << 20, FakeBuffers{ &gpu });
+
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < 4; ++worker)
+    {
+        workers.emplace_back([&ring, worker]() {
+            for (int i = 0; i < 50; ++i)
+                ring.submit(stage(ring, 8, 8, (uint8_t)worker), GL_TEXTURE_2D, (GLuint)worker + 1, 0, i, 0, false);
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    ring.endFrame();
+
+    ASSERT_EQ(200u, gpu.uploads.size());
+    for (size_t i = 0; i < gpu.uploads.size(); ++i)
+        EXPECT_EQ(std::vector<uint8_t>(64, (uint8_t)(gpu.uploads[i].texture - 1)), gpu.pixels[i]);
+    EXPECT_EQ(200u, ring.lastFrame().uploads);
+    EXPECT_EQ(200u * 64u, ring.lastFrame().bytes);
+}
+
+TEST(UploadRing, releasesItsFencesAndMemory)
+{
+    FakeGpu gpu;
+    {
+        Ring ring(4096, FakeBuffers{ &gpu });
+        ring.submit(stage(ring, 4, 4, 0), GL_TEXTURE_2D, 1, 0, 0, 0, false);
+        ring.endFrame();
+    }
+    EXPECT_EQ(1u, gpu.released);
+    EXPECT_TRUE(gpu.isDestroyed);
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <ray/math/LinearAlgebra.hpp>
+
+using namespace ray::math;
+
+TEST(Frustum, containsPointsInFrontOfThePerspectiveCamera)
+{
+    auto view = frustum(perspective(90_deg, 1.0f, 1.0f, 100.0f));
+    EXPECT_TRUE(view.contains(vec3(0.0f, 0.0f, -10.0f)));
+    EXPECT_TRUE(view.contains(vec3(9.0f, -9.0f, -10.0f)));
+    EXPECT_FALSE(view.contains(vec3(0.0f, 0.0f, 10.0f)));
+    EXPECT_FALSE(view.contains(vec3(0.0f, 0.0f, -0.5f)));
+    EXPECT_FALSE(view.contains(vec3(0.0f, 0.0f, -101.0f)));
+    EXPECT_FALSE(view.contains(vec3(11.0f, 0.0f, -10.0f)));
+}
+
+TEST(Frustum, planesAreNormalized)
+{
+    auto view = frustum(perspective(60_deg, 16.0f/9.0f, 0.1f, 50.0f));
+    for (size_t plane = 0; plane < frustum::PLANE_COUNT; ++plane)
+        EXPECT_NEAR(length(view.plane(plane).xyz), 1.0f, 1e-5f);
+}
+
+TEST(Frustum, spheresIntersectingAPlaneAreKept)
+{
+    auto view = frustum(perspective(90_deg, 1.0f, 1.0f, 100.0f));
+    EXPECT_FALSE(view.intersects(vec3(12.0f, 0.0f, -10.0f), 1.0f));
+    EXPECT_TRUE(view.intersects(vec3(12.0f, 0.0f, -10.0f), 2.0f));
+    EXPECT_TRUE(view.intersects(vec3(0.0f, 0.0f, -0.5f), 1.0f));
+    EXPECT_FALSE(view.intersects(vec3(0.0f, 0.0f, 0.5f), 1.0f));
+}
+
+TEST(Frustum, followsTheViewMatrix)
+{
+    auto view = lookAt(vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+    auto volume = frustum(perspective(90_deg, 1.0f, 1.0f, 100.0f) * view);
+    EXPECT_TRUE(volume.contains(vec3(10.0f, 0.0f, 0.0f)));
+    EXPECT_FALSE(volume.contains(vec3(-10.0f, 0.0f, 0.0f)));
+    EXPECT_FALSE(volume.contains(vec3(0.0f, 0.0f, -10.0f)));
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <ray/platform/Format.hpp>
+#include <boost/format.hpp>
+#include <sstream>
+#include <string>
+
+using namespace ray::platform;
+
+namespace
+{
+    struct Point
+    {
+        int x, y;
+    };
+
+    std::ostream &operator<<(std::ostream &out, const Point &point) { return out << "(" << point.x << "," << point.y << ")"; }
+
+    template<typename... Args>
+    std::string format(const char *format, const Args &... args)
+    {
+        std::string result;
+        formatTo(result, format, args...);
+        return result;
+    }
+
+    inline void boostHelper(boost::format &) {}
+
+    template<typename T, typename... Args>
+    void boostHelper(boost::format &formatter, const T &value, const Args &... args) { boostHelper(formatter % value, args...); }
+
+    template<typename... Args>
+    std::string boostFormat(const char *format, const Args &... args)
+    {
+        boost::format formatter(format);
+        boostHelper(formatter, args...);
+        return formatter.str();
+    }
+}
+
+TEST(Format, matchesBoostFormat)
+{
+    EXPECT_EQ(boostFormat("%d %i %u", 42, -7, 3u), format("%d %i %u", 42, -7, 3u));
+    EXPECT_EQ(boostFormat("[%5d] [%-5d] [%05d] [%+d]", 42, 42, -42, 42), format("[%5d] [%-5d] [%05d] [%+d]", 42, 42, -42, 42));
+    EXPECT_EQ(boostFormat("%x %X %08X %o", 255, 255, 10, 8), format("%x %X %08X %o", 255, 255, 10, 8));
+    EXPECT_EQ(boostFormat("%f %.2f %6.3f %07.4f %e", 1.5, 3.14159, 2.0f, 0.5f, 12345.678), format("%f %.2f %6.3f %07.4f %e", 1.5, 3.14159, 2.0f, 0.5f, 12345.678));
+    EXPECT_EQ(boostFormat("%s %s %d", 3.2f, 1e20, 0.1), format("%s %s %d", 3.2f, 1e20, 0.1));
+    EXPECT_EQ(boostFormat("%s|%10s|%-10s|%.3s", "text", "right", "left", std::string("truncated")), format("%s|%10s|%-10s|%.3s", "text", "right", "left", std::string("truncated")));
+    EXPECT_EQ(boostFormat("%s %d %c", 'a', true, 'z'), format("%s %d %c", 'a', true, 'z'));
+    EXPECT_EQ(boostFormat("%2% %1% %2%", "first", "second"), format("%2% %1% %2%", "first", "second"));
+    EXPECT_EQ(boostFormat("%2$s %1$5d", 12, "x"), format("%2$s %1$5d", 12, "x"));
+    EXPECT_EQ(boostFormat("100%% %|5| %s", 1, Point{ 1, 2 }), format("100%% %|5| %s", 1, Point{ 1, 2 }));
+    EXPECT_EQ(boostFormat("%ld %lld %zu", 1L, -2LL, (size_t)3), format("%ld %lld %zu", 1L, -2LL, (size_t)3));
+    EXPECT_EQ(boostFormat("%d", INT64_MIN), format("%d", INT64_MIN));
+}
+
+TEST(Format, truncatesFixedBuffersLikeSnprintf)
+{
+    char buffer[8];
+    EXPECT_EQ(11u, formatTo(buffer, sizeof(buffer), "hello %s", "world"));
+    EXPECT_STREQ("hello w", buffer);
+    EXPECT_EQ(5u, formatTo(nullptr, 0, "%d", 12345));
+
+    FormatBuffer<16> text("%6.3fmsec", 16.6667);
+    EXPECT_STREQ("16.667msec", text.c_str());
+    EXPECT_EQ(10u, text.size());
+    EXPECT_FALSE(text.isTruncated());
+    EXPECT_STREQ("0123456789abcde", text.format("%s", "0123456789abcdefghij"));
+    EXPECT_TRUE(text.isTruncated());
+    EXPECT_EQ(15u, text.size());
+}
+
+TEST(Format, writesLongTextToStreamsAndStrings)
+{
+    auto longText = std::string(1000, 'x');
+    std::ostringstream out;
+    formatTo(out, "<%s|%600d>", longText, 1);
+    EXPECT_EQ("<" + longText + "|" + std::string(599, ' ') + "1>", out.str());
+
+    std::string result;
+    formatTo(result, "<%s|%600d>", longText, 1);
+    EXPECT_EQ(out.str(), result);
+}
+
+TEST(Format, printsBytesAsCharactersLikeBoost)
+{
+    EXPECT_EQ(boostFormat("%c %s", (uint8_t)'a', (int8_t)'b'), format("%c %s", (uint8_t)'a', (int8_t)'b'));
+    EXPECT_EQ(boostFormat("%2%%1%", (uint8_t)'a', (int8_t)'b'), format("%2%%1%", (uint8_t)'a', (int8_t)'b'));
+    EXPECT_EQ("97 62", format("%d %x", (uint8_t)'a', (int8_t)'b'));
+}
+
+TEST(Format, keepsInvalidDirectivesVerbatim)
+{
+    EXPECT_EQ("100%!", format("100%!"));
+}
+
+#ifndef NDEBUG
+TEST(FormatDeathTest, abortsOnArgumentCountMismatch)
+{
+    EXPECT_DEATH(format("a=%d b=%d", 1), "expects 2 arguments, got 1");
+    EXPECT_DEATH(format("%d", 1, 2), "expects 1 arguments, got 2");
+    EXPECT_DEATH(format("%2%", 1, 2, 3), "expects 2 arguments, got 3");
+}
+#else
+TEST(Format, leavesMissingArgumentsOutAndIgnoresExtraOnes)
+{
+    EXPECT_EQ("a=1 b=", format("a=%d b=%d", 1));
+    EXPECT_EQ("1", format("%d", 1, 2));
+}
+#endif
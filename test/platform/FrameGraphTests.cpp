@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <ray/platform/FrameGraph.hpp>
+#include <atomic>
+#include <vector>
+
+using namespace ray::platform;
+
+TEST(FrameGraph, internsResources)
+{
+    FrameGraph graph;
+    auto transforms = graph.resource("transforms");
+    EXPECT_EQ(transforms, graph.resource("transforms"));
+    EXPECT_NE(transforms, graph.resource("camera"));
+}
+
+TEST(FrameGraph, derivesDependenciesFromReadsAndWrites)
+{
+    FrameGraph graph;
+    auto transforms = graph.resource("transforms"), camera = graph.resource("camera"), visible = graph.resource("visible");
+
+    auto animate = graph.addTask("animate", []() {}).writes(transforms).id();
+    auto look    = graph.addTask("look", []() {}).writes(camera).id();
+    auto cull    = graph.addTask("cull", []() {}).reads(transforms).reads(camera).writes(visible).id();
+    auto physics = graph.addTask("physics", []() {}).writes(transforms).id();
+
+    EXPECT_TRUE(graph.dependencies(animate).empty());
+    EXPECT_TRUE(graph.dependencies(look).empty());
+    EXPECT_EQ((std::vector<FrameGraph::TaskId>{ animate, look }), graph.dependencies(cull));
+    // physics overwrites what cull reads, so it has to wait for it too
+    EXPECT_EQ((std::vector<FrameGraph::TaskId>{ animate, cull }), graph.dependencies(physics));
+}
+
+TEST(FrameGraph, runsTasksAfterTheirDependencies)
+{
+    JobSystem jobs(4);
+    FrameGraph graph;
+    auto a = graph.resource("a"), b = graph.resource("b");
+    std::atomic<int> step(0);
+    int first = -1, second = -1, third = -1;
+
+    graph.addTask("first", [&]() { first = step++; }).writes(a);
+    graph.addTask("second", [&]() { second = step++; }).reads(a).writes(b);
+    graph.addTask("third", [&]() { third = step++; }).reads(b);
+
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        step = 0;
+        graph.execute(jobs);
+        EXPECT_TRUE(graph.isDone());
+        EXPECT_EQ(0, first);
+        EXPECT_EQ(1, second);
+        EXPECT_EQ(2, third);
+    }
+}
+
+TEST(FrameGraph, runsMainThreadTasksOnTheMainThread)
+{
+    JobSystem jobs(2);
+    FrameGraph graph;
+    auto data = graph.resource("data");
+    std::atomic<bool> onMainThread(false);
+
+    graph.addTask("produce", []() {}).writes(data);
+    graph.addTask("upload", [&]() { onMainThread = jobs.isMainThread(); }).reads(data).onMainThread();
+    graph.execute(jobs);
+
+    EXPECT_TRUE(onMainThread.load());
+}
+
+TEST(Snapshot, readsWhatWasPublished)
+{
+    FrameGraph graph;
+    Snapshot<int> snapshot(0);
+    graph.addSnapshot(snapshot);
+
+    snapshot.write() = 1;
+    EXPECT_EQ(0, snapshot.read());
+    graph.publish();
+    EXPECT_EQ(1, snapshot.read());
+
+    snapshot.write() = 2;
+    EXPECT_EQ(1, snapshot.read());
+    graph.publish();
+    EXPECT_EQ(2, snapshot.read());
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <ray/platform/FixedTimestep.hpp>
+#include <ray/platform/FramePacer.hpp>
+#include <ray/platform/FrameStatistics.hpp>
+#include <ray/platform/Stopwatch.hpp>
+
+using namespace ray::platform;
+
+TEST(FrameStatistics, averagesTheLastSamples)
+{
+    FrameStatistics statistics(4);
+    EXPECT_EQ(0.0, statistics.average().count());
+
+    for (int i = 1; i <= 6; ++i)
+        statistics.add(sec(i));
+
+    EXPECT_EQ(4u, statistics.count());
+    EXPECT_DOUBLE_EQ(4.5, statistics.average().count());
+    EXPECT_DOUBLE_EQ(6.0, statistics.maximum().count());
+}
+
+TEST(FrameStatistics, computesNearestRankPercentiles)
+{
+    FrameStatistics statistics(100);
+    for (int i = 100; i >= 1; --i)
+        statistics.add(sec(i));
+
+    EXPECT_DOUBLE_EQ(50.0, statistics.p50().count());
+    EXPECT_DOUBLE_EQ(95.0, statistics.p95().count());
+    EXPECT_DOUBLE_EQ(99.0, statistics.p99().count());
+    EXPECT_DOUBLE_EQ(1.0, statistics.percentile(0.0).count());
+    EXPECT_DOUBLE_EQ(100.0, statistics.percentile(1.0).count());
+}
+
+TEST(FixedTimestep, stepsAndKeepsTheRemainder)
+{
+    FixedTimestep timestep(sec(0.01));
+    int updates = 0;
+    auto update = [&](sec step) { ++updates; EXPECT_DOUBLE_EQ(0.01, step.count()); };
+
+    EXPECT_EQ(0u, timestep.advance(sec(0.005), update));
+    EXPECT_NEAR(0.5f, timestep.alpha(), 1e-5f);
+    EXPECT_EQ(2u, timestep.advance(sec(0.0175), update));
+    EXPECT_NEAR(0.25f, timestep.alpha(), 1e-5f);
+    EXPECT_EQ(2, updates);
+}
+
+TEST(FixedTimestep, dropsTimeBeyondTheMaximumSteps)
+{
+    FixedTimestep timestep(sec(0.01), 4);
+    int updates = 0;
+
+    EXPECT_EQ(4u, timestep.advance(sec(1.0), [&](sec) { ++updates; }));
+    EXPECT_EQ(0.0f, timestep.alpha());
+    EXPECT_EQ(0u, timestep.advance(sec(0.001), [&](sec) { ++updates; }));
+    EXPECT_EQ(4, updates);
+}
+
+TEST(FramePacer, waitsForTheWholePeriod)
+{
+    FramePacer pacer(sec(0.005));
+    Stopwatch stopwatch;
+    pacer.wait();
+    stopwatch.lap();
+    for (int frame = 0; frame < 10; ++frame)
+        pacer.wait();
+
+    auto elapsed = stopwatch.lap();
+    EXPECT_GE(elapsed.count(), 0.05 - 1e-4);
+    EXPECT_GT(pacer.spinThreshold().count(), 0.0);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <ray/platform/JobSystem.hpp>
+#include <atomic>
+#include <algorithm>
+#include <vector>
+
+using namespace ray::platform;
+
+TEST(JobSystem, runsEverySubmittedJob)
+{
+    JobSystem jobs(4);
+    JobSystem::Counter counter;
+    std::atomic<int> sum(0);
+
+    for (int i = 1; i <= 1000; ++i)
+        jobs.submit([&sum, i]() { sum += i; }, &counter);
+    jobs.wait(counter);
+
+    EXPECT_TRUE(counter.isDone());
+    EXPECT_EQ(500500, sum.load());
+}
+
+TEST(JobSystem, parallelForCoversTheRangeOnce)
+{
+    JobSystem jobs(3);
+    std::vector<int> visits(10007, 0);
+
+    jobs.parallelFor(0, visits.size(), 64, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i)
+            visits[i] += 1;
+    });
+
+    EXPECT_EQ(visits.size(), (size_t)std::count(visits.begin(), visits.end(), 1));
+}
+
+TEST(JobSystem, parallelForHandlesSmallRanges)
+{
+    JobSystem jobs(2);
+    size_t calls = 0;
+    jobs.parallelFor(5, 5, 16, [&](size_t, size_t) { ++calls; });
+    EXPECT_EQ(0u, calls);
+    jobs.parallelFor(0, 10, 16, [&](size_t first, size_t last) { ++calls; EXPECT_EQ(0u, first); EXPECT_EQ(10u, last); });
+    EXPECT_EQ(1u, calls);
+}
+
+TEST(JobSystem, nestedWaitsDoNotDeadlock)
+{
+    JobSystem jobs(1);
+    JobSystem::Counter outer;
+    std::atomic<int> leaves(0);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        jobs.submit([&]() {
+            JobSystem::Counter inner;
+            for (int j = 0; j < 8; ++j)
+                jobs.submit([&]() { ++leaves; }, &inner);
+            jobs.wait(inner);
+        }, &outer);
+    }
+    jobs.wait(outer);
+
+    EXPECT_EQ(64, leaves.load());
+}
+
+TEST(JobSystem, dependentJobsRunAfterTheirDependency)
+{
+    JobSystem jobs(4);
+    JobSystem::Counter first, second;
+    std::atomic<int> finished(0);
+    std::atomic<bool> sawAllFirst(true);
+
+    for (int i = 0; i < 16; ++i)
+        jobs.submit([&]() { std::this_thread::sleep_for(std::chrono::microseconds(100)); ++finished; }, &first);
+    for (int i = 0; i < 4; ++i)
+        jobs.submitAfter(first, [&]() { if (finished.load() != 16) sawAllFirst = false; }, &second);
+    jobs.wait(second);
+
+    EXPECT_TRUE(first.isDone());
+    EXPECT_TRUE(sawAllFirst.load());
+}
+
+TEST(JobSystem, mainThreadJobsRunOnTheMainThread)
+{
+    JobSystem jobs(2);
+    JobSystem::Counter counter;
+    std::atomic<bool> onMainThread(false);
+
+    jobs.submit([&]() {
+        jobs.submitToMainThread([&]() { onMainThread = jobs.isMainThread(); }, &counter);
+    }, &counter);
+    jobs.wait(counter);
+
+    EXPECT_TRUE(onMainThread.load());
+    EXPECT_EQ(0u, jobs.runMainThreadJobs());
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <ray/platform/AsyncRead.hpp>
+#include <ray/platform/MappedFile.hpp>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <vector>
+
+using namespace ray::platform;
+
+namespace
+{
+    std::string temporaryFile(const std::string &name, const std::string &content)
+    {
+        auto filename = ::testing::TempDir() + name;
+        std::ofstream file(filename, std::ios::binary);
+        file.write(content.data(), (std::streamsize)content.size());
+        return filename;
+    }
+
+    std::string text(const fs::FileData &data) { return std::string(reinterpret_cast<const char *>(data.data()), data.size()); }
+}
+
+TEST(MappedFile, mapsTheWholeFile)
+{
+    auto content = std::string(10000, 'x') + "end";
+    auto filename = temporaryFile("mapped.bin", content);
+
+    fs::MappedFile file(filename, fs::Access::Sequential);
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(content.size(), file.size());
+    EXPECT_EQ(content, std::string(reinterpret_cast<const char *>(file.data()), file.size()));
+    file.advise(fs::Access::Random, 4096, 100);
+
+    auto moved = std::move(file);
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(nullptr, file.data());
+    EXPECT_TRUE(moved.isOpen());
+    EXPECT_EQ('e', moved.data()[10000]);
+    std::remove(filename.c_str());
+}
+
+TEST(MappedFile, handlesEmptyAndMissingFiles)
+{
+    auto filename = temporaryFile("empty.bin", "");
+    fs::MappedFile empty;
+    EXPECT_TRUE(empty.open(filename));
+    EXPECT_EQ(0u, empty.size());
+    std::remove(filename.c_str());
+
+    fs::MappedFile missing;
+    std::string error;
+    EXPECT_FALSE(missing.open(filename, fs::Access::Normal, &error));
+    EXPECT_FALSE(error.empty());
+
+    auto data = fs::mapFile(filename);
+    EXPECT_FALSE(data.isValid());
+    EXPECT_NE(std::string::npos, data.error().find("empty.bin"));
+}
+
+TEST(FileData, isEitherMappedOrOwned)
+{
+    auto filename = temporaryFile("data.txt", "some bytes");
+    auto mapped = fs::mapFile(filename);
+    auto owned = fs::readFile(filename);
+    std::remove(filename.c_str());
+
+    ASSERT_TRUE(mapped.isValid());
+    ASSERT_TRUE(owned.isValid());
+    EXPECT_TRUE(mapped.isMapped());
+    EXPECT_FALSE(owned.isMapped());
+    EXPECT_EQ("some bytes", text(mapped));
+    EXPECT_EQ("some bytes", text(owned));
+}
+
+TEST(MemoryStreambuf, readsLinesInPlace)
+{
+    std::string content = "v 1 2 3\nf 1 2 3\n";
+    fs::MemoryStreambuf buffer(reinterpret_cast<const uint8_t *>(content.data()), content.size());
+    std::istream stream(&buffer);
+
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(stream, line))
+        lines.push_back(line);
+    EXPECT_EQ((std::vector<std::string>{ "v 1 2 3", "f 1 2 3" }), lines);
+}
+
+TEST(AsyncRead, readsFilesOnTheJobSystem)
+{
+    JobSystem jobs(2);
+    std::vector<std::string> filenames;
+    std::vector<fs::AsyncRead> reads;
+    for (int i = 0; i < 8; ++i)
+    {
+        filenames.push_back(temporaryFile("async" + std::to_string(i) + ".txt", std::string(5000 * i, 'a' + i)));
+        reads.push_back(fs::readAsync(jobs, filenames.back(), i % 2 ? fs::ReadMode::Copy : fs::ReadMode::Map));
+    }
+    reads.push_back(fs::readAsync(jobs, ::testing::TempDir() + "missing.txt"));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        auto data = std::move(reads[i].wait(jobs));
+        EXPECT_TRUE(reads[i].isDone());
+        ASSERT_TRUE(data.isValid());
+        EXPECT_EQ(i % 2 == 0, data.isMapped());
+        EXPECT_EQ(std::string(5000 * i, 'a' + i), text(data));
+        std::remove(filenames[i].c_str());
+    }
+    EXPECT_FALSE(reads.back().wait(jobs).isValid());
+}
@@ -0,0 +1,116 @@
+#include <ray/platform/OffsetAllocator.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace ray::platform;
+
+TEST(OffsetAllocator, allocatesContiguousRanges)
+{
+    auto allocator = OffsetAllocator(1024);
+    auto a = allocator.allocate(100);
+    auto b = allocator.allocate(200);
+    auto c = allocator.allocate(300);
+
+    EXPECT_EQ(a.offset, 0u);
+    EXPECT_EQ(b.offset, 100u);
+    EXPECT_EQ(c.offset, 300u);
+    EXPECT_EQ(allocator.sizeOf(b), 200u);
+    EXPECT_EQ(allocator.statistics().usedSpace, 600u);
+    EXPECT_EQ(allocator.statistics().allocationCount, 3u);
+}
+
+TEST(OffsetAllocator, failsWhenThereIsNoRoomLeft)
+{
+    auto allocator = OffsetAllocator(256);
+    EXPECT_TRUE(allocator.allocate(256).isValid());
+    EXPECT_FALSE(allocator.allocate(1).isValid());
+}
+
+TEST(OffsetAllocator, coalescesFreedNeighbours)
+{
+    auto allocator = OffsetAllocator(1000);
+    auto a = allocator.allocate(100);
+    auto b = allocator.allocate(100);
+    auto c = allocator.allocate(100);
+    auto d = allocator.allocate(700);
+    EXPECT_FALSE(allocator.allocate(200).isValid());
+
+    allocator.free(a);
+    allocator.free(c);
+    EXPECT_EQ(allocator.statistics().freeRegionCount, 2u);
+    EXPECT_FALSE(allocator.allocate(300).isValid());
+
+    allocator.free(b);
+    EXPECT_EQ(allocator.statistics().freeRegionCount, 1u);
+    EXPECT_EQ(allocator.statistics().largestFreeRegion, 300u);
+
+    auto e = allocator.allocate(300);
+    EXPECT_TRUE(e.isValid());
+    EXPECT_EQ(e.offset, 0u);
+
+    allocator.free(d);
+    allocator.free(e);
+    auto statistics = allocator.statistics();
+    EXPECT_EQ(statistics.freeSpace, 1000u);
+    EXPECT_EQ(statistics.largestFreeRegion, 1000u);
+    EXPECT_EQ(statistics.fragmentation(), 0.0f);
+}
+
+TEST(OffsetAllocator, reportsFragmentation)
+{
+    auto allocator = OffsetAllocator(400);
+    std::vector<OffsetAllocator::Allocation> allocations;
+    for (int i = 0; i < 4; ++i)
+        allocations.push_back(allocator.allocate(100));
+    allocator.free(allocations[0]);
+    allocator.free(allocations[2]);
+
+    auto statistics = allocator.statistics();
+    EXPECT_EQ(statistics.freeSpace, 200u);
+    EXPECT_EQ(statistics.largestFreeRegion, 100u);
+    EXPECT_FLOAT_EQ(statistics.fragmentation(), 0.5f);
+}
+
+TEST(OffsetAllocator, randomAllocationsNeverOverlap)
+{
+    auto random = std::mt19937(7);
+    auto allocator = OffsetAllocator(1 << 20);
+    std::vector<std::pair<OffsetAllocator::Allocation, uint32_t>> live;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        if (!live.empty() && random() % 3 == 0)
+        {
+            auto index = random() % live.size();
+            allocator.free(live[index].first);
+            live.erase(live.begin() + index);
+        }
+        else
+        {
+            auto size = 1 + random() % 4096;
+            auto allocation = allocator.allocate(size);
+            if (allocation.isValid())
+                live.emplace_back(allocation, size);
+        }
+    }
+
+    std::sort(live.begin(), live.end(), [](auto &a, auto &b) { return a.first.offset < b.first.offset; });
+    uint32_t used = 0;
+    for (size_t i = 0; i < live.size(); ++i)
+    {
+        used += live[i].second;
+        EXPECT_LE(live[i].first.offset + live[i].second, 1u << 20);
+        if (i > 0)
+        {
+            EXPECT_GE(live[i].first.offset, live[i-1].first.offset + live[i-1].second);
+        }
+    }
+    EXPECT_EQ(allocator.statistics().usedSpace, used);
+
+    for (auto &allocation : live)
+        allocator.free(allocation.first);
+    EXPECT_EQ(allocator.statistics().largestFreeRegion, 1u << 20);
+    EXPECT_EQ(allocator.statistics().freeRegionCount, 1u);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <ray/platform/FileSystem.hpp>
+#include <ray/platform/Lz4.hpp>
+#include <ray/platform/Pack.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ray::platform;
+
+namespace
+{
+    std::vector<uint8_t> bytes(const std::string &text) { return std::vector<uint8_t>(text.begin(), text.end()); }
+    std::string text(const fs::FileData &data) { return std::string(reinterpret_cast<const char *>(data.data()), data.size()); }
+
+    std::vector<uint8_t> roundTrip(const std::vector<uint8_t> &source)
+    {
+        auto compressed = lz4::compress(source.data(), source.size());
+        std::vector<uint8_t> result(source.size());
+        EXPECT_FALSE(compressed.empty());
+        EXPECT_TRUE(lz4::decompress(compressed.data(), compressed.size(), result.data(), result.size()));
+        return result;
+    }
+
+    std::string temporaryPath(const std::string &name) { return ::testing::TempDir() + name; }
+}
+
+TEST(Lz4, roundTripsAnyInput)
+{
+    std::mt19937 random(42);
+    std::vector<uint8_t> noise(100000), runs(100000), text;
+    for (auto &byte : noise)
+        byte = (uint8_t)random();
+    for (size_t i = 0; i < runs.size(); ++i)
+        runs[i] = (uint8_t)(i / 1000);
+    for (int i = 0; i < 2000; ++i)
+        text.insert(text.end(), { 'v', ' ', (uint8_t)('0' + i % 10), '.', '5', '\n' });
+
+    EXPECT_EQ(std::vector<uint8_t>(), roundTrip({}));
+    EXPECT_EQ(bytes("short"), roundTrip(bytes("short")));
+    EXPECT_EQ(noise, roundTrip(noise));
+    EXPECT_EQ(runs, roundTrip(runs));
+    EXPECT_EQ(text, roundTrip(text));
+    EXPECT_LT(lz4::compress(runs.data(), runs.size()).size(), runs.size() / 50);
+    EXPECT_LE(lz4::compress(noise.data(), noise.size()).size(), lz4::compressBound(noise.size()));
+}
+
+TEST(Lz4, rejectsCorruptedBlocks)
+{
+    auto source = std::vector<uint8_t>(1000, 'a');
+    auto compressed = lz4::compress(source.data(), source.size());
+    std::vector<uint8_t> result(source.size());
+
+    EXPECT_FALSE(lz4::decompress(compressed.data(), compressed.size() - 1, result.data(), result.size()));
+    EXPECT_FALSE(lz4::decompress(compressed.data(), compressed.size(), result.data(), result.size() - 1));
+    compressed[2] = 0xFF;
+    EXPECT_FALSE(lz4::decompress(compressed.data(), compressed.size(), result.data(), result.size()));
+}
+
+TEST(Pack, findsEntriesByPath)
+{
+    auto filename = temporaryPath("find.pack");
+    auto compressible = std::string(5000, 'z');
+    fs::PackWriter writer;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto content = "file " + std::to_string(i);
+        writer.add("dir/file" + std::to_string(i) + ".txt", reinterpret_cast<const uint8_t *>(content.data()), content.size());
+    }
+    writer.add("compressible.bin", reinterpret_cast<const uint8_t *>(compressible.data()), compressible.size());
+    writer.add("dir/file7.txt", reinterpret_cast<const uint8_t *>("replaced"), 8);
+    ASSERT_TRUE(writer.write(filename));
+    EXPECT_EQ(101u, writer.entryCount());
+
+    fs::PackFile pack;
+    ASSERT_TRUE(pack.open(filename));
+    EXPECT_EQ(101u, pack.entryCount());
+    for (int i = 0; i < 100; ++i)
+    {
+        auto entry = pack.find("./dir\\file" + std::to_string(i) + ".txt");
+        ASSERT_NE(nullptr, entry);
+        EXPECT_EQ(0u, entry->offset % fs::pack::DATA_ALIGNMENT);
+        EXPECT_EQ(fs::Compression::None, entry->compression);
+        EXPECT_EQ(i == 7 ? "replaced" : "file " + std::to_string(i), text(pack.read(*entry)));
+        EXPECT_TRUE(pack.verify(*entry));
+    }
+    EXPECT_EQ(nullptr, pack.find("dir/file100.txt"));
+
+    auto entry = pack.find("compressible.bin");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(fs::Compression::Lz4, entry->compression);
+    EXPECT_LT(entry->storedSize, entry->size);
+    auto data = pack.read(*entry);
+    EXPECT_FALSE(data.isBorrowed());
+    EXPECT_EQ(compressible, text(data));
+    std::remove(filename.c_str());
+}
+
+TEST(Pack, refusesFilesThatArentPacks)
+{
+    auto filename = temporaryPath("notapack.pack");
+    std::ofstream(filename) << std::string(100, 'x');
+
+    fs::PackFile pack;
+    std::string error;
+    EXPECT_FALSE(pack.open(filename, &error));
+    EXPECT_NE(std::string::npos, error.find("not a pack"));
+    EXPECT_EQ(nullptr, pack.find("anything"));
+    std::remove(filename.c_str());
+}
+
+TEST(Pack, refusesCorruptedHeadersAndSizes)
+{
+    auto filename = temporaryPath("corrupted.pack");
+    auto compressible = std::string(5000, 'z');
+    fs::PackWriter writer;
+    writer.add("compressible.bin", reinterpret_cast<const uint8_t *>(compressible.data()), compressible.size());
+    ASSERT_TRUE(writer.write(filename));
+
+    std::vector<char> original;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        original.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto header = *reinterpret_cast<const fs::pack::Header *>(original.data());
+    auto expectRefused = [&](const std::vector<char> &content, const char *reason) {
+        std::ofstream(filename, std::ios::binary).write(content.data(), (std::streamsize)content.size());
+        fs::PackFile pack;
+        std::string error;
+        EXPECT_FALSE(pack.open(filename, &error));
+        EXPECT_NE(std::string::npos, error.find(reason)) << error;
+    };
+
+    auto misaligned = original;
+    reinterpret_cast<fs::pack::Header *>(misaligned.data())->indexOffset += 2;
+    expectRefused(misaligned, "misaligned index");
+
+    auto huge = original;
+    reinterpret_cast<fs::pack::Entry *>(huge.data() + header.tocOffset)->size = UINT64_C(1) << 50;
+    expectRefused(huge, "implausible size");
+    std::remove(filename.c_str());
+}
+
+TEST(Pack, isSearchedBeforeTheDisk)
+{
+    auto packFilename = temporaryPath("mounted.pack");
+    auto diskFilename = temporaryPath("res/disk.txt");
+    fs::createDirectories(temporaryPath("res"));
+    std::ofstream(diskFilename) << "from the disk";
+
+    fs::PackWriter writer;
+    writer.add("packed.txt", reinterpret_cast<const uint8_t *>("from the pack"), 13, fs::Compression::None);
+    ASSERT_TRUE(writer.write(packFilename));
+
+    ASSERT_TRUE(fs::mount(packFilename, temporaryPath("res/")));
+    EXPECT_TRUE(fs::isPacked(temporaryPath("res/packed.txt")));
+    EXPECT_FALSE(fs::isPacked(temporaryPath("res/disk.txt")));
+
+    auto packed = fs::load(temporaryPath("res/packed.txt"));
+    EXPECT_TRUE(packed.isBorrowed());
+    EXPECT_EQ("from the pack", text(packed));
+    EXPECT_EQ("from the disk", text(fs::load(diskFilename)));
+
+    fs::unmount(packFilename);
+    EXPECT_FALSE(fs::load(temporaryPath("res/packed.txt")).isValid());
+    std::remove(packFilename.c_str());
+    std::remove(diskFilename.c_str());
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <ray/platform/Profiler.hpp>
+#include <ray/platform/TimedBlock.hpp>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace ray::platform;
+
+namespace
+{
+    const Profiler::ZoneStatistics *find(const char *name)
+    {
+        for (auto &zone : Profiler::instance().lastFrame())
+            if (std::string(zone.name) == name)
+                return &zone;
+        return nullptr;
+    }
+
+    void sleep(int msec)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(msec));
+    }
+}
+
+TEST(Profiler, aggregatesTheZonesOfAFrame)
+{
+    auto &profiler = Profiler::instance();
+    profiler.endFrame();
+
+    for (int i = 0; i < 3; ++i)
+        ProfileZone zone("aggregated");
+    profiler.endFrame();
+
+    auto zone = find("aggregated");
+    ASSERT_NE(nullptr, zone);
+    EXPECT_EQ(3u, zone->calls);
+    EXPECT_LE(zone->maximum, zone->inclusive);
+
+    profiler.endFrame();
+    EXPECT_EQ(nullptr, find("aggregated"));
+}
+
+TEST(Profiler, subtractsChildrenFromSelfTime)
+{
+    auto &profiler = Profiler::instance();
+    profiler.endFrame();
+    {
+        ProfileZone parent("parent");
+        sleep(2);
+        {
+            ProfileZone child("child");
+            sleep(10);
+        }
+    }
+    profiler.endFrame();
+
+    auto parent = find("parent"), child = find("child");
+    ASSERT_NE(nullptr, parent);
+    ASSERT_NE(nullptr, child);
+    EXPECT_GE(parent->inclusive, child->inclusive);
+    EXPECT_EQ(parent->inclusive - child->inclusive, parent->exclusive);
+    EXPECT_EQ(child->inclusive, child->exclusive);
+    EXPECT_GE(child->inclusive, 10000000u);
+}
+
+TEST(Profiler, collectsZonesFromEveryThread)
+{
+    auto &profiler = Profiler::instance();
+    profiler.endFrame();
+
+    std::thread first([]() { for (int i = 0; i < 100; ++i) ProfileZone zone("threaded"); });
+    std::thread second([]() { for (int i = 0; i < 100; ++i) ProfileZone zone("threaded"); });
+    first.join();
+    second.join();
+    profiler.endFrame();
+
+    auto zone = find("threaded");
+    ASSERT_NE(nullptr, zone);
+    EXPECT_EQ(200u, zone->calls);
+}
+
+TEST(Profiler, writesAChromeTrace)
+{
+    auto &profiler = Profiler::instance();
+    profiler.endFrame();
+    profiler.clearTrace();
+    {
+        ProfileZone zone("quoted \"zone\"");
+    }
+    profiler.endFrame();
+
+    std::ostringstream out;
+    profiler.writeChromeTrace(out);
+    auto trace = out.str();
+    EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"quoted \\\"zone\\\"\",\"ph\":\"X\",\"ts\":0,"));
+    EXPECT_NE(std::string::npos, trace.find("\"pid\":0,\"tid\":"));
+}
+
+TEST(Profiler, keepsTheMostRecentZonesForTheTrace)
+{
+    auto &profiler = Profiler::instance();
+    profiler.endFrame();
+    profiler.clearTrace();
+    profiler.setTraceCapacity(2);
+
+    { ProfileZone zone("oldest"); }
+    { ProfileZone zone("older"); }
+    { ProfileZone zone("newest"); }
+    profiler.endFrame();
+    profiler.setTraceCapacity(1 << 16);
+
+    std::ostringstream out;
+    profiler.writeChromeTrace(out);
+    EXPECT_EQ(std::string::npos, out.str().find("oldest"));
+    EXPECT_NE(std::string::npos, out.str().find("newest"));
+}
+
+#if RAY_ENABLE_PROFILER
+TEST(Profiler, recordsTimedBlocks)
+{
+    auto &profiler = Profiler::instance();
+    profiler.endFrame();
+    {
+        TIMED_BLOCK("timed block");
+        PROFILE_ZONE("nested zone");
+    }
+    profiler.endFrame();
+
+    ASSERT_NE(nullptr, find("timed block"));
+    ASSERT_NE(nullptr, find("nested zone"));
+    EXPECT_EQ(find("nested zone")->inclusive, find("nested zone")->exclusive);
+}
+#endif
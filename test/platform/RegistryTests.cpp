@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <ray/platform/Registry.hpp>
+#include <string>
+
+using namespace ray::platform;
+
+namespace {
+
+    struct Resource
+    {
+        std::string source;
+        size_t size;
+    };
+
+    Registry<Resource> makeRegistry()
+    {
+        return Registry<Resource>([](const Resource &resource) { return resource.size; });
+    }
+}
+
+TEST(Registry, loadsEachSourceOnce)
+{
+    auto registry = makeRegistry();
+    auto loads = 0;
+    auto load = [&]() { ++loads; return Resource{ "teapot.obj", 100 }; };
+
+    auto first = registry.acquire("teapot.obj", load);
+    auto second = registry.acquire("teapot.obj", load);
+    auto other = registry.acquire("bunny.obj", [&]() { ++loads; return Resource{ "bunny.obj", 50 }; });
+
+    EXPECT_EQ(2, loads);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_NE(first.get(), other.get());
+
+    auto statistics = registry.statistics();
+    EXPECT_EQ(3u, statistics.requests);
+    EXPECT_EQ(2u, statistics.loads);
+    EXPECT_EQ(1u, statistics.hits);
+    EXPECT_EQ(2u, statistics.liveResources);
+    EXPECT_EQ(150u, statistics.liveBytes);
+    EXPECT_EQ(100u, statistics.savedBytes);
+}
+
+TEST(Registry, releasesWithTheLastUser)
+{
+    auto registry = makeRegistry();
+    auto loads = 0;
+    auto load = [&]() { ++loads; return Resource{ "cube", 10 }; };
+
+    {
+        auto first = registry.acquire("cube", load);
+        auto second = registry.acquire("cube", load);
+        EXPECT_EQ(1u, registry.statistics().liveResources);
+    }
+    EXPECT_EQ(0u, registry.statistics().liveResources);
+    EXPECT_EQ(0u, registry.statistics().liveBytes);
+
+    auto third = registry.acquire("cube", load);
+    EXPECT_EQ(2, loads);
+    EXPECT_EQ("cube", third->source);
+}
+
+TEST(Registry, keysContentByHash)
+{
+    const float a[] = { 1.0f, 2.0f, 3.0f };
+    const float b[] = { 1.0f, 2.0f, 3.0f };
+    const float c[] = { 1.0f, 2.0f, 4.0f };
+
+    EXPECT_EQ(Registry<Resource>::key(a, sizeof(a)), Registry<Resource>::key(b, sizeof(b)));
+    EXPECT_NE(Registry<Resource>::key(a, sizeof(a)), Registry<Resource>::key(c, sizeof(c)));
+    EXPECT_NE(Registry<Resource>::key(a, sizeof(a)), Registry<Resource>::key(a, sizeof(a), Registry<Resource>::key("seed")));
+}
+
+TEST(Registry, purgesExpiredEntries)
+{
+    auto registry = makeRegistry();
+    auto kept = registry.acquire("kept", []() { return Resource{ "kept", 1 }; });
+    registry.acquire("dropped", []() { return Resource{ "dropped", 1 }; });
+
+    registry.purge();
+    auto loads = 0;
+    auto again = registry.acquire("kept", [&]() { ++loads; return Resource{ "kept", 1 }; });
+    EXPECT_EQ(0, loads);
+    EXPECT_EQ(1u, registry.statistics().liveResources);
+}
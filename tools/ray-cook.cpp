@@ -0,0 +1,293 @@
+#include <ray/assets/Bitmap.hpp>
+#include <ray/assets/Cooked.hpp>
+#include <ray/assets/Font.hpp>
+#include <ray/assets/Wavefront.hpp>
+#include <ray/platform/FileSystem.hpp>
+#include <ray/platform/Hash.hpp>
+#include <ray/platform/JobSystem.hpp>
+#include <ray/platform/Pack.hpp>
+#include <ray/platform/Panic.hpp>
+#include <ray/platform/Print.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ray;
+using namespace ray::platform;
+
+namespace
+{
+    const char *MANIFEST = "cook.manifest";
+
+    int usage()
+    {
+        fprintln(std::cerr, "usage: ray-cook [--force] [--verbose] [--no-mips] [--compress] [--font-sizes 30,50] <source directory> <output directory>");
+        fprintln(std::cerr, "  cooks the textures, meshes and fonts under <source directory>, by their path relative to it,");
+        fprintln(std::cerr, "  skipping the ones whose sources and settings didn't change since the last run");
+        fprintln(std::cerr, "  --force       cooks everything again");
+        fprintln(std::cerr, "  --verbose     prints every artifact");
+        fprintln(std::cerr, "  --no-mips     doesn't build the textures mip chains");
+        fprintln(std::cerr, "  --compress    stores the textures as BC1, BC3, BC4 or BC5 blocks, depending on their channels");
+        fprintln(std::cerr, "  --font-sizes  the line heights to bake glyph atlases at");
+        return EXIT_FAILURE;
+    }
+
+    struct Settings
+    {
+        bool isForced = false, isVerbose = false;
+        assets::cooked::TextureOptions texture;
+        std::vector<int> fontSizes = { 30, 50 };
+    };
+
+    // An artifact, the sources it is cooked from, and how.
+    struct Task
+    {
+        std::string artifact;
+        std::vector<std::string> inputs;
+        std::string settings;
+        std::function<std::vector<uint8_t>()> cook;
+    };
+
+    // One line per artifact: its path, then the hash of its settings and of each of its inputs.
+    struct Record
+    {
+        uint64_t settings = 0;
+        std::vector<std::pair<std::string, uint64_t>> inputs;
+
+        bool operator==(const Record &other) const { return settings == other.settings && inputs == other.inputs; }
+    };
+
+    using Manifest = std::map<std::string, Record>;
+
+    // NOTE(cme): another version of the cooked formats cooks everything again.
+    std::string manifestVersion() { return fmt("ray-cook %d", assets::cooked::VERSION); }
+
+    Manifest readManifest(const std::string &filename)
+    {
+        Manifest result;
+        std::ifstream in(filename);
+        std::string line;
+        if (!std::getline(in, line) || line != manifestVersion())
+            return result;
+
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string artifact, input;
+            Record record;
+            if (!std::getline(fields, artifact, '\t') || !(fields >> std::hex >> record.settings))
+                continue;
+            uint64_t hash;
+            while (fields.ignore(1, '\t') && std::getline(fields, input, '\t') && fields >> std::hex >> hash)
+                record.inputs.emplace_back(input, hash);
+            result[artifact] = record;
+        }
+        return result;
+    }
+
+    bool writeManifest(const std::string &filename, const Manifest &manifest)
+    {
+        std::ofstream out(filename, std::ios::trunc);
+        out << manifestVersion() << "\n";
+        for (auto &entry : manifest)
+        {
+            out << entry.first << "\t" << std::hex << entry.second.settings;
+            for (auto &input : entry.second.inputs)
+                out << "\t" << input.first << "\t" << input.second;
+            out << std::dec << "\n";
+        }
+        return (bool)out;
+    }
+
+    bool hasExtension(const std::string &path, std::initializer_list<const char *> extensions)
+    {
+        auto extension = fs::extension(path);
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
+        return std::any_of(extensions.begin(), extensions.end(), [&](const char *candidate) { return extension == candidate; });
+    }
+
+    // The material libraries an object reads, relative to the source directory.
+    std::vector<std::string> materialLibraries(const std::string &directory, const std::string &path)
+    {
+        std::vector<std::string> result;
+        std::ifstream in(fs::join(directory, path));
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.compare(0, 7, "mtllib ") != 0)
+                continue;
+            auto slash = path.rfind('/');
+            auto prefix = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+            std::istringstream names(line.substr(7));
+            std::string name;
+            while (names >> name)
+                result.push_back(prefix + name);
+        }
+        return result;
+    }
+
+    std::vector<Task> planTasks(const std::string &directory, const Settings &settings)
+    {
+        std::vector<Task> result;
+        for (auto &path : fs::listFiles(directory))
+        {
+            auto filename = fs::join(directory, path);
+            if (hasExtension(path, { ".png", ".jpg", ".jpeg", ".bmp", ".tga" }))
+            {
+                auto options = settings.texture;
+                result.push_back(Task{ assets::cooked::texturePath(path), { path }, fmt("texture mips=%d compress=%d", options.mipmaps, options.compress), [=]() {
+                    auto file = fs::load(filename, fs::Access::Sequential);
+                    panicif(!file.isValid(), "could not load texture: %s", file.error());
+                    return assets::cooked::cookTexture(assets::Bitmap(file.data(), file.size()), options);
+                }});
+            }
+            else if (hasExtension(path, { ".obj" }))
+            {
+                auto inputs = materialLibraries(directory, path);
+                inputs.insert(inputs.begin(), path);
+                result.push_back(Task{ assets::cooked::meshPath(path), inputs, "mesh", [=]() {
+                    return assets::cooked::cookMesh(assets::Wavefront(filename));
+                }});
+            }
+            else if (hasExtension(path, { ".ttf" }))
+            {
+                for (auto size : settings.fontSizes)
+                {
+                    result.push_back(Task{ assets::cooked::fontPath(path, size), { path }, fmt("font size=%d codepoints=32-126", size), [=]() {
+                        // NOTE(cme): from the bytes, so that an earlier cook isn't picked up instead.
+                        return assets::cooked::cookFont(assets::Font(fs::load(filename, fs::Access::Random), size));
+                    }});
+                }
+            }
+        }
+        return result;
+    }
+
+    Record recordOf(const std::string &directory, const Task &task)
+    {
+        Record result;
+        result.settings = fnv1a64(task.settings.data(), task.settings.size());
+        for (auto &input : task.inputs)
+        {
+            auto data = fs::mapFile(fs::join(directory, input), fs::Access::Sequential);
+            result.inputs.emplace_back(input, data.isValid() ? fs::pack::hashContent(data.data(), data.size()) : 0);
+        }
+        return result;
+    }
+
+    bool write(const std::string &filename, const std::vector<uint8_t> &bytes)
+    {
+        fs::createDirectories(fs::parent(filename));
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(bytes.data()), (std::streamsize)bytes.size());
+        return (bool)out;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Settings settings;
+    std::string source, output;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--force") == 0)
+            settings.isForced = true;
+        else if (std::strcmp(argv[i], "--verbose") == 0)
+            settings.isVerbose = true;
+        else if (std::strcmp(argv[i], "--no-mips") == 0)
+            settings.texture.mipmaps = false;
+        else if (std::strcmp(argv[i], "--compress") == 0)
+            settings.texture.compress = true;
+        else if (std::strcmp(argv[i], "--font-sizes") == 0 && i + 1 < argc)
+        {
+            settings.fontSizes.clear();
+            std::istringstream sizes(argv[++i]);
+            std::string size;
+            while (std::getline(sizes, size, ','))
+                settings.fontSizes.push_back(std::atoi(size.c_str()));
+            if (std::any_of(settings.fontSizes.begin(), settings.fontSizes.end(), [](int size) { return size <= 0; }))
+                return usage();
+        }
+        else if (source.empty())
+            source = argv[i];
+        else if (output.empty())
+            output = argv[i];
+        else
+            return usage();
+    }
+    if (source.empty() || output.empty())
+        return usage();
+
+    auto stopwatch = Stopwatch();
+    fs::createDirectories(output);
+    auto manifestFilename = fs::join(output, MANIFEST);
+    // NOTE(cme): read even when forced, it lists the artifacts to remove.
+    auto previous = readManifest(manifestFilename);
+    auto tasks = planTasks(source, settings);
+
+    enum Outcome { UP_TO_DATE, COOKED, FAILED };
+    std::vector<Outcome> outcomes(tasks.size(), FAILED);
+    std::vector<Record> records(tasks.size());
+    std::vector<size_t> sizes(tasks.size(), 0);
+
+    JobSystem jobs;
+    jobs.parallelFor(0, tasks.size(), 1, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i)
+        {
+            auto &task = tasks[i];
+            auto artifact = fs::join(output, task.artifact);
+            records[i] = recordOf(source, task);
+            auto hit = previous.find(task.artifact);
+            if (!settings.isForced && hit != previous.end() && hit->second == records[i] && fs::exists(artifact))
+            {
+                outcomes[i] = UP_TO_DATE;
+                continue;
+            }
+
+            auto bytes = task.cook();
+            sizes[i] = bytes.size();
+            outcomes[i] = write(artifact, bytes) ? COOKED : FAILED;
+        }
+    });
+
+    Manifest manifest;
+    size_t counts[3] = {};
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        ++counts[outcomes[i]];
+        if (outcomes[i] == FAILED)
+            fprintln(std::cerr, "could not write '%s'", fs::join(output, tasks[i].artifact));
+        else
+            manifest[tasks[i].artifact] = records[i];
+        if (settings.isVerbose && outcomes[i] == COOKED)
+            fprintln("  %s (%d bytes)", tasks[i].artifact, sizes[i]);
+        previous.erase(tasks[i].artifact);
+    }
+
+    // NOTE(cme): whatever is left was cooked from a source that is gone.
+    for (auto &stale : previous)
+    {
+        std::remove(fs::join(output, stale.first).c_str());
+        if (settings.isVerbose)
+            fprintln("  removed %s", stale.first);
+    }
+
+    if (!writeManifest(manifestFilename, manifest))
+    {
+        fprintln(std::cerr, "could not write '%s'", manifestFilename);
+        return EXIT_FAILURE;
+    }
+
+    fprintln("%s: %d cooked, %d up to date, %d failed in %.3fmsec on %d threads", output, counts[COOKED], counts[UP_TO_DATE], counts[FAILED],
+        1000*stopwatch.lap().count(), jobs.workerCount() + 1);
+    return counts[FAILED] ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+#include <ray/platform/FileSystem.hpp>
+#include <ray/platform/Pack.hpp>
+#include <ray/platform/Print.hpp>
+#include <ray/platform/Stopwatch.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ray::platform;
+
+namespace
+{
+    int usage()
+    {
+        fprintln(std::cerr, "usage: ray-pack [--store] [--verbose] <output.pack> <directory>...");
+        fprintln(std::cerr, "  packs every file under each <directory>, by its path relative to it,");
+        fprintln(std::cerr, "  a file of a later directory replacing one at the same path in an earlier one");
+        fprintln(std::cerr, "  --store    doesn't compress the entries");
+        fprintln(std::cerr, "  --verbose  prints every entry");
+        return EXIT_FAILURE;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    auto compression = fs::Compression::Lz4;
+    auto isVerbose = false;
+    std::string output;
+    std::vector<std::string> directories;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--store") == 0)
+            compression = fs::Compression::None;
+        else if (std::strcmp(argv[i], "--verbose") == 0)
+            isVerbose = true;
+        else if (output.empty())
+            output = argv[i];
+        else
+            directories.push_back(argv[i]);
+    }
+    if (output.empty() || directories.empty())
+        return usage();
+
+    auto stopwatch = Stopwatch();
+    auto writer = fs::PackWriter();
+    for (auto &directory : directories)
+    {
+        for (auto &path : fs::listFiles(directory))
+        {
+            if (!writer.addFile(path, fs::join(directory, path), compression))
+            {
+                fprintln(std::cerr, "could not read '%s'", fs::join(directory, path));
+                return EXIT_FAILURE;
+            }
+            if (isVerbose)
+                fprintln("  %s", path);
+        }
+    }
+
+    std::string error;
+    if (!writer.write(output, &error))
+    {
+        fprintln(std::cerr, "%s", error);
+        return EXIT_FAILURE;
+    }
+
+    fprintln("%s: %d files, %d bytes stored in %d bytes (%.1f%%) in %.3fmsec", output, writer.entryCount(), writer.size(), writer.storedSize(),
+        writer.size() ? 100.0 * writer.storedSize() / writer.size() : 100.0, 1000*stopwatch.lap().count());
+    return EXIT_SUCCESS;
+}